@@ -0,0 +1,205 @@
+/******************************************************************************
+Autopilot.cpp
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+#include "Autopilot.h"
+#include "Arduino/Arduino.h"
+#include "Profiler.h"
+
+// ================================ Public Methods ================================
+
+Autopilot::Autopilot() {
+    _nodes = 0;
+    _decisions = 0;
+    _planMicros = 0;
+    _birdShape = NULL;
+}
+
+void Autopilot::setPixelCollision(const CollisionMask *birdShape) {
+    _birdShape = birdShape;
+}
+
+bool Autopilot::decide(const GameSnapshot &game) {
+    FLAPPY_PROFILE_SCOPE(PROFILE_PLAN);
+    FLAPPY_PROFILE_PAUSE(); // The steps played below aren't the game's. The pause ends before the plan is timed
+    unsigned long start = micros();
+    _decisions++;
+
+    // The beam starts with just the game as it is now
+    Node *beam = _beams[0];
+    int count = 1;
+    beam[0].game = game;
+    beam[0].score = 0;
+    beam[0].firstButton = false;
+
+    bool button = false;
+    for (int depth = 0; depth < MAX_DEPTH; depth++) {
+        Node *next = _beams[(depth + 1) & 1];
+        int nextCount = 0;
+        bool isStepped = false;
+        for (int i = 0; i < count; i++) {
+            if (beam[i].game.roundTime - game.roundTime >= HORIZON) {
+                _keep(next, nextCount, beam[i]); // Far enough ahead already
+                continue;
+            }
+            isStepped = true;
+            for (int press = 0; press < 2; press++) {
+                Node child;
+                child.game = beam[i].game;
+                _nodes++;
+                if (!step(child.game, press == 1, _birdShape)) {
+                    continue; // Crashed, so it goes no further
+                }
+                child.firstButton = (depth == 0) ? (press == 1) : beam[i].firstButton;
+                child.score = _score(child.game);
+                _keep(next, nextCount, child);
+            }
+        }
+        if (nextCount == 0) {
+            break; // Everything crashes from here. The beam before lasted the longest
+        }
+        beam = next;
+        count = nextCount;
+        button = beam[0].firstButton;
+        if (!isStepped) {
+            break;
+        }
+    }
+
+    _planMicros += micros() - start;
+    return button;
+}
+
+bool Autopilot::step(GameSnapshot &game, bool button, const CollisionMask *birdShape, const GameTuning &tuning) {
+    Bird bird(game.bird, tuning);
+    PillarManager pillarManager(game.pillars, tuning);
+    bool isAlive = step(game, bird, pillarManager, button, birdShape);
+    game.bird = bird.getState();
+    game.pillars = pillarManager.getState();
+    return isAlive;
+}
+
+bool Autopilot::step(GameSnapshot &game, Bird &bird, PillarManager &pillarManager, bool button, const CollisionMask *birdShape) {
+    // The pillars move until the bird is due. On the same ms the bird goes first
+    while (game.nextPillars < game.nextBird) {
+        int wait = (game.nextPillars > 0) ? game.nextPillars : 0;
+        game.nextBird -= wait;
+        game.roundTime += wait;
+        game.nextPillars = pillarManager.getDelay(); // Set before the step, like _movePillars() does
+        pillarManager.timeToMove();
+    }
+
+    // The bird's step, the same as _moveBird() and _getUserInput()
+    int wait = (game.nextBird > 0) ? game.nextBird : 0;
+    game.nextPillars -= wait;
+    game.roundTime += wait;
+    bool isAlive = true;
+    if (game.flapUpTime > 0) {
+        game.flapUpTime--;
+        bird.userInput(true);
+    }
+    // The same crash as FlappyGame::_birdCrashed()
+    bool crashed = birdShape ? _pixelsCrashed(bird, pillarManager.getPillars(), *birdShape) : bird.birdCrashed(pillarManager.getPillars());
+    if (crashed) {
+        isAlive = false;
+    } else {
+        bird.userInput(button);
+        game.nextBird = bird.getDelay();
+        if (!game.previousFlap && button) {
+            game.flapUpTime = 3; // The same boost the game gives
+        }
+        game.previousFlap = button;
+        if (game.flapUpTime > 0) {
+            game.nextBird = 1;
+        }
+        // The pillars due on the same ms run right after the bird, in the same pass of loop()
+        if (game.nextPillars <= 0) {
+            game.nextPillars = pillarManager.getDelay();
+            pillarManager.timeToMove();
+        }
+    }
+    return isAlive;
+}
+
+// ============================ Getter methods =============================
+
+unsigned long Autopilot::getNodes() {
+    return _nodes;
+}
+
+unsigned long Autopilot::getDecisions() {
+    return _decisions;
+}
+
+unsigned long Autopilot::getPlanMicros() {
+    return _planMicros;
+}
+
+const CollisionMask *Autopilot::getBirdShape() {
+    return _birdShape;
+}
+
+// ================== Private Methods ============================
+
+int Autopilot::_score(const GameSnapshot &game) {
+    // The gap the bird is heading for is the first pair it hasn't passed yet. Where it
+    // goes in that gap depends on the one after: the pillars can come faster than the
+    // bird falls, so it waits on the side the next gap is on
+    const int birdX = DefaultGameConfig::BIRD_X;
+    const int half = DefaultGameConfig::BIRD_SPACE / 2;
+    int target = DefaultGameConfig::SCREEN_HEIGHT / 2;
+    for (int i = 0; i < game.pillars.pillarCount; i++) {
+        if (game.pillars.pillarX[i] + DefaultGameConfig::PILLAR_WIDTH >= birdX) {
+            target = game.pillars.pillarHeight[i] + half;
+            if (i + 1 < game.pillars.pillarCount) {
+                int next = game.pillars.pillarHeight[i + 1] + half;
+                int highest = game.pillars.pillarHeight[i] + _MARGIN;
+                int lowest = game.pillars.pillarHeight[i] + DefaultGameConfig::BIRD_SPACE - _MARGIN;
+                target = (next < highest) ? highest : ((next > lowest) ? lowest : next);
+            }
+            break;
+        }
+    }
+    int distance = game.bird.position - target;
+    return (distance < 0) ? distance : -distance;
+}
+
+bool Autopilot::_pixelsCrashed(Bird &bird, const PillarRing &pillars, const CollisionMask &birdShape) {
+    // The crash only looks at the columns the bird is in, so only those are worked out, into
+    // a few words on the stack. A whole occupancy would be 2 KB more for every node
+    uint64_t columns[CollisionMask::MAX_WIDTH][Occupancy::WORDS + 1];
+    int x = DefaultGameConfig::BIRD_X - DefaultGameConfig::BIRD_SIZE; // Where birdCrashed() puts the shape
+    for (int i = 0; i < birdShape.width; i++) {
+        if (x + i >= 0 && x + i < DefaultGameConfig::SCREEN_WIDTH) {
+            Occupancy::column(pillars, x + i, columns[i]);
+        }
+    }
+    return bird.birdCrashed(columns[0], birdShape);
+}
+
+void Autopilot::_keep(Node *beam, int &count, const Node &node) {
+    // One game per height, so the beam is spread over the screen instead of all in one place
+    for (int i = 0; i < count; i++) {
+        if (beam[i].game.bird.position == node.game.bird.position) {
+            return;
+        }
+    }
+    // Where it goes. A tie goes after the ones already there, so the button up is kept first
+    int position = count;
+    while (position > 0 && node.score > beam[position - 1].score) {
+        position--;
+    }
+    if (position >= BEAM_WIDTH) {
+        return;
+    }
+    int last = (count < BEAM_WIDTH) ? count : BEAM_WIDTH - 1;
+    for (int i = last; i > position; i--) {
+        beam[i] = beam[i - 1];
+    }
+    beam[position] = node;
+    if (count < BEAM_WIDTH) {
+        count++;
+    }
+}
@@ -0,0 +1,131 @@
+/******************************************************************************
+Autopilot.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Snapshots * *
+* A whole game in the middle of a round is the bird, the pillars, the flap that is
+* going on, and when the bird and the pillars move next. GameSnapshot packs all of it
+* into one plain struct of a few dozen bytes with no pointers, so copying a game is
+* one memcpy. FlappyGame::snapshot() and restore() take it out of a running game and
+* put it back.
+*
+* step() plays a snapshot forward without a screen or a clock, in exactly the order
+* FlappyGame does in the PIXEL_STEPS mode: the pillars move whenever they are due,
+* and when the bird is due it takes its boost, checks for a crash, then reads the
+* button. When both are due in the same ms the bird goes first, like the scheduler,
+* and step() only returns once the pillars have had their turn too, the same point
+* loop() is at when the bird's step is over. The deterministic mode runs every task
+* right on its deadline, and then step() and the real game come out the same.
+*
+* * The autopilot * *
+* decide() looks ahead with a beam search. Starting from the snapshot, every game in
+* the beam is stepped once with the button up and once with it down, and the ones
+* that crash are dropped. The BEAM_WIDTH best of the rest make the next beam, with at
+* most one game for each height of the bird, so the beam doesn't bunch up in one spot
+* and miss the way down to a low gap. Games that are HORIZON ms ahead already wait for
+* the others. Then the best game left says what the first press should be. If every
+* game crashes before that, the one that lasted the longest does.
+*
+* The best game is the one closest to where the bird should be: in the gap of the
+* first pair it hasn't passed yet, as close to the next gap as it can be. The pillars
+* get faster than the bird falls, so waiting at the top of a gap when the next one is
+* at the bottom can't be made up for later.
+*
+* step() crashes the way the game does: with the hitbox, or with the pixel collision
+* when it is given the bird's shape. The game keeps the occupancy of the whole screen
+* as the pillars move, but a node starts from a snapshot, so step() only works out
+* the few columns the bird is in, right when it checks.
+*
+* Every step() is one node. getNodes() and getPlanMicros() give nodes per second.
+* The pillars that aren't on screen yet come from the pillars' own generator, which
+* is in the snapshot, so the planner sees the same ones the game will. With
+* FLAPPY_PROFILE on decide() is timed as the plan stage. The hundreds of steps it
+* plays are left out of the bird, pillar and crash stages, which are the game's own.
+******************************/
+
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include <stddef.h>
+#include <type_traits>
+#include "bird.h"
+#include "PillarManager.h"
+
+// A whole round of the game, frozen. See the notes above
+struct GameSnapshot {
+    Bird::State bird;
+    PillarManager::State pillars;
+    uint32_t roundTime; // ms since the round started
+    int16_t nextBird; // ms until the bird's next step. In the physics mode, until the next frame
+    int16_t nextPillars; // ms until the pillars' next step. The physics mode doesn't use it
+    int16_t sinceLastFrame; // The physics mode only. ms since the last frame
+    int8_t flapUpTime; // Boost steps left of the flap that just started
+    bool previousFlap; // The button at the bird's last step
+};
+
+static_assert(std::is_trivially_copyable<GameSnapshot>::value, "A snapshot has to be copyable with memcpy");
+
+class Autopilot {
+
+    public:
+
+        static const int BEAM_WIDTH = 8; // Games kept after each step
+        static const uint32_t HORIZON = 400; // ms looked ahead
+        static const int MAX_DEPTH = 64; // Bird steps looked ahead at most, for when it flaps a lot
+
+        Autopilot();
+
+        // The button for the bird's next step
+        bool decide(const GameSnapshot &game);
+
+        // The crash decide() plans with has to be the game's. With a bird shape it is the pixel
+        // collision (see Occupancy.h), with NULL (the default) the hitbox.
+        // FlappyGame::setPixelCollision() sets it
+        void setPixelCollision(const CollisionMask *birdShape);
+
+        // Plays the game up to and including the bird's next step, with the button as given
+        // at that step. Returns false if the bird crashed. The crash is the hitbox unless it
+        // is given the bird's shape for the pixel collision. It plays by the game's own
+        // tuning unless it is given another, like `flappyhost sweep` does (see host/Sweep.h)
+        static bool step(GameSnapshot &game, bool button, const CollisionMask *birdShape = NULL,
+                         const GameTuning &tuning = DefaultTuning<DefaultGameConfig>::TUNING);
+        // The same on a bird and pillars that are kept from one step to the next, instead of
+        // restored from the snapshot every time. Only the snapshot's timing is used then, and
+        // its bird and pillars are left as they were
+        static bool step(GameSnapshot &game, Bird &bird, PillarManager &pillarManager, bool button,
+                         const CollisionMask *birdShape = NULL);
+
+        // Getter methods
+        unsigned long getNodes(); // step()s done by decide()
+        unsigned long getDecisions();
+        unsigned long getPlanMicros(); // micros() spent in decide()
+        const CollisionMask *getBirdShape(); // NULL for the hitbox
+
+    private:
+
+        static const int _MARGIN = 6; // px the bird stays inside a gap while it waits for the next one
+
+        // One game in the beam
+        struct Node {
+            GameSnapshot game;
+            int score; // Higher is better
+            bool firstButton; // What the button was at the first step, which is what decide() returns
+        };
+
+        Node _beams[2][BEAM_WIDTH]; // The one being stepped and the next one
+        unsigned long _nodes;
+        unsigned long _decisions;
+        unsigned long _planMicros;
+        const CollisionMask *_birdShape;
+
+        static int _score(const GameSnapshot &game);
+        // The pixel collision, with the occupancy worked out for the bird's columns only
+        static bool _pixelsCrashed(Bird &bird, const PillarRing &pillars, const CollisionMask &birdShape);
+        // Puts the node in the beam if it is among the best, keeping it sorted best first
+        static void _keep(Node *beam, int &count, const Node &node);
+};
+
+#endif
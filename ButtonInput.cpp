@@ -0,0 +1,132 @@
+/******************************************************************************
+ButtonInput.cpp
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+#include "ButtonInput.h"
+#include "Arduino/Arduino.h"
+
+ButtonInput *ButtonInput::_instance = NULL;
+
+// ================================ Public Methods ================================
+
+ButtonInput::ButtonInput() {
+    _pin = -1;
+    _isStarted = false;
+    _hasInterrupt = false;
+    _scheduler = NULL;
+    _edgeLevel = false;
+    _lastEdgeTime = 0;
+    _bounces = 0;
+    _dropped = 0;
+    _pressed = false;
+    _pressWaiting = false;
+    _lastPressTime = 0;
+    _edges = 0;
+}
+
+void ButtonInput::begin(int pin, bool useInterrupt, Scheduler *scheduler) {
+    _pin = pin;
+    _scheduler = scheduler;
+    pinMode(_pin, INPUT);
+    // Whatever the button is at the start is not an edge
+    _edgeLevel = digitalRead(_pin);
+    _pressed = _edgeLevel;
+    _lastEdgeTime = millis();
+    _isStarted = true;
+    _hasInterrupt = useInterrupt;
+    if (useInterrupt) {
+        _instance = this;
+        attachInterrupt(_pin, _interrupt, CHANGE);
+    }
+}
+
+void ButtonInput::onChange(unsigned long now) {
+    bool level = digitalRead(_pin);
+    if (level == _edgeLevel) {
+        return; // It bounced back to where it was, or this change was already taken
+    }
+    if ((long)(now - _lastEdgeTime) < (long)DEBOUNCE_TIME) {
+        _bounces++;
+        return;
+    }
+    _takeEdge(level, now);
+}
+
+bool ButtonInput::poll(unsigned long now) {
+    if (!_isStarted) {
+        return false;
+    }
+
+    // Catch the edge the debouncing may have ignored. The interrupt is off for this, so
+    // there is still only ever one writer to the queue
+    noInterrupts();
+    bool level = digitalRead(_pin);
+    // Signed, so a now from before the last edge counts as too soon instead of wrapping round
+    if (level != _edgeLevel && (long)(now - _lastEdgeTime) >= (long)DEBOUNCE_TIME) {
+        _takeEdge(level, now);
+    }
+    interrupts();
+
+    bool newPress = false;
+    ButtonEvent event;
+    while (_events.pop(event)) {
+        _edges++;
+        _pressed = event.pressed;
+        if (event.pressed) {
+            _pressWaiting = true;
+            _lastPressTime = event.time;
+            newPress = true;
+        }
+    }
+    return newPress;
+}
+
+bool ButtonInput::isPressed() {
+    return _pressed;
+}
+
+bool ButtonInput::takePress() {
+    bool press = _pressWaiting;
+    _pressWaiting = false;
+    return press;
+}
+
+// ============================ Getter methods =============================
+
+unsigned long ButtonInput::getLastPressTime() {
+    return _lastPressTime;
+}
+
+unsigned long ButtonInput::getEdges() {
+    return _edges;
+}
+
+unsigned long ButtonInput::getBounces() {
+    return _bounces;
+}
+
+unsigned long ButtonInput::getDropped() {
+    return _dropped;
+}
+
+// ================== Private Methods ============================
+
+void ButtonInput::_interrupt() {
+    if (_instance != NULL) {
+        _instance->onChange(millis());
+    }
+}
+
+void ButtonInput::_takeEdge(bool level, unsigned long now) {
+    _edgeLevel = level;
+    _lastEdgeTime = now;
+    ButtonEvent event = { now, level };
+    if (!_events.push(event)) {
+        _dropped++;
+    }
+    if (_hasInterrupt && _scheduler != NULL) {
+        _scheduler->wake(); // So loop() doesn't sleep through it
+    }
+}
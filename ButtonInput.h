@@ -0,0 +1,93 @@
+/******************************************************************************
+ButtonInput.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * The button, from an interrupt * *
+* The game used to read the button only when the bird was due to move, which can be
+* 50 ms apart. A press between two reads waited for the next one, and a quick tap
+* that was over before it could be missed altogether.
+*
+* Now the pin has an interrupt on every change. The interrupt debounces and then puts
+* the edge, with the time it came, into an SpscQueue, and wakes the scheduler up.
+* loop() takes the edges out with poll() and can make the bird flap right away.
+*
+* * Debouncing * *
+* A button doesn't go from up to down cleanly, it bounces between the two for a few
+* ms. The first change is taken straight away, so there is no delay, and then every
+* change for DEBOUNCE_TIME ms after it is ignored. If the bounces end with the pin
+* different from the last edge that was taken (a very short tap), poll() notices
+* once the debounce time is over and adds the edge then.
+*
+* Without begin()'s interrupt, poll() still works by reading the pin each time it is
+* called, with the same debouncing.
+******************************/
+
+#ifndef BUTTONINPUT_H
+#define BUTTONINPUT_H
+
+#include "SpscQueue.h"
+#include "Scheduler.h"
+
+// One change of the button, after debouncing
+struct ButtonEvent {
+    unsigned long time; // millis() when it happened
+    bool pressed;
+};
+
+class ButtonInput {
+
+    public:
+
+        static const unsigned long DEBOUNCE_TIME = 5; // ms after an edge in which the pin is not trusted
+        static const int QUEUE_SIZE = 16; // Edges that can wait for loop(), one less than this
+
+        ButtonInput();
+
+        // Sets up the pin. With an interrupt, the scheduler (if there is one) is woken on every edge
+        void begin(int pin, bool useInterrupt, Scheduler *scheduler);
+
+        // The interrupt. Public so the host can feed it made up bounces
+        void onChange(unsigned long now);
+
+        // Takes in the edges since the last call. Returns true if there was a new press. now is
+        // millis(), the clock the interrupt stamps the edges with
+        bool poll(unsigned long now);
+        bool isPressed(); // Down right now, after debouncing
+        bool takePress(); // True once for each press, even one that is already over
+
+        // Getter methods
+        unsigned long getLastPressTime(); // When the last press came in, from the interrupt
+        unsigned long getEdges();
+        unsigned long getBounces(); // Changes ignored by the debouncing
+        unsigned long getDropped(); // Edges lost because loop() didn't take them out in time
+
+    private:
+
+        static ButtonInput *_instance; // The one the interrupt goes to
+        static void _interrupt();
+
+        int _pin;
+        bool _isStarted;
+        bool _hasInterrupt;
+        Scheduler *_scheduler;
+        SpscQueue<ButtonEvent, QUEUE_SIZE> _events;
+
+        // The interrupt's side. Only poll() touches them otherwise, with interrupts off
+        volatile bool _edgeLevel; // The last edge that was taken
+        volatile unsigned long _lastEdgeTime;
+        volatile unsigned long _bounces;
+        volatile unsigned long _dropped;
+
+        // loop()'s side
+        bool _pressed;
+        bool _pressWaiting;
+        unsigned long _lastPressTime;
+        unsigned long _edges;
+
+        void _takeEdge(bool level, unsigned long now);
+};
+
+#endif
@@ -0,0 +1,93 @@
+/******************************************************************************
+Collision.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Finding out if the bird hit a pillar * *
+* The bird never moves left or right, it always sits in the middle of the screen.
+* So most pillars can't be hit just because they are not in the same columns, and
+* there is no point looking at how high their gap is.
+*
+* The pillars are always in order from left to right (new ones come in on the right
+* and the old ones leave on the left), so a binary search finds the first pillar
+* that reaches the bird's columns. From there only the pillars that start before the
+* bird ends are checked. That is called a broadphase.
+*
+* The check itself has no ifs in it. The comparisons are turned into 0s and 1s and
+* combined with & and |, so the Photon doesn't have to guess which way a branch goes.
+*
+* It is all in the header because it works with any ring of pillars, whatever GameConfig
+* they were made for. The game uses PillarRing, and the host benchmark uses much bigger ones.
+******************************/
+
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include "pillar.h"
+
+// The part of the bird that can crash into things. Edges are screen coordinates and
+// they count as part of the box, so a box touching a pillar hits it
+struct Hitbox {
+    int left;
+    int right;
+    int top;
+    int bottom;
+};
+
+class Collision {
+
+    public:
+
+        // How many pixels are taken off the top and the bottom of the bird before it is
+        // compared with the gap. The bigger it is, the further the bird can go into a pillar.
+        // The game always used 4, because of the slow refreshing rate it "proved to be more accurate"
+        static const int DEFAULT_HITBOX_INSET = 4;
+
+        static Hitbox birdHitbox(int birdX, int birdY, int birdSize, int hitboxInset) {
+            Hitbox box = {
+                birdX - birdSize,
+                birdX + birdSize,
+                birdY - birdSize + hitboxInset,
+                birdY + birdSize - hitboxInset
+            };
+            return box;
+        }
+
+        // 1 if the box is in the same columns as the pillar and not inside its gap, 0 if not
+        template <class PillarType>
+        static int hitsPillar(const Hitbox &box, const PillarType &pillar) {
+            int outsideGap = (box.bottom <= pillar.getGapTop()) | (box.top >= pillar.getGapBottom());
+            int sameColumns = (box.left <= pillar.getXEnd()) & (box.right >= pillar.getX());
+            return outsideGap & sameColumns;
+        }
+
+        // The index of the first pillar whose right edge reaches x, or the amount of pillars if none does
+        template <class Pillars>
+        static int firstPillarReaching(const Pillars &pillars, int x) {
+            int low = 0;
+            int high = pillars.size();
+            while (low < high) {
+                int middle = (low + high) / 2;
+                if (pillars[middle].getXEnd() < x) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            return low;
+        }
+
+        // Pillars have to be in order from left to right, like they are in a PillarRing
+        template <class Pillars>
+        static bool hitsAnyPillar(const Pillars &pillars, const Hitbox &box) {
+            int hit = 0;
+            for (int i = firstPillarReaching(pillars, box.left); i < pillars.size() && pillars[i].getX() <= box.right; i++) {
+                hit |= hitsPillar(box, pillars[i]);
+            }
+            return hit != 0;
+        }
+};
+
+#endif
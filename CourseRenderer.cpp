@@ -0,0 +1,209 @@
+/******************************************************************************
+CourseRenderer.cpp
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+#include "CourseRenderer.h"
+#include <string.h>
+#include "Profiler.h"
+
+// ================================ Public Methods ================================
+
+template <class Config>
+BasicCourseRenderer<Config>::BasicCourseRenderer(Raster &raster) :
+    _raster(raster) {
+    _isDrawn = false;
+    _steps = 0;
+    _hadPillars = false;
+    _frontX = 0;
+    _frontGapTop = 0;
+    _columnsDrawn = 0;
+    _wholeDraws = 0;
+    _forgetOverlays();
+}
+
+template <class Config>
+void BasicCourseRenderer<Config>::clear() {
+    _raster.clear();
+    redrawAll();
+}
+
+template <class Config>
+void BasicCourseRenderer<Config>::redrawAll() {
+    _isDrawn = false;
+}
+
+template <class Config>
+void BasicCourseRenderer<Config>::draw(const PillarRing &pillars, uint32_t steps) {
+    FLAPPY_PROFILE_SCOPE(PROFILE_DRAW_PILLARS);
+    uint32_t moved = steps - _steps;
+    if (!_isDrawn || steps < _steps || moved >= (uint32_t)_WIDTH) {
+        // Nothing on screen to keep, or all of it scrolled off
+        _drawColumns(pillars, 0, _WIDTH, 0, _PAGES);
+        _wholeDraws++;
+        _isDrawn = true;
+        _remember(pillars, steps);
+        _forgetOverlays();
+        return;
+    }
+    int shift = (int)moved;
+
+    // 1. Everything moves left, and the columns that came in on the right are drawn
+    if (shift > 0) {
+        uint8_t *buffer = _raster.getBuffer();
+        for (int page = 0; page < _PAGES; page++) {
+            memmove(buffer + page * _WIDTH, buffer + page * _WIDTH + shift, _WIDTH - shift);
+        }
+        _drawColumns(pillars, _WIDTH - shift, _WIDTH, 0, _PAGES);
+    }
+
+    // 2. What was drawn on top moved along with the rest, so it is shift columns further left now
+    // A sprite covers the same columns on the pages it lands on, so those go together
+    for (int page = 0; page < _PAGES; ) {
+        int endPage = page + 1;
+        while (endPage < _PAGES && _overFrom[endPage] == _overFrom[page] && _overTo[endPage] == _overTo[page]) {
+            endPage++;
+        }
+        int from = _overFrom[page] - shift;
+        int to = _overTo[page] - shift;
+        from = (from < 0) ? 0 : from;
+        to = (to > _WIDTH - shift) ? _WIDTH - shift : to;
+        if (from < to) {
+            _drawColumns(pillars, from, to, page, endPage);
+        }
+        page = endPage;
+    }
+
+    // 3. The first pillar went away, but it is still on screen somewhere in the first columns
+    bool isFrontGone = _hadPillars
+                    && (pillars.isEmpty() || pillars.front().getX() + shift != _frontX || pillars.front().getGapTop() != _frontGapTop);
+    if (isFrontGone) {
+        int to = (Config::PILLAR_WIDTH < _WIDTH - shift) ? Config::PILLAR_WIDTH : _WIDTH - shift;
+        _drawColumns(pillars, 0, to, 0, _PAGES);
+    }
+
+    _remember(pillars, steps);
+    _forgetOverlays();
+}
+
+template <class Config>
+void BasicCourseRenderer<Config>::blit(const Sprite &sprite, int x, int y, bool opaque) {
+    _raster.blit(sprite, x, y, opaque);
+
+    // The pages and columns it covered, cut down to the screen
+    int left = (x < 0) ? 0 : x;
+    int right = (x + sprite.width > _WIDTH) ? _WIDTH : x + sprite.width;
+    int top = (y < 0) ? 0 : y;
+    int bottom = (y + sprite.height > _HEIGHT) ? _HEIGHT : y + sprite.height;
+    if (left >= right || top >= bottom) {
+        return;
+    }
+    for (int page = top / 8; page * 8 < bottom; page++) {
+        if (left < _overFrom[page]) {
+            _overFrom[page] = (int16_t)left;
+        }
+        if (right > _overTo[page]) {
+            _overTo[page] = (int16_t)right;
+        }
+    }
+}
+
+// ============================ Getter methods =============================
+
+template <class Config>
+unsigned long BasicCourseRenderer<Config>::getColumnsDrawn() {
+    return _columnsDrawn;
+}
+
+template <class Config>
+unsigned long BasicCourseRenderer<Config>::getWholeDraws() {
+    return _wholeDraws;
+}
+
+// ================== Private Methods ============================
+
+template <class Config>
+void BasicCourseRenderer<Config>::_drawColumns(const PillarRing &pillars, int from, int to, int firstPage, int endPage) {
+    // The first pillar that reaches column from. They are in order, so this is a binary search
+    int first = 0;
+    int last = pillars.size();
+    while (first < last) {
+        int middle = (first + last) / 2;
+        if (pillars[middle].getXEnd() <= from) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+
+    // Copied out of the ring once, since every column looks at them for every page
+    int lefts[Config::MAX_PILLARS];
+    int rights[Config::MAX_PILLARS]; // Not included
+    int gapTops[Config::MAX_PILLARS];
+    int gapBottoms[Config::MAX_PILLARS];
+    int count = 0;
+    for (int i = first; i < pillars.size() && pillars[i].getX() < to; i++) {
+        lefts[count] = pillars[i].getX();
+        rights[count] = pillars[i].getXEnd();
+        gapTops[count] = pillars[i].getGapTop();
+        gapBottoms[count] = pillars[i].getGapBottom();
+        count++;
+    }
+
+    uint8_t *buffer = _raster.getBuffer();
+    int next = 0;
+    for (int x = from; x < to; x++) {
+        while (next < count && rights[next] <= x) {
+            next++; // This one ended before this column
+        }
+        for (int page = firstPage; page < endPage; page++) {
+            uint8_t bits = 0;
+            for (int i = next; i < count && lefts[i] <= x; i++) {
+                if (x == lefts[i] || x == rights[i] - 1) {
+                    // A side: down to the gap, and from the gap to the bottom
+                    bits |= _rows(0, gapTops[i], page) | _rows(gapBottoms[i], _HEIGHT, page);
+                } else {
+                    // Inside: the top and bottom rows of both outlines
+                    bits |= _rows(0, 1, page) | _rows(gapTops[i] - 1, gapTops[i], page)
+                          | _rows(gapBottoms[i], gapBottoms[i] + 1, page) | _rows(_HEIGHT - 1, _HEIGHT, page);
+                }
+            }
+            buffer[page * _WIDTH + x] = bits;
+        }
+    }
+    _columnsDrawn += to - from;
+}
+
+template <class Config>
+uint8_t BasicCourseRenderer<Config>::_rows(int from, int to, int page) {
+    int first = from - page * 8;
+    int last = to - page * 8; // Not included
+    first = (first < 0) ? 0 : first;
+    last = (last > 8) ? 8 : last;
+    if (first >= last) {
+        return 0;
+    }
+    return (uint8_t)((0xFF << first) & (0xFF >> (8 - last)));
+}
+
+template <class Config>
+void BasicCourseRenderer<Config>::_remember(const PillarRing &pillars, uint32_t steps) {
+    _steps = steps;
+    _hadPillars = !pillars.isEmpty();
+    _frontX = _hadPillars ? pillars.front().getX() : 0;
+    _frontGapTop = _hadPillars ? pillars.front().getGapTop() : 0;
+}
+
+template <class Config>
+void BasicCourseRenderer<Config>::_forgetOverlays() {
+    for (int page = 0; page < _PAGES; page++) {
+        _overFrom[page] = _WIDTH;
+        _overTo[page] = 0;
+    }
+}
+
+// The configs the game can be built for. See GameConfig.h
+template class BasicCourseRenderer<MicroOledConfig>;
+template class BasicCourseRenderer<LargePanelConfig>;
+template class BasicCourseRenderer<WidePanelConfig>;
@@ -0,0 +1,102 @@
+/******************************************************************************
+CourseRenderer.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Scrolling instead of drawing it all again * *
+* Every 1 px step of the pillars used to wipe the screen and draw every pillar's two
+* rects again, even though all that changed was that everything moved one column to
+* the left. On 64x48 with 3 pillars that is cheap. On a 320x240 panel with a dozen
+* pairs it is most of the frame, and it gets worse with every pillar added.
+*
+* The course renderer keeps the pillars that are already on screen and moves them:
+*   1. Each page of the buffer is moved left by the steps since the last draw(). In
+*      the page major layout a column is one byte, so that is one memmove per page.
+*   2. Only the columns that came in on the right are drawn, from the pillars that
+*      cover them. A column is worked out from a short list of rows: a side of a
+*      pillar is lit from the top down to the gap and from the gap to the bottom,
+*      the inside is just the 4 rows the outlines cross.
+*   3. Whatever was drawn on top since (the bird, the HUD) is drawn over with the
+*      course again, but only in the pages and columns it covered.
+*   4. When the first pillar went away, the columns it was last drawn in get drawn
+*      again. It can only have been in the first PILLAR_WIDTH of them.
+* So a draw costs the columns that changed, not the number of pillars or the size of
+* the screen. Finding the pillars of a column is a binary search, since the ring has
+* them from left to right.
+*
+* The pixels are exactly the ones Raster::rect() draws for the same pillars, which
+* `flappyhost course-bench` checks on every step of every panel size.
+*
+* Anything drawn into the buffer by other means (text, Raster itself) isn't known to
+* the renderer. Call clear() after it, or redrawAll() if the screen is still fine
+* but the pillars have changed, like after PillarManager::reset().
+******************************/
+
+#ifndef COURSERENDERER_H
+#define COURSERENDERER_H
+
+#include <stdint.h>
+#include "pillar.h"
+#include "Raster.h"
+
+template <class Config>
+class BasicCourseRenderer {
+
+    public:
+
+        typedef typename BasicPillar<Config>::Ring PillarRing;
+
+        // Draws into the raster's buffer, which has to be the size of the config's screen
+        explicit BasicCourseRenderer(Raster &raster);
+
+        void clear(); // The whole screen. The next draw() draws the whole course
+        void redrawAll(); // Leaves the screen alone, but the next draw() draws the whole course
+
+        // Brings the screen up to the pillars. steps is PillarManager::getSteps(), which
+        // says how far they moved since the last draw()
+        void draw(const PillarRing &pillars, uint32_t steps);
+
+        // Copies a sprite on top of the course, like Raster::blit(). The next draw() puts
+        // the course back where it was
+        void blit(const Sprite &sprite, int x, int y, bool opaque);
+
+        // Getter methods
+        unsigned long getColumnsDrawn(); // Columns of one page or more worked out so far
+        unsigned long getWholeDraws(); // draw() calls that had to draw every column
+
+    private:
+
+        static const int _WIDTH = Config::SCREEN_WIDTH;
+        static const int _HEIGHT = Config::SCREEN_HEIGHT;
+        static const int _PAGES = Config::SCREEN_HEIGHT / 8;
+
+        static_assert(Config::SCREEN_HEIGHT % 8 == 0, "The screen has to be whole pages tall");
+        static_assert(Config::SCREEN_HEIGHT <= Raster::MAX_HEIGHT, "Raster only goes up to MAX_HEIGHT rows");
+
+        Raster &_raster;
+        bool _isDrawn; // false until the whole course has been drawn since clear() or redrawAll()
+        uint32_t _steps; // The steps the screen shows
+        bool _hadPillars;
+        int _frontX; // The first pillar the screen shows, to tell when it goes away
+        int _frontGapTop;
+
+        // The columns of each page something was drawn over the course in, from and to (not included)
+        int16_t _overFrom[_PAGES];
+        int16_t _overTo[_PAGES];
+
+        unsigned long _columnsDrawn;
+        unsigned long _wholeDraws;
+
+        // Works out the columns from and to (not included) for the pages firstPage to endPage (not included)
+        void _drawColumns(const PillarRing &pillars, int from, int to, int firstPage, int endPage);
+        static uint8_t _rows(int from, int to, int page); // The bits of rows from to to (not included) that are in the page
+        void _remember(const PillarRing &pillars, uint32_t steps);
+        void _forgetOverlays();
+};
+
+// The 64x48 one the game uses
+typedef BasicCourseRenderer<DefaultGameConfig> CourseRenderer;
+
+#endif
@@ -0,0 +1,178 @@
+/******************************************************************************
+Difficulty.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * How hard the game gets * *
+* The pillars used to speed up by taking 0.005 ms off a float delay on every step,
+* and a new pair of pillars came when the score passed a number that doubled each
+* time. Both were worked out as the game went, so where a game was depended on
+* every step before it, and a float that had been rounded 3600 times.
+*
+* Now the whole curve is a table, made before the game runs:
+*   - DELAYS says which delay (in whole ms per px, the only part the game ever
+*     waited for) starts at which step. The pillars keep a count of their steps and
+*     move on to the next entry when they reach it, so a step is one comparison.
+*   - LEVEL_UPS says which score brings each extra pair of pillars.
+*
+* LinearDifficulty makes both tables from the numbers in the config while compiling,
+* with the same curve the game always had. Any other struct with the same four
+* members is a difficulty profile too. It is only data, so making the game easier
+* for younger players is writing down a new table, like GentleDifficulty. Build with
+* -DFLAPPY_DIFFICULTY=GentleDifficulty (`make DIFFICULTY=GentleDifficulty` on the
+* host) to play it. The tables go into the replay's config hash, so a game recorded
+* on one profile isn't played back on another.
+******************************/
+
+#ifndef DIFFICULTY_H
+#define DIFFICULTY_H
+
+#include <stdint.h>
+
+// One entry of DELAYS: from this many steps into the round, the pillars wait this long
+struct DelayStep {
+    uint32_t fromStep;
+    uint8_t delay; // ms per px
+};
+
+// ===== Making tables while compiling =====
+// C++11 has no loops in constexpr code, so the table is spelled out as
+// { Make::at(0), Make::at(1), ... } by a list of numbers the compiler makes
+
+template <int... I>
+struct TableIndices {};
+
+template <int N, int... I>
+struct MakeTableIndices : MakeTableIndices<N - 1, N - 1, I...> {};
+
+template <int... I>
+struct MakeTableIndices<0, I...> {
+    typedef TableIndices<I...> Type;
+};
+
+template <class T, class Make, class Indices = typename MakeTableIndices<Make::COUNT>::Type>
+struct ConstexprTable;
+
+template <class T, class Make, int... I>
+struct ConstexprTable<T, Make, TableIndices<I...> > {
+    static constexpr T VALUES[sizeof...(I)] = { Make::at(I)... };
+};
+
+template <class T, class Make, int... I>
+constexpr T ConstexprTable<T, Make, TableIndices<I...> >::VALUES[sizeof...(I)];
+
+// ===== The curve the game always had =====
+// The math is in plain functions of the numbers, so host/Sweep.h can make the same
+// tables while it runs, for numbers that aren't in any config. Times are in ns
+// (millionths of a ms), so the tables come out of whole numbers
+
+// How many times the delay goes down. It goes down while it is above the minimum, so the last time can take it a bit below
+constexpr int64_t linearSpeedUps(int64_t startNs, int64_t minNs, int64_t rateNs) {
+    return (rateNs > 0 && startNs > minNs) ? (startNs - minNs + rateNs - 1) / rateNs : 0;
+}
+
+// Entry i is the delay slowest - i, where slowest is startNs in whole ms. It starts at the first step that takes the delay below the one before
+constexpr DelayStep linearDelayAt(int64_t startNs, int64_t rateNs, int i) {
+    return DelayStep{(i == 0) ? 0u : (uint32_t)((startNs - (startNs / 1000000 - i + 1) * 1000000) / rateNs + 1), (uint8_t)(startNs / 1000000 - i)};
+}
+
+// The score for the i-th extra pair of pillars, each one factor times the one before
+constexpr int64_t linearLevelUpScore(int64_t start, int64_t factor, int i) {
+    return (i == 0) ? start : linearLevelUpScore(start, factor, i - 1) * factor;
+}
+
+// The delays, worked out from the config
+template <class Config>
+struct LinearDelays {
+    static constexpr int64_t START_NS = (int64_t)(Config::PILLAR_DELAY * 1000000 + 0.5);
+    static constexpr int64_t MIN_NS = (int64_t)(Config::MIN_PILLAR_DELAY * 1000000 + 0.5);
+    static constexpr int64_t RATE_NS = (int64_t)(Config::PILLAR_ACCELERATION_RATE * 1000000 + 0.5);
+    static constexpr int64_t SPEED_UPS = linearSpeedUps(START_NS, MIN_NS, RATE_NS);
+    static constexpr int SLOWEST = (int)(START_NS / 1000000);
+    static constexpr int FASTEST = (int)((START_NS - SPEED_UPS * RATE_NS) / 1000000);
+    static constexpr int COUNT = SLOWEST - FASTEST + 1;
+
+    static_assert(SLOWEST <= 255, "The delays are kept in a byte");
+    static_assert(FASTEST >= 1, "The pillars have to wait at least 1 ms per px");
+
+    static constexpr DelayStep at(int i) {
+        return linearDelayAt(START_NS, RATE_NS, i);
+    }
+};
+
+// The scores for the extra pillars
+template <class Config>
+struct LinearLevelUps {
+    static constexpr int COUNT = 8; // More than any screen has room for
+
+    static constexpr uint16_t at(int i) {
+        return (linearLevelUpScore(Config::PILLARS_PASSED_TO_LEVEL_UP_STARTING_POINT, Config::PILLARS_PASSED_TO_LEVEL_UP_FACTOR, i) > 0xFFFF)
+             ? 0xFFFF : (uint16_t)linearLevelUpScore(Config::PILLARS_PASSED_TO_LEVEL_UP_STARTING_POINT, Config::PILLARS_PASSED_TO_LEVEL_UP_FACTOR, i);
+    }
+};
+
+template <class Config>
+struct LinearDifficulty {
+    // The four members every profile has
+    static constexpr int DELAY_COUNT = LinearDelays<Config>::COUNT;
+    static constexpr int LEVEL_UP_COUNT = LinearLevelUps<Config>::COUNT;
+    static constexpr const DelayStep *DELAYS = ConstexprTable<DelayStep, LinearDelays<Config> >::VALUES;
+    static constexpr const uint16_t *LEVEL_UPS = ConstexprTable<uint16_t, LinearLevelUps<Config> >::VALUES;
+};
+
+template <class Config> constexpr const DelayStep *LinearDifficulty<Config>::DELAYS;
+template <class Config> constexpr const uint16_t *LinearDifficulty<Config>::LEVEL_UPS;
+
+// ===== A profile written down by hand =====
+// Slower at the start (34 ms for the first 150 px), a slower speed up that stops at 16 ms, and the
+// extra pillars come later
+
+template <class Config>
+struct GentleDifficulty {
+    static constexpr int DELAY_COUNT = 10;
+    static constexpr int LEVEL_UP_COUNT = 4;
+    static constexpr DelayStep DELAYS[DELAY_COUNT] = {
+        {0, 34}, {150, 32}, {300, 30}, {700, 28}, {1200, 26}, {1800, 24}, {2500, 22}, {3300, 20}, {4200, 18}, {5200, 16}
+    };
+    static constexpr uint16_t LEVEL_UPS[LEVEL_UP_COUNT] = {10, 30, 80, 200};
+};
+
+template <class Config> constexpr DelayStep GentleDifficulty<Config>::DELAYS[];
+template <class Config> constexpr uint16_t GentleDifficulty<Config>::LEVEL_UPS[];
+
+// ===== Checks =====
+
+// The steps go up, the first one is step 0, and every delay is at least 1 ms
+template <class Profile>
+constexpr bool isDelayTableValid(int i = 0) {
+    return (i >= Profile::DELAY_COUNT) ? true
+         : (Profile::DELAYS[i].delay >= 1
+            && ((i == 0) ? Profile::DELAYS[i].fromStep == 0 : Profile::DELAYS[i].fromStep > Profile::DELAYS[i - 1].fromStep)
+            && isDelayTableValid<Profile>(i + 1));
+}
+
+// A number that changes when anything in the profile does, for the replay's config hash
+template <class Profile>
+uint32_t difficultyHash() {
+    uint32_t hash = 2166136261u; // FNV-1a, like GameConfig::hash()
+    for (int i = 0; i < Profile::DELAY_COUNT; i++) {
+        uint32_t values[] = {Profile::DELAYS[i].fromStep, Profile::DELAYS[i].delay};
+        for (int v = 0; v < 2; v++) {
+            for (int b = 0; b < 4; b++) {
+                hash ^= (uint8_t)(values[v] >> (8 * b));
+                hash *= 16777619u;
+            }
+        }
+    }
+    for (int i = 0; i < Profile::LEVEL_UP_COUNT; i++) {
+        hash ^= (uint8_t)Profile::LEVEL_UPS[i];
+        hash *= 16777619u;
+        hash ^= (uint8_t)(Profile::LEVEL_UPS[i] >> 8);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+#endif
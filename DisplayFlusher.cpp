@@ -0,0 +1,245 @@
+/******************************************************************************
+DisplayFlusher.cpp
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+#include "DisplayFlusher.h"
+#include "Arduino/Arduino.h"
+#include "Profiler.h"
+#include <string.h>
+
+DisplayFlusher *DisplayFlusher::_instance = 0;
+
+// ================================ Public Methods ================================
+
+DisplayFlusher::DisplayFlusher(MicroOLED &oled) : _oled(oled) {
+    memset(_frames, 0, sizeof(_frames));
+    _front = _frames[0];
+    _back = _frames[1];
+    _frontIsValid = false;
+    _isBusy = false;
+    _isPending = false;
+    _pendingSince = 0;
+    _sendingSince = 0;
+    memset(_runs, 0, sizeof(_runs));
+    _sending = &_runs[0];
+    _pending = &_runs[1];
+    _transfer = 0;
+    _isDma = false;
+    _dcPin = 0;
+    _csPin = 0;
+    _flushes = 0;
+    _framesSent = 0;
+    _framesMerged = 0;
+    _dataBytesSent = 0;
+    _latencyMicros = 0;
+    _maxLatencyMicros = 0;
+}
+
+void DisplayFlusher::useDma(int dcPin, int csPin) {
+    _isDma = true;
+    _dcPin = dcPin;
+    _csPin = csPin;
+    _instance = this; // Only one screen, so only one flusher sends by DMA
+}
+
+void DisplayFlusher::flush() {
+    FLAPPY_PROFILE_SCOPE(PROFILE_FLUSH);
+    _flushes++;
+
+    // A frame still waiting is taken back first, so the callback can't start it while
+    // it is being replaced. Then the back and its runs are ours
+    noInterrupts();
+    if (_isPending) {
+        _framesMerged++; // Never sent, this one has all of it anyway
+    }
+    _isPending = false;
+    interrupts();
+
+    // The front doesn't change while nothing is pending, so this can take its time
+    memcpy(_back, _oled.getScreenBuffer(), sizeof(_frames[0]));
+    _findRuns(*_pending);
+
+    noInterrupts();
+    _isPending = true;
+    _pendingSince = micros();
+    bool isFree = !_isBusy;
+    if (isFree) {
+        _isBusy = true; // Ours now, so the callback won't start it as well
+    }
+    interrupts();
+
+    if (isFree) {
+        _startFrame();
+    }
+}
+
+void DisplayFlusher::clearAll() {
+    // The library sends the wipe itself, and it can't do that in the middle of a frame
+    while (isBusy()) {
+        delay(1);
+    }
+    _oled.clear(ALL);
+    // The screen is all dark now
+    memset(_front, 0, sizeof(_frames[0]));
+    _frontIsValid = true;
+}
+
+void DisplayFlusher::invalidate() {
+    _frontIsValid = false;
+}
+
+bool DisplayFlusher::isBusy() {
+    return _isBusy;
+}
+
+// ============================ Getter methods =============================
+
+unsigned long DisplayFlusher::getFlushes() {
+    return _flushes;
+}
+
+unsigned long DisplayFlusher::getFramesSent() {
+    return _framesSent;
+}
+
+unsigned long DisplayFlusher::getFramesMerged() {
+    return _framesMerged;
+}
+
+unsigned long DisplayFlusher::getDataBytesSent() {
+    return _dataBytesSent;
+}
+
+unsigned long DisplayFlusher::getLatencyMicros() {
+    return _latencyMicros;
+}
+
+unsigned long DisplayFlusher::getMaxLatencyMicros() {
+    return _maxLatencyMicros;
+}
+
+// ================== Private Methods ============================
+
+void DisplayFlusher::_startFrame() {
+    // The newest frame goes to the front, with the runs flush() worked out for it. Only
+    // pointers move, since this can be in the callback
+    uint8_t *shown = _front;
+    _front = _back;
+    _back = shown;
+    Runs *sent = _sending;
+    _sending = _pending;
+    _pending = sent;
+    _isPending = false;
+    _sendingSince = _pendingSince;
+    if (_sending->isWhole) {
+        _frontIsValid = true;
+    }
+
+    if (_isDma) {
+        _transfer = 0;
+        _sendTransfer();
+        return;
+    }
+
+    // No DMA, so the oled sends them byte by byte before this returns
+    const Runs &runs = *_sending;
+    for (int run = 0; run < runs.count; run++) {
+        const uint8_t *row = _front + runs.page[run] * _WIDTH;
+        _oled.setPageAddress(runs.page[run]);
+        _oled.setColumnAddress(runs.first[run]);
+        for (int column = runs.first[run]; column <= runs.last[run]; column++) {
+            // The columns in the gaps we decided not to skip get sent again, which is harmless
+            _oled.data(row[column]);
+        }
+    }
+    _finishFrame();
+}
+
+void DisplayFlusher::_findRuns(Runs &runs) {
+    runs.count = 0;
+    runs.dataBytes = 0;
+    runs.isWhole = !_frontIsValid;
+    for (int page = 0; page < _PAGES; page++) {
+        const uint8_t *row = _back + page * _WIDTH;
+        const uint8_t *shownRow = _front + page * _WIDTH;
+
+        // Look for runs of columns that are different from what the screen shows
+        int runStart = -1; // First column of the run being built, -1 when there is none
+        int runEnd = -1; // Last different column of that run
+        for (int column = 0; column < _WIDTH; column++) {
+            if (!runs.isWhole && row[column] == shownRow[column]) {
+                continue;
+            }
+            if (runStart >= 0 && column - runEnd - 1 > _READDRESS_COST) {
+                // The gap is bigger than what a new column address costs, so send the run on its own
+                runs.page[runs.count] = page;
+                runs.first[runs.count] = runStart;
+                runs.last[runs.count] = runEnd;
+                runs.dataBytes += runEnd - runStart + 1;
+                runs.count++;
+                runStart = -1;
+            }
+            if (runStart < 0) {
+                runStart = column;
+            }
+            runEnd = column;
+        }
+        if (runStart >= 0) {
+            runs.page[runs.count] = page;
+            runs.first[runs.count] = runStart;
+            runs.last[runs.count] = runEnd;
+            runs.dataBytes += runEnd - runStart + 1;
+            runs.count++;
+        }
+    }
+}
+
+void DisplayFlusher::_sendTransfer() {
+    const Runs &runs = *_sending;
+    if (_transfer >= 2 * runs.count) {
+        _finishFrame();
+        return;
+    }
+    int run = _transfer / 2;
+    bool isData = (_transfer % 2) == 1;
+    _transfer++;
+
+    digitalWrite(_dcPin, isData ? HIGH : LOW);
+    digitalWrite(_csPin, LOW);
+    if (isData) {
+        int length = runs.last[run] - runs.first[run] + 1;
+        SPI.transfer(_front + runs.page[run] * _WIDTH + runs.first[run], NULL, length, _transferDone);
+        return;
+    }
+    // The same bytes setPageAddress() and setColumnAddress() send
+    _address[0] = 0xB0 | runs.page[run];
+    _address[1] = (0x10 | (runs.first[run] >> 4)) + 0x02;
+    _address[2] = 0x0F & runs.first[run];
+    SPI.transfer(_address, NULL, sizeof(_address), _transferDone);
+}
+
+void DisplayFlusher::_finishFrame() {
+    _dataBytesSent += _sending->dataBytes;
+    unsigned long latency = micros() - _sendingSince;
+    _latencyMicros += latency;
+    if (latency > _maxLatencyMicros) {
+        _maxLatencyMicros = latency;
+    }
+    _framesSent++;
+
+    // A frame came in while this one was going out, so it goes next
+    if (_isPending) {
+        _startFrame();
+        return;
+    }
+    _isBusy = false;
+}
+
+void DisplayFlusher::_transferDone() {
+    // Called by the DMA when a transfer is done, so in an interrupt on the Photon. Nothing
+    // in here looks at the pages, that was all done in flush()
+    digitalWrite(_instance->_csPin, HIGH);
+    _instance->_sendTransfer();
+}
@@ -0,0 +1,133 @@
+/******************************************************************************
+DisplayFlusher.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Only send what changed * *
+* oled.display() sends the whole 64x48 buffer over SPI, all 384 bytes, even when
+* the only thing that moved is the bird. Sending the bytes is most of the time a
+* frame takes, and at top speed the pillars move every 12 ms.
+*
+* The screen's memory is split into pages, each 8 pixels tall and one byte per
+* column. This class keeps a copy of what it last sent to the screen, and on
+* flush() compares the buffer with it page by page. Only the runs of columns that
+* are different get sent, each one after setting the page and column address.
+* Two runs close enough together are sent as one, because setting a new column
+* address costs two bytes too.
+*
+* * Sending in the background * *
+* Even only the changes are a few hundred µs of SPI, and oled.data() waits for every
+* byte. With useDma() the bytes go out by DMA instead, and flush() returns as soon
+* as the frame is handed over, so the game works on the next frame while this one
+* is still on the wire.
+*
+* For that the flusher keeps two frames of its own:
+*   front: what the screen shows, or will once the transfer going on is done. The
+*          DMA reads from it, so nothing touches it until then.
+*   back:  the newest frame flush() was given that hasn't been sent yet. If the bus
+*          is still busy, it waits here, and a newer flush() simply replaces it (the
+*          screen only ever needs the newest one).
+* When a transfer is done, its callback starts the frame waiting in the back: the two
+* swap, and the runs that differ are sent. So the screen always gets whole frames,
+* one after another, never half of one and half of the next.
+*
+* The runs are worked out in flush(), on the main thread, by comparing the new frame
+* with the front, which is what the screen will show by the time the new one goes
+* out. They are kept with the frame in the back, so the callback, which runs in an
+* interrupt on the Photon, never compares any pages. It only raises CS and starts the
+* next transfer, or swaps in the frame that is waiting along with its runs.
+*
+* Each run is two transfers: the 3 address bytes with DC low, then the columns with
+* DC high, with CS low around each. The callback chains them.
+*
+* Without useDma() the runs are sent right away through the oled, like before.
+******************************/
+
+#ifndef DISPLAYFLUSHER_H
+#define DISPLAYFLUSHER_H
+
+#include <stdint.h>
+#include "SparkFunMicroOLED/SparkFunMicroOLED.h"
+
+class DisplayFlusher {
+
+    public:
+
+        DisplayFlusher(MicroOLED &oled);
+
+        // Send by DMA from now on. The pins are the oled's DC and CS. Call before the first flush()
+        void useDma(int dcPin, int csPin);
+
+        void flush(); // Use this instead of oled.display()
+        void clearAll(); // Use this instead of oled.clear(ALL), which wipes the screen behind our back. Waits for the bus
+        void invalidate(); // Forget what the screen shows, so the next frame sends everything
+
+        bool isBusy(); // A frame is still on its way to the screen
+
+        // Getter methods
+        unsigned long getFlushes();
+        unsigned long getFramesSent(); // Frames the screen got all of
+        unsigned long getFramesMerged(); // Frames a newer flush() replaced before they were sent
+        unsigned long getDataBytesSent();
+        unsigned long getLatencyMicros(); // From flush() until the screen had the frame, all frames sent added up
+        unsigned long getMaxLatencyMicros();
+
+    private:
+
+        static const int _WIDTH = LCDWIDTH;
+        static const int _PAGES = LCDHEIGHT / 8;
+        static const int _READDRESS_COST = 2; // Bytes it takes to move to another column
+        static const int _MAX_RUNS = _PAGES * (_WIDTH / (_READDRESS_COST + 2) + 1); // Runs are apart by more than the cost
+
+        // The transfer callback has no argument, so it finds the flusher through this
+        static DisplayFlusher *_instance;
+
+        MicroOLED &_oled;
+        uint8_t _frames[2][_WIDTH * _PAGES];
+        uint8_t *_front; // What the screen shows, or will when the transfer is done
+        uint8_t *_back; // The newest frame, waiting for the bus
+        volatile bool _frontIsValid; // False until we know what the screen shows
+
+        // The columns of a frame that differ from the one before it
+        struct Runs {
+            uint8_t page[_MAX_RUNS];
+            uint8_t first[_MAX_RUNS];
+            uint8_t last[_MAX_RUNS];
+            int count;
+            int dataBytes;
+            bool isWhole; // Everything, because what the screen showed wasn't known
+        };
+
+        // The frame being sent
+        volatile bool _isBusy;
+        volatile bool _isPending; // There is a frame in the back
+        unsigned long _pendingSince; // micros() when the frame in the back was flushed
+        unsigned long _sendingSince;
+        Runs _runs[2];
+        Runs *_sending; // The front's
+        Runs *_pending; // The back's
+        int _transfer; // Of the frame being sent, 2 per run: the address and then the columns
+        uint8_t _address[3];
+
+        bool _isDma;
+        int _dcPin;
+        int _csPin;
+
+        unsigned long _flushes;
+        unsigned long _framesSent;
+        unsigned long _framesMerged;
+        unsigned long _dataBytesSent;
+        unsigned long _latencyMicros;
+        unsigned long _maxLatencyMicros;
+
+        // Swaps the frame in the back to the front and starts sending what changed. Only with the bus free
+        void _startFrame();
+        void _findRuns(Runs &runs); // The back against the front
+        void _sendTransfer(); // The next one of the frame being sent, by DMA
+        void _finishFrame();
+        static void _transferDone();
+};
+
+#endif
@@ -0,0 +1,87 @@
+/******************************************************************************
+FixedPoint.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Fixed point numbers * *
+* The bird's delays are doubles, and they change on every step. The Photon has a
+* floating point unit for floats, but cheaper boards (Cortex-M0 and M3) have none at
+* all, and there every double subtraction is a call into a software library that
+* takes hundreds of cycles. The pillars' delay doesn't need any of this: it is whole
+* ms out of the difficulty table (see Difficulty.h).
+*
+* A fixed point number is a whole number that counts in small pieces. Fixed<16> counts
+* in 1/65536ths, so 50 ms is stored as 50 * 65536 = 3276800, and taking 0.3 ms off
+* is a plain integer subtraction of 19661. That is called Q16.16: 16 bits for the whole
+* part and 16 for the fraction.
+*
+* Build with -DFLAPPY_FIXED_POINT_BITS=16 (or another amount of fraction bits) to use
+* it for the bird's delays. Without it they stay doubles, like they always were.
+*
+* * How close it is * *
+* The constants get rounded to the nearest 1/65536, so every step is off by at most
+* half of that, and it adds up. With 16 bits the bird's delay, which getDelay() cuts
+* down to whole ms, is the same or 1 ms off. It is off on the steps where it should
+* land exactly on a whole number (50 - 0.3 * 10 = 47), about 1 step in 10. There the
+* double is a hair above or below too, so which one is "right" was always down to
+* rounding. `flappyhost delay-bench` measures it. Fewer bits leave room for bigger
+* numbers but are less close: with 8, 0.3 becomes 0.3008, so the bird's delay is
+* 0.03 ms further down after 40 steps in a row.
+******************************/
+
+#ifndef FIXEDPOINT_H
+#define FIXEDPOINT_H
+
+#include <stdint.h>
+
+template <int FRACTION_BITS>
+class Fixed {
+
+    public:
+
+        static const int32_t ONE = (int32_t)1 << FRACTION_BITS;
+
+        constexpr Fixed() : _raw(0) {}
+        // Rounds to the nearest step. Only the tuning uses this (see GameConfig.h). It is explicit so a
+        // stray double in the code that runs every step can't turn into a soft float conversion unseen
+        explicit constexpr Fixed(double value) : _raw((int32_t)(value * ONE + (value >= 0 ? 0.5 : -0.5))) {}
+
+        static Fixed fromRaw(int32_t raw) {
+            Fixed number;
+            number._raw = raw;
+            return number;
+        }
+        int32_t getRaw() const { return _raw; }
+
+        // Like casting a double: int cuts off the fraction (towards zero)
+        explicit operator int() const { return (_raw >= 0) ? (_raw >> FRACTION_BITS) : -((-_raw) >> FRACTION_BITS); }
+        explicit operator float() const { return (float)_raw / ONE; }
+        explicit constexpr operator double() const { return (double)_raw / ONE; }
+
+        Fixed &operator+=(Fixed other) { _raw += other._raw; return *this; }
+        Fixed &operator-=(Fixed other) { _raw -= other._raw; return *this; }
+        Fixed operator+(Fixed other) const { return fromRaw(_raw + other._raw); }
+        Fixed operator-(Fixed other) const { return fromRaw(_raw - other._raw); }
+
+        bool operator<(Fixed other) const { return _raw < other._raw; }
+        bool operator>(Fixed other) const { return _raw > other._raw; }
+        bool operator<=(Fixed other) const { return _raw <= other._raw; }
+        bool operator>=(Fixed other) const { return _raw >= other._raw; }
+        bool operator==(Fixed other) const { return _raw == other._raw; }
+        bool operator!=(Fixed other) const { return _raw != other._raw; }
+
+    private:
+
+        int32_t _raw;
+};
+
+// The number the bird's delays are kept in
+#ifdef FLAPPY_FIXED_POINT_BITS
+typedef Fixed<FLAPPY_FIXED_POINT_BITS> BirdDelay;
+#else
+typedef double BirdDelay;
+#endif
+
+#endif
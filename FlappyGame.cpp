@@ -0,0 +1,759 @@
+/******************************************************************************
+FlappyGame.cpp
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+Original Creation Date: July 9
+Original Completion Date: July 13
+*****************************************************************************/
+
+/*******************************
+* * Animation concepts * *
+* It is not easy to do an animation where you pass in the final position and the
+* time of the animation and let the Photon do the work for yhou. Instead, you have
+* to move the items pixel by pixel and do animations such as acceleration by
+* changing the delay between each pixels.
+*
+* There are two animations going on. One is the bird, one is the pillars. The
+* problem if we use delay is that they update at different rate, so it will
+* result in one of them having animation with inconsistent rate. So we have to do
+* two at them at once instead of doing them together.
+*
+* Since photon doesn't support multithreading, and protothreading is very hard,
+* so it is better to not use functions like delay and do synchronized programming.
+* Instead, set a benchmark for when should the next action be executed, and wait
+* until the internal timer in the Photon reaches that mark, and then execute that
+* action. The advantage of this is that the way you wait for that action to be
+* executed allows you to do things in between that literally takes no time.
+*
+* Those marks are kept by a Scheduler (see Scheduler.h). The bird and the pillars
+* are each a task that sets its own next mark, and loop() sleeps until the earliest
+* one instead of checking the time over and over.
+*
+* * One frame, one flush * *
+* The bird and the pillar steps only move things. Each of them asks for the compose
+* task, which runs right after them in the same ms and draws the whole frame: the
+* pillars, then the bird and the HUD on top, and sends it with one flush(). The bird
+* used to be drawn and sent on its own, on top of pillars that hadn't scrolled yet,
+* which left a copy of it behind until the pillars moved. When both move in the same
+* ms, they share one frame.
+*
+* With useDisplayDma() the frame is sent in the background (see DisplayFlusher.h),
+* so the next steps run while the last frame is still going out.
+*
+* * Physics mode * *
+* With TIMED_PHYSICS there is only one task, the frame, and it runs every _FRAME_TIME
+* ms no matter how fast the game is going. Each frame moves the bird and the pillars
+* by the time since the last frame (see advance() in Bird and PillarManager) and
+* draws everything once. If a frame comes late, the next one simply moves things
+* further, so the game keeps up instead of slowing down.
+*
+* * Game over * *
+* The screens after a crash used to be three delay()s in a row, 1.6 s where the
+* button did nothing and the Photon couldn't do anything else. Now the game is always
+* in one of these states (GameState), and the flow task moves it along:
+*   PLAYING -> SCORE_SCREEN (600 ms) -> RESTARTING (800 ms) -> READY (200 ms) -> PLAYING
+* The flow task looks at the button every 20 ms in between, and a new press goes
+* straight to the next game. RESTARTING gets the next round ready while its screen
+* is up, so when the game starts again the first frame is only the game.
+*
+* * Attract mode * *
+* With setAutopilot(true) the game plays itself. Between passes of loop() the game is
+* taken as a snapshot and the autopilot looks ahead in it (see Autopilot.h), and the
+* bird's next step reads the autopilot's answer instead of the button.
+*
+* This used to live in flappybird.ino. It is a class now so the host build can run
+* the exact same game against a virtual clock.
+******************************/
+
+#include "FlappyGame.h"
+#include "Arduino/Arduino.h"
+#include "Profiler.h" // Stage timers, when FLAPPY_PROFILE is on
+
+using namespace Flashee;
+
+static_assert(FLAPPY_SIZE <= SpriteAtlas::MAX_BIRD_SIZE, "The bird sprite has to fit in one page of the screen");
+static_assert(DefaultGameConfig::SCREEN_WIDTH == LCDWIDTH && DefaultGameConfig::SCREEN_HEIGHT == LCDHEIGHT, "The game config has to match the screen");
+
+// ================================ Public Methods ================================
+
+FlappyGame::FlappyGame(MicroOLED &oled, int buttonPin, MotionMode mode) :
+    _oled(oled),
+    _mode(mode),
+    _screen(oled),
+    _raster(oled.getScreenBuffer(), LCDWIDTH, LCDHEIGHT),
+    _course(_raster),
+    _atlas(oled),
+    _flappy(),
+    _pillarManager() {
+
+    _flash = NULL;
+    _buttonPin = buttonPin;
+    _useButtonInterrupt = true;
+    _isPixelCollision = false;
+    _birdShape = CollisionMask();
+    _flaps = 0;
+    _lastFlapTime = 0;
+    _screenWidth = oled.getLCDWidth();
+    _screenHeight = oled.getLCDHeight();
+
+    // The order matters when two are due in the same millisecond: the bird and the
+    // pillars both move first, so the frame drawn after them has both
+    _birdTask = _scheduler.addTask("bird", _moveBirdTask, this);
+    _pillarTask = _scheduler.addTask("pillars", _movePillarsTask, this);
+    _composeTask = _scheduler.addTask("compose", _composeFrameTask, this);
+    _frameTask = (_mode == TIMED_PHYSICS) ? _scheduler.addTask("frame", _playFrameTask, this) : -1;
+    _flowTask = _scheduler.addTask("flow", _runFlowTask, this);
+    _state = PLAYING;
+    _stateDeadline = 0;
+    _gameOverTime = 0;
+    _isRoundPrepared = false;
+    _lastScore = 0;
+    _isNewHighScore = false;
+    _lastFrameTime = 0;
+
+    _flapUpTime = 0;
+    _isFirstFlap = false;
+    _previousFlap = false;
+    _currentHighScore = 0;
+    _playerId = 0;
+    _isAutopilot = false;
+    _isAutopilotPlanned = false;
+    _autopilotButton = false;
+    _scheduler.setIdleTask(_saveTask, this);
+
+    _isDeterministic = false;
+    _isRecording = false;
+    _isReplaying = false;
+    _replayDone = false;
+    _gameSeed = 0;
+    _roundStartTime = 0;
+    _replayCrashTime = 0;
+    _replayScore = 0;
+}
+
+void FlappyGame::useDisplayDma(int dcPin, int csPin) {
+    _screen.useDma(dcPin, csPin);
+}
+
+void FlappyGame::begin() {
+    FLAPPY_PROFILE_BEGIN();
+    _flash = Devices::createAddressErase(_STORE_START, _STORE_END);
+    _scores.begin(Devices::createUserFlashRegion(_SCORES_START, _SCORES_END));
+    _replays.begin(Devices::createUserFlashRegion(_REPLAYS_START, _REPLAYS_END));
+    if (_scores.getEntryCount() == 0) {
+        // The first start with the leaderboard. The old high score becomes player 0's.
+        // Erased flash reads as -1, so that one is skipped
+        int oldHighScore = 0;
+        _flash->read(oldHighScore, _OLD_HIGH_SCORE_ADDRESS);
+        if (oldHighScore > 0) {
+            _scores.submit(0, oldHighScore);
+        }
+    }
+    _currentHighScore = _scores.getBestScore();
+
+    _button.begin(_buttonPin, _useButtonInterrupt, &_scheduler); // Button pin
+    if (_useButtonInterrupt) {
+        _scheduler.setSleepSlice(_WAKE_SLICE);
+    }
+
+    // Create bird circle
+    _oled.begin();
+    _atlas.build(FLAPPY_SIZE); // Draw the digits, the labels and the bird once, to copy from later
+    _birdShape = CollisionMask::filled(_atlas.getBird());
+    _screen.clearAll();
+    _course.clear();
+    _drawBird(_screenHeight / 3); // Put the bird object on screen
+    _screen.flush();
+
+    _prepareRound();
+    _startRound(millis());
+}
+
+void FlappyGame::loop() {
+    // Do whatever is due, and then wait for exactly as long as nothing else is. This
+    // used to check millis() over and over with a delay(1) in between
+    _scheduler.runDue(millis());
+    _handleInput(millis());
+    _planAutopilot();
+    FLAPPY_PROFILE_PUMP(millis()); // A bit of the measurements goes out, if there is room
+    _scheduler.sleepUntilNext();
+}
+
+// ================================ Replays ================================
+
+void FlappyGame::record(uint32_t seed) {
+    _isDeterministic = true;
+    _isRecording = true;
+    _gameSeed = seed;
+}
+
+bool FlappyGame::replay(const uint8_t *bytes, int length) {
+    if (!_player.open(bytes, length) || _player.getConfigHash() != getConfigHash()) {
+        return false;
+    }
+    _isDeterministic = true;
+    _isReplaying = true;
+    _replayDone = false;
+    _gameSeed = _player.getSeed();
+    return true;
+}
+
+bool FlappyGame::isReplayDone() {
+    return _replayDone;
+}
+
+unsigned long FlappyGame::getReplayCrashTime() {
+    return _replayCrashTime;
+}
+
+int FlappyGame::getReplayScore() {
+    return _replayScore;
+}
+
+int FlappyGame::readLastReplay(uint8_t *bytes, int maxLength) {
+    return _replays.read(bytes, maxLength);
+}
+
+uint32_t FlappyGame::getConfigHash() {
+    uint32_t hash = DefaultGameConfig::hash();
+    hash = Replay::hashStep(hash, _mode);
+    hash = Replay::hashStep(hash, _FRAME_TIME);
+#ifdef FLAPPY_FIXED_POINT_BITS
+    hash = Replay::hashStep(hash, FLAPPY_FIXED_POINT_BITS); // The delays round differently
+#else
+    hash = Replay::hashStep(hash, 0);
+#endif
+    // The pillars go by the difficulty tables, and the heights come from Pcg32 (which
+    // replaced xorshift, so games recorded before it don't match)
+    hash = Replay::hashStep(hash, difficultyHash<DefaultGameConfig::Difficulty>());
+    if (_isPixelCollision) {
+        hash = Replay::hashStep(hash, 1); // Only when it is on, so games recorded before it still play back
+    }
+    return hash;
+}
+
+void FlappyGame::setPlayer(uint16_t player) {
+    _playerId = player;
+}
+
+void FlappyGame::setButtonInterrupt(bool isOn) {
+    _useButtonInterrupt = isOn;
+}
+
+void FlappyGame::setPixelCollision(bool isOn) {
+    _isPixelCollision = isOn;
+    _pillarManager.trackOccupancy(isOn ? &_occupancy : NULL);
+    _autopilot.setPixelCollision(isOn ? &_birdShape : NULL); // begin() fills the shape in
+}
+
+// ================================ Snapshots ================================
+
+void FlappyGame::setAutopilot(bool isOn) {
+    _isAutopilot = isOn && _mode == PIXEL_STEPS;
+    _isAutopilotPlanned = false;
+}
+
+bool FlappyGame::isAutopilotOn() {
+    return _isAutopilot;
+}
+
+GameSnapshot FlappyGame::snapshot() {
+    unsigned long now = millis();
+    GameSnapshot game = GameSnapshot(); // Zeroed, the unused fields and the padding too
+    game.bird = _flappy.getState();
+    game.pillars = _pillarManager.getState();
+    game.roundTime = now - _roundStartTime;
+    game.flapUpTime = (int8_t)_flapUpTime;
+    game.previousFlap = _previousFlap;
+    if (_mode == TIMED_PHYSICS) {
+        game.nextBird = _timeUntil(_frameTask, now);
+        game.sinceLastFrame = (int16_t)(now - _lastFrameTime);
+    } else {
+        game.nextBird = _timeUntil(_birdTask, now);
+        game.nextPillars = _timeUntil(_pillarTask, now);
+    }
+    return game;
+}
+
+void FlappyGame::restore(const GameSnapshot &game) {
+    unsigned long now = millis();
+    _flappy.setState(game.bird);
+    _pillarManager.setState(game.pillars);
+    _flapUpTime = game.flapUpTime;
+    _previousFlap = game.previousFlap;
+    _isFirstFlap = false;
+    _isAutopilotPlanned = false;
+    _roundStartTime = now - game.roundTime;
+
+    // Back into the round, wherever the game was
+    _scheduler.cancel(_flowTask);
+    _state = PLAYING;
+    if (_mode == TIMED_PHYSICS) {
+        _lastFrameTime = now - game.sinceLastFrame;
+        _scheduler.schedule(_frameTask, now + game.nextBird);
+    } else {
+        _scheduler.schedule(_birdTask, now + game.nextBird);
+        _scheduler.schedule(_pillarTask, now + game.nextPillars);
+    }
+
+    // Draw it the way it is now
+    _course.clear();
+    _scheduler.schedule(_composeTask, now);
+}
+
+unsigned long FlappyGame::_taskTime(unsigned long deadline) {
+    return _isDeterministic ? deadline : millis();
+}
+
+bool FlappyGame::_readButton(unsigned long now) {
+    unsigned long gameTime = now - _roundStartTime;
+    bool pressed;
+    if (_isReplaying) {
+        pressed = _player.buttonAt(gameTime);
+    } else if (_isAutopilot) {
+        // Worked out in loop() before this step. The first step of a round comes before any
+        // planning, and doesn't flap
+        pressed = _isAutopilotPlanned && _autopilotButton;
+        _isAutopilotPlanned = false;
+    } else if (_useButtonInterrupt) {
+        // A tap that is already over still counts, once. The button runs on the wall clock, even
+        // when the game runs every task right on its deadline
+        _button.poll(millis());
+        pressed = _button.isPressed() || _button.takePress();
+    } else {
+        pressed = digitalRead(_buttonPin);
+    }
+    if (_isRecording) {
+        _recorder.sample(gameTime, pressed);
+    }
+    return pressed;
+}
+
+void FlappyGame::_handleInput(unsigned long now) {
+    if (!_button.poll(now)) {
+        return;
+    }
+    if (_isAutopilot) {
+        // Someone wants to play. The autopilot's round is thrown away and a new one starts
+        // for them, with this press as its first flap
+        _isAutopilot = false;
+        if (_state == PLAYING) {
+            _scheduler.cancel(_birdTask);
+            _scheduler.cancel(_pillarTask);
+            _scheduler.cancel(_composeTask);
+            _prepareRound();
+            _startRound(now);
+            return;
+        }
+    }
+    if (_state != PLAYING) {
+        // The flow task decides if it skips the screens
+        _scheduler.schedule(_flowTask, now);
+        return;
+    }
+    // The bird reads the button on its next step, so that step happens now instead of
+    // up to a whole delay later. Not in the deterministic mode, where a step can only
+    // come on its own deadline, and not in the physics mode, where the next frame is
+    // never more than _FRAME_TIME away
+    if (_useButtonInterrupt && !_isDeterministic && _mode == PIXEL_STEPS && _scheduler.isScheduled(_birdTask)
+            && !Scheduler::isDue(_scheduler.getDeadline(_birdTask), now)) {
+        _scheduler.schedule(_birdTask, now);
+    }
+}
+
+void FlappyGame::_startFlap(unsigned long now) {
+    _flaps++;
+    _lastFlapTime = now;
+}
+
+void FlappyGame::_planAutopilot() {
+    if (!_isAutopilot || _isAutopilotPlanned || _state != PLAYING || !_scheduler.isScheduled(_birdTask)) {
+        return;
+    }
+    _autopilotButton = _autopilot.decide(snapshot());
+    _isAutopilotPlanned = true;
+}
+
+int16_t FlappyGame::_timeUntil(int task, unsigned long now) {
+    if (!_scheduler.isScheduled(task)) {
+        return 0;
+    }
+    long wait = (long)(_scheduler.getDeadline(task) - now);
+    return (int16_t)((wait > 32767) ? 32767 : wait);
+}
+
+void FlappyGame::_saveReplay() {
+    // Only copied here. It goes to flash in the idle time, like the scores
+    _replays.submit(_recorder.getBytes(), _recorder.getLength());
+}
+
+bool FlappyGame::_saveTask(void *game, unsigned long timeLeft) {
+    FlappyGame *self = (FlappyGame *)game;
+    return self->_scores.work(timeLeft) || self->_replays.work(timeLeft);
+}
+
+// ================================ Tasks ================================
+
+void FlappyGame::_moveBird(unsigned long deadline) {
+    (void)deadline;
+
+    // If it is the first flap, indicated by a positive non-zero flapUpTime
+    if (_flapUpTime > 0) {
+        _flapUpTime--;
+        _flappy.userInput(true); // True means flapped
+    }
+
+    // Determine if game is over
+    if (_birdCrashed()) {
+        _resetGame(_taskTime(deadline));
+        return;
+    }
+
+    // If not, the bird goes into the next frame
+    _scheduler.schedule(_composeTask, _taskTime(deadline));
+    _getUserInput(_taskTime(deadline)); // After finishing display, get user input
+
+    if (_flapUpTime > 0) {
+        // Boost the bird by another pixel right away instead of waiting for the flap delay.
+        // 1 ms later, like the delay(1) the old loop had after every bird step
+        _scheduler.schedule(_birdTask, _taskTime(deadline) + 1);
+    }
+}
+
+void FlappyGame::_movePillars(unsigned long deadline) {
+    // Step 1: Set the next deadline from this one, not from the time now, so how late this one ran, or the processing time in between, which isn't consistent considering it might only have to animate 1 pair of pillars or it might have to animate 3 pairs, will not affect when the next animation starts, so it keeps it at a constant rate.
+    // If the game stalled for longer than a whole step, it starts counting from now again instead of rushing to catch up
+    unsigned long now = _taskTime(deadline);
+    unsigned long next = deadline + _pillarManager.getDelay();
+    if (Scheduler::isDue(next, now)) {
+        next = now + _pillarManager.getDelay();
+    }
+    _scheduler.schedule(_pillarTask, next);
+
+    // Step 2: Do pillars stuff. They are drawn with the rest of the next frame, right after this
+    _pillarManager.timeToMove();
+    _scheduler.schedule(_composeTask, now);
+}
+
+void FlappyGame::_composeFrame(unsigned long deadline) {
+    (void)deadline;
+    if (_state != PLAYING) {
+        return; // The bird crashed in the same ms, and the score screen is up instead
+    }
+    // The pillars scroll over the old bird and HUD, then those go on top where they are now.
+    // Nothing was sent since the last frame, so the screen never shows only half of the changes
+    _course.draw(_pillarManager.getPillars(), _pillarManager.getSteps());
+    _drawBird(_flappy.getBirdPosition());
+    _drawScores();
+    _screen.flush();
+}
+
+void FlappyGame::_playFrame(unsigned long deadline) {
+    // The next frame is _FRAME_TIME after this one was due, with the same catching up rule as the pillars
+    unsigned long now = _taskTime(deadline);
+    unsigned long next = deadline + _FRAME_TIME;
+    if (Scheduler::isDue(next, now)) {
+        next = now + _FRAME_TIME;
+    }
+    _scheduler.schedule(_frameTask, next);
+
+    // Move everything by the time since the last frame, however long that was
+    unsigned long elapsed = now - _lastFrameTime;
+    _lastFrameTime = now;
+
+    bool flap = _readButton(now);
+    if (flap && !_previousFlap) {
+        _flappy.jump(3); // The same 3 px boost the pixel steps give at the start of a flap
+        _startFlap(now);
+    }
+    _previousFlap = flap;
+
+    _pillarManager.advance(elapsed);
+    _flappy.advance(elapsed, flap);
+
+    if (_birdCrashed()) {
+        _resetGame(now);
+        return;
+    }
+
+    // Draw the whole frame and send it once
+    _composeFrame(deadline);
+}
+
+bool FlappyGame::_birdCrashed() {
+    if (_isPixelCollision) {
+        return _flappy.birdCrashed(_occupancy, _birdShape);
+    }
+    return _flappy.birdCrashed(_pillarManager.getPillars());
+}
+
+void FlappyGame::_drawScores() {
+    FLAPPY_PROFILE_SCOPE(PROFILE_HUD);
+    // The numbers are only drawn again when they change
+    _scoreText.set(_atlas, _pillarManager.getAmountOfPillarsUserPassed());
+    _highScoreText.set(_atlas, _currentHighScore);
+
+    // User's current score in the top left corner, and the high score under "High" on the
+    // fifth and sixth lines of text. Text lines are 8 px apart
+    _course.blit(_scoreText.getSprite(), 1, 1, true);
+    _course.blit(_atlas.getHighLabel(), 0, 1 + 4 * SpriteAtlas::GLYPH_HEIGHT, true);
+    _course.blit(_highScoreText.getSprite(), 0, 1 + 5 * SpriteAtlas::GLYPH_HEIGHT, true);
+}
+
+void FlappyGame::_moveBirdTask(void *game, unsigned long deadline) {
+    ((FlappyGame *)game)->_moveBird(deadline);
+}
+
+void FlappyGame::_movePillarsTask(void *game, unsigned long deadline) {
+    ((FlappyGame *)game)->_movePillars(deadline);
+}
+
+void FlappyGame::_composeFrameTask(void *game, unsigned long deadline) {
+    ((FlappyGame *)game)->_composeFrame(deadline);
+}
+
+void FlappyGame::_playFrameTask(void *game, unsigned long deadline) {
+    ((FlappyGame *)game)->_playFrame(deadline);
+}
+
+void FlappyGame::_runFlowTask(void *game, unsigned long deadline) {
+    ((FlappyGame *)game)->_runFlow(deadline);
+}
+
+// ============================ Getter methods =============================
+
+Bird &FlappyGame::getBird() {
+    return _flappy;
+}
+
+PillarManager &FlappyGame::getPillarManager() {
+    return _pillarManager;
+}
+
+int FlappyGame::getHighScore() {
+    return _currentHighScore;
+}
+
+GameState FlappyGame::getState() {
+    return _state;
+}
+
+ButtonInput &FlappyGame::getButtonInput() {
+    return _button;
+}
+
+unsigned long FlappyGame::getFlaps() {
+    return _flaps;
+}
+
+unsigned long FlappyGame::getLastFlapTime() {
+    return _lastFlapTime;
+}
+
+ScoreStore &FlappyGame::getScoreStore() {
+    return _scores;
+}
+
+Autopilot &FlappyGame::getAutopilot() {
+    return _autopilot;
+}
+
+Scheduler &FlappyGame::getScheduler() {
+    return _scheduler;
+}
+
+DisplayFlusher &FlappyGame::getDisplayFlusher() {
+    return _screen;
+}
+
+// ============== Functions update bird time and reset ===============
+
+void FlappyGame::_updateBirdTime(unsigned long now, int delay) {
+    _scheduler.schedule(_birdTask, now + delay);
+}
+
+void FlappyGame::_resetGame(unsigned long crashTime) {
+    int userScore = _pillarManager.getAmountOfPillarsUserPassed();
+    if (_isRecording) {
+        _recorder.crash(crashTime - _roundStartTime, userScore);
+        _saveReplay();
+    }
+
+    // The round is over, so none of its tasks run any more. From here the flow task
+    // runs the screens, see _runFlow()
+    _scheduler.cancel(_birdTask);
+    _scheduler.cancel(_pillarTask);
+    _scheduler.cancel(_composeTask);
+    _scheduler.cancel(_frameTask);
+
+    if (_isReplaying) {
+        // The replay is over. Everything is stopped, so the one playing it back can compare how it ended
+        _replayDone = true;
+        _replayCrashTime = crashTime - _roundStartTime;
+        _replayScore = userScore;
+        return;
+    }
+
+    // Record user score and compare that to existing high score. The leaderboard only
+    // queues it here, it is written while the next screens are up. The autopilot's scores
+    // are only shown
+    _lastScore = userScore;
+    _isNewHighScore = !_isAutopilot && userScore > _currentHighScore;
+    if (!_isAutopilot) {
+        _scores.submit(_playerId, userScore);
+    }
+    if (_isNewHighScore) {
+        _currentHighScore = userScore;
+    }
+
+    // A press that the bird didn't get to doesn't skip anything, and neither does a button
+    // still down from the last flap. It has to be let go and pressed again
+    _button.poll(millis());
+    _button.takePress();
+    _gameOverTime = crashTime;
+    _isRoundPrepared = false;
+    _enterState(SCORE_SCREEN, crashTime);
+}
+
+void FlappyGame::_runFlow(unsigned long deadline) {
+    unsigned long now = _taskTime(deadline);
+
+    // A new press skips the rest of the screens, once the score has been up for a moment
+    _button.poll(millis());
+    bool skip = _button.takePress() && now - _gameOverTime >= _SKIP_GUARD_TIME;
+    if (skip) {
+        _enterState(READY, now);
+        _enterState(PLAYING, now); // Straight away, the next frame is already the game
+        return;
+    }
+
+    if (Scheduler::isDue(_stateDeadline, now)) {
+        // READY is the last one, after that the game is on again
+        _enterState((_state == READY) ? PLAYING : (GameState)(_state + 1), now);
+        return;
+    }
+    _scheduleFlow(now);
+}
+
+void FlappyGame::_enterState(GameState state, unsigned long now) {
+    _state = state;
+    switch (state) {
+        case SCORE_SCREEN:
+            _course.clear();
+            _oled.setCursor(0, 0);
+            if (_isNewHighScore) {
+                _oled.print("Yay, you  beat the  high score          Your scoreis ");
+            } else {
+                _oled.print("Nice job. Your score is ");
+            }
+            _oled.print(_lastScore);
+            _screen.flush();
+            _stateDeadline = now + _SCORE_SCREEN_TIME;
+            break;
+
+        case RESTARTING:
+            // No need for clear(ALL) here any more. The flush sends every column that was lit and isn't now
+            _course.clear();
+            _oled.setCursor(1, 1);
+            _oled.print("Game over.Currently restarting");
+            _screen.flush();
+            // Nothing else is going on while this is up, so the next round gets ready now
+            _prepareRound();
+            _stateDeadline = now + _RESTART_SCREEN_TIME;
+            break;
+
+        case READY:
+            if (!_isRoundPrepared) {
+                _prepareRound(); // Skipped straight here from the score
+            }
+            // Redisplay the flappy bird
+            _course.clear();
+            _drawBird(_screenHeight / 3);
+            _screen.flush();
+            _stateDeadline = now + _READY_TIME;
+            break;
+
+        case PLAYING:
+            _scheduler.cancel(_flowTask);
+            _startRound(now);
+            return;
+    }
+    _scheduleFlow(now);
+}
+
+void FlappyGame::_scheduleFlow(unsigned long now) {
+    // The button is looked at every _FLOW_POLL_TIME ms (with the interrupt, a press
+    // also brings this forward, see _handleInput()). While the leaderboard or the replays
+    // have something to write the gaps are made long enough for them to erase a sector
+    bool hasWork = _scores.hasWork() || _replays.hasWork();
+    unsigned long poll = hasWork ? ScoreStore::ERASE_TIME + _FLOW_POLL_TIME : _FLOW_POLL_TIME;
+    unsigned long next = now + poll;
+    if (Scheduler::isDue(_stateDeadline, next)) {
+        next = _stateDeadline;
+    }
+    _scheduler.schedule(_flowTask, next);
+}
+
+void FlappyGame::_prepareRound() {
+    // Everything the first frame needs, so it doesn't have to be done once the game is on
+    _flappy.reset();
+    if (_isDeterministic) {
+        // Every game gets its own seed, so a replay of it only needs that one
+        _pillarManager.seedRandom(_gameSeed);
+    }
+    _pillarManager.reset();
+    _course.redrawAll(); // Different pillars, so there is nothing on screen to scroll
+    if (_isRecording) {
+        _recorder.start(_gameSeed, getConfigHash(), _mode);
+    }
+    if (_isDeterministic) {
+        _gameSeed = _gameSeed * 1664525u + 1013904223u; // The next game's
+    }
+    _scoreText.set(_atlas, 0);
+    _highScoreText.set(_atlas, _currentHighScore);
+
+    // Reset variables
+    _previousFlap = false;
+    _isFirstFlap = false;
+    _flapUpTime = 0;
+    _isRoundPrepared = true;
+}
+
+void FlappyGame::_startRound(unsigned long now) {
+    _state = PLAYING;
+    _roundStartTime = now;
+
+    if (_mode == TIMED_PHYSICS) {
+        // The time spent on the score screen doesn't count, so the first frame starts from now
+        _lastFrameTime = _roundStartTime;
+        _scheduler.schedule(_frameTask, _lastFrameTime + _FRAME_TIME);
+        return;
+    }
+
+    // Initialize the expecation times
+    _scheduler.schedule(_pillarTask, _roundStartTime + _pillarManager.getDelay()); // When should the pillar by updated by 1 px
+    _getUserInput(_roundStartTime); // See what the user is doing with the button and do actions with it
+}
+
+void FlappyGame::_drawBird(int y) {
+    FLAPPY_PROFILE_SCOPE(PROFILE_DRAW_BIRD);
+    // Same pixels as oled.circle(_screenWidth / 2, y, FLAPPY_SIZE), copied from the atlas
+    _course.blit(_atlas.getBird(), _screenWidth / 2 - FLAPPY_SIZE, y - FLAPPY_SIZE, false);
+}
+
+void FlappyGame::_getUserInput(unsigned long now) {
+    FLAPPY_PROFILE_SCOPE(PROFILE_INPUT); // Includes the bird's step, which is also timed on its own
+    bool flap = _readButton(now); // Read user input
+
+    _flappy.userInput(flap); // True is user pressed down.
+    _updateBirdTime(now, _flappy.getDelay()); // Set next delay time
+
+    // Make the isFirstFlap variable, and if it is first, then boost the bird
+    _isFirstFlap = (_previousFlap ==  false && flap);
+
+    _previousFlap = flap;
+    if (_isFirstFlap) {
+        _flapUpTime = 3;
+        _startFlap(now);
+    }
+}
@@ -0,0 +1,258 @@
+/******************************************************************************
+FlappyGame.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+// ####### For the animation timing, please read the notes at FlappyGame.cpp #######
+
+#ifndef FLAPPYGAME_H
+#define FLAPPYGAME_H
+
+#include "flashee-eeprom/flashee-eeprom.h" // Persistent storage
+#include "SparkFunMicroOLED/SparkFunMicroOLED.h" // Include Micro OLED library
+
+#include "PillarManager.h" // Pillar Manager manages the pillars
+#include "bird.h" // The bird class is responsible for the flappy bird on screen
+#include "Scheduler.h" // Runs the bird, the pillars and the frame when they are due
+#include "DisplayFlusher.h" // Sends only the parts of the screen that changed
+#include "Raster.h" // Draws rects and sprites into the screen buffer a word at a time
+#include "CourseRenderer.h" // Scrolls the pillars on screen instead of drawing them all again
+#include "SpriteAtlas.h" // Ready-made digits, labels and bird to copy onto the screen
+#include "Replay.h" // Recording games and playing them back
+#include "ScoreStore.h" // The leaderboard, saved a record at a time
+#include "ReplayStore.h" // The last recorded game, saved a chunk at a time
+#include "ButtonInput.h" // The button, debounced in an interrupt
+#include "Autopilot.h" // Snapshots of the game, and a bot that plays by looking ahead in them
+
+#define FLAPPY_SIZE DefaultGameConfig::BIRD_SIZE // The bird is a circle. This is the radius, at most SpriteAtlas::MAX_BIRD_SIZE. Change it in GameConfig.h
+
+// How the bird and the pillars are moved. Read the notes at FlappyGame.cpp
+enum MotionMode {
+    PIXEL_STEPS, // 1 px at a time, each after its own delay. The way the game always worked
+    TIMED_PHYSICS // Everything moves by the time since the last frame, and frames come at a steady rate
+};
+
+// Where the game is. Read the notes at FlappyGame.cpp. The order is the order they come in
+enum GameState {
+    PLAYING,
+    SCORE_SCREEN, // The score, after a crash
+    RESTARTING, // "Game over", while the next round gets ready
+    READY // The bird on its own, just before the next round
+};
+
+// The whole game: the bird, the pillars, the screen and the button. The sketch only
+// creates one of these and calls begin() from setup() and loop() from loop(), so the
+// same game can also be driven by the host build on a computer
+class FlappyGame {
+
+    public:
+
+        FlappyGame(MicroOLED &oled, int buttonPin, MotionMode mode = PIXEL_STEPS);
+
+        void begin(); // Call this in setup()
+        void loop(); // Call this in loop()
+
+        // The deterministic mode. Call one of these before begin(). Read the notes at Replay.h
+        void record(uint32_t seed); // Every game is written down, and the last one is kept in flash
+        bool replay(const uint8_t *bytes, int length); // Plays a recorded game instead of reading the button. False if it was recorded with another config
+        bool isReplayDone(); // The game being played back has crashed
+        unsigned long getReplayCrashTime(); // When it crashed, in ms since it started
+        int getReplayScore();
+        int readLastReplay(uint8_t *bytes, int maxLength); // The last recorded game, from flash. Returns its length, 0 if there is none
+        uint32_t getConfigHash(); // Everything a replay depends on, besides the seed and the button
+
+        // Whose scores go on the leaderboard from now on. Player 0 until this is called
+        void setPlayer(uint16_t player);
+
+        // Call before begin(). Off reads the pin only when the bird is due, the way the
+        // game always did. On (the default) takes every press from an interrupt, see ButtonInput.h
+        void setButtonInterrupt(bool isOn);
+
+        // Call before begin(). The frames go to the screen by DMA while the game goes on,
+        // see DisplayFlusher.h. The pins are the oled's DC and CS
+        void useDisplayDma(int dcPin, int csPin);
+
+        // Call before begin(). On, the bird only crashes when its pixels touch a pillar's,
+        // see Occupancy.h. Off (the default) keeps the hitbox the game always had
+        void setPixelCollision(bool isOn);
+
+        // Attract mode. The autopilot plays instead of the button (PIXEL_STEPS only), and its
+        // scores stay off the leaderboard. A real press hands the game back to the player
+        void setAutopilot(bool isOn);
+        bool isAutopilotOn();
+
+        // The whole round in a few dozen bytes, and back. Only while PLAYING, and restoring
+        // doesn't go into a recording. See Autopilot.h
+        GameSnapshot snapshot();
+        void restore(const GameSnapshot &game);
+
+        // Getter methods
+        Bird &getBird();
+        PillarManager &getPillarManager();
+        int getHighScore();
+        GameState getState();
+        ButtonInput &getButtonInput();
+        unsigned long getFlaps(); // How many flaps have started
+        unsigned long getLastFlapTime(); // millis() when the last one started, for measuring input latency
+        ScoreStore &getScoreStore();
+        Autopilot &getAutopilot();
+        Scheduler &getScheduler();
+        DisplayFlusher &getDisplayFlusher();
+
+    private:
+
+        static const int _FRAME_TIME = 20; // ms between frames in the physics mode, so 50 frames a second
+        // How long each screen after a crash is up, in ms
+        static const unsigned long _SCORE_SCREEN_TIME = 600;
+        static const unsigned long _RESTART_SCREEN_TIME = 800;
+        static const unsigned long _READY_TIME = 200;
+        static const unsigned long _FLOW_POLL_TIME = 20; // How often the button is looked at on those screens
+        static const unsigned long _WAKE_SLICE = 1; // ms, how soon a sleeping loop() notices a press from the interrupt
+        static const unsigned long _SKIP_GUARD_TIME = 250; // The score is up at least this long, so one extra flap doesn't skip it
+        static const Flashee::flash_addr_t _OLD_HIGH_SCORE_ADDRESS = 10; // Where the high score was kept before the leaderboard
+        // The flash is split between the two stores by hand, so neither can write over the
+        // other. Flashee's createDefaultStore() is createAddressErase() over the first 256
+        // pages (1MB) of the user flash. The game asks for those same pages by address, so the
+        // high score and the replay older builds wrote are still where they were
+        static const Flashee::flash_addr_t _STORE_START = 0;
+        static const Flashee::flash_addr_t _STORE_END = 256 * 4096;
+        // The leaderboard's own sectors, right after them
+        static const Flashee::flash_addr_t _SCORES_START = _STORE_END;
+        static const Flashee::flash_addr_t _SCORES_END = _SCORES_START + 4 * 4096;
+        static_assert(_SCORES_START >= _STORE_END || _SCORES_END <= _STORE_START, "The leaderboard can't share pages with the default store");
+        // And the replays', after those. A replay used to be at 4096 in the default store
+        static const Flashee::flash_addr_t _REPLAYS_START = _SCORES_END;
+        static const Flashee::flash_addr_t _REPLAYS_END = _REPLAYS_START + 4 * 4096;
+        static_assert(_REPLAYS_START >= _SCORES_END, "The replays can't share pages with the leaderboard");
+        static_assert(_REPLAYS_END <= 384 * 4096, "The user flash is 384 pages (1.5MB)");
+
+        MicroOLED &_oled;
+        MotionMode _mode;
+        DisplayFlusher _screen; // Draw with _oled, then send with _screen.flush() instead of _oled.display()
+        Raster _raster; // The pillars, the bird and the scores are drawn with this instead of _oled
+        CourseRenderer _course; // The pillars, scrolled. The bird and the scores go on top through it
+        SpriteAtlas _atlas;
+        NumberText _scoreText;
+        NumberText _highScoreText;
+        Flashee::FlashDevice *_flash; // The default store. Only read, for the high score older builds kept there
+        int _buttonPin; // Button pin for users input
+        ButtonInput _button;
+        bool _useButtonInterrupt;
+        unsigned long _flaps;
+        unsigned long _lastFlapTime;
+        int _screenWidth;
+        int _screenHeight;
+        bool _isPixelCollision;
+        CollisionMask _birdShape; // The bird from the atlas, filled in, for the pixel collision
+        Occupancy _occupancy; // The pillars' pixels, kept by the pillar manager with the pixel collision on
+
+        // Animated objects
+        Bird _flappy; // The flappy bird on screen
+        PillarManager _pillarManager; // Manages all the pillars and give the needed information
+
+        // The bird and the pillars each have a task with a deadline, which is the mark the internal timer has to reach for it to move by 1 px. The compose task draws and sends the frame after them
+        Scheduler _scheduler;
+        int _birdTask;
+        int _pillarTask;
+        int _composeTask;
+        int _frameTask; // Physics mode only. It does what the other three do, once per frame
+        int _flowTask; // Runs the screens between rounds
+        unsigned long _lastFrameTime;
+
+        // Each time when the user STARTS pressing the button, we want to make the flappy bird go up not just by 1 px but multiple pixels so this variable allows the flappy bird to have the ability to go up despite the user's input. And each time it moves 1 px in the loop, it is automatically decreased by 1 until it reaches 0
+        int _flapUpTime;
+
+        // These two following variables work with the flapUpTime variable and determine if the user STARTED pressing the button or has already pressed the button for a long time
+        bool _isFirstFlap;
+        bool _previousFlap;
+
+        // This variable records the highest score
+        int _currentHighScore;
+        ScoreStore _scores; // Every player's best, written to flash when there is time
+        ReplayStore _replays; // The last recorded game, the same way
+        uint16_t _playerId;
+
+        // Attract mode
+        Autopilot _autopilot;
+        bool _isAutopilot;
+        bool _isAutopilotPlanned; // _autopilotButton is for the bird's next step
+        bool _autopilotButton;
+
+        // Between rounds
+        GameState _state;
+        unsigned long _stateDeadline; // When the screen that is up moves on to the next
+        unsigned long _gameOverTime;
+        bool _isRoundPrepared;
+        int _lastScore;
+        bool _isNewHighScore;
+
+        // Deterministic mode. Every game's times are counted from _roundStartTime
+        bool _isDeterministic;
+        bool _isRecording;
+        bool _isReplaying;
+        bool _replayDone;
+        uint32_t _gameSeed; // The seed of the next game
+        unsigned long _roundStartTime;
+        unsigned long _replayCrashTime;
+        int _replayScore;
+        ReplayRecorder _recorder;
+        ReplayPlayer _player;
+
+        // The time a task should work from: its deadline in the deterministic mode, so
+        // running late changes nothing, and millis() like it always was otherwise
+        unsigned long _taskTime(unsigned long deadline);
+        // Reads the button, or the replay, and writes down the edges when recording
+        bool _readButton(unsigned long now);
+        // Takes in what the interrupt saw. A press moves the bird (or the screens) up to now
+        void _handleInput(unsigned long now);
+        void _startFlap(unsigned long now);
+        // Works out the autopilot's button for the bird's next step, if it hasn't yet
+        void _planAutopilot();
+        // ms from now to the task's deadline, 0 if it isn't scheduled
+        int16_t _timeUntil(int task, unsigned long now);
+        void _saveReplay();
+
+        // Lets the score store write while nothing is due
+        static bool _saveTask(void *game, unsigned long timeLeft); // The scores first, then the replay
+
+        // This function receives the delay returned from the bird and schedules the bird's task, and when the millis() function reaches that time, it executes the action, which is animation.
+        void _updateBirdTime(unsigned long now, int delay);
+
+        // The tasks. Each one schedules its own next run
+        void _moveBird(unsigned long deadline);
+        void _movePillars(unsigned long deadline);
+        void _composeFrame(unsigned long deadline); // Draws the pillars, the bird and the HUD, and flushes once
+        static void _moveBirdTask(void *game, unsigned long deadline);
+        static void _movePillarsTask(void *game, unsigned long deadline);
+        static void _composeFrameTask(void *game, unsigned long deadline);
+        void _playFrame(unsigned long deadline);
+        static void _playFrameTask(void *game, unsigned long deadline);
+        void _runFlow(unsigned long deadline);
+        static void _runFlowTask(void *game, unsigned long deadline);
+
+        // Draws the screen of the new state and schedules the flow task for it
+        void _enterState(GameState state, unsigned long now);
+        void _scheduleFlow(unsigned long now);
+        // Resets the bird, the pillars and the scores for the next round, ahead of time
+        void _prepareRound();
+        // Schedules the first run of the tasks for a new round
+        void _startRound(unsigned long now);
+
+        // Drawing, without sending anything to the screen
+        void _drawScores();
+
+        // Draws the bird in the middle of the screen, with its centre at y
+        void _drawBird(int y);
+
+        // The hitbox or the pixel collision, whichever is on
+        bool _birdCrashed();
+
+        // This function ends the round and puts the score screen up. The flow task restarts the game from there
+        void _resetGame(unsigned long crashTime);
+
+        // This function handles the part where it receives the user's input and handle what to do with the bird
+        void _getUserInput(unsigned long now);
+};
+
+#endif
@@ -0,0 +1,226 @@
+/******************************************************************************
+GameConfig.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * One place for the numbers * *
+* The size of the screen, the bird and the pillars used to be passed to every
+* constructor and kept in every object, and the tuning numbers were const members,
+* so each bird and each pillar carried its own copy. None of them ever change while
+* the game runs.
+*
+* Now they are all in a GameConfig, and Bird, Pillar and PillarManager are templates
+* that take one. The numbers are known when compiling, so the compiler can work out
+* things like screenWidth / 2 ahead of time, and the objects only keep what actually
+* changes. The static_asserts at the bottom stop a config that can't work from
+* compiling at all.
+*
+* The same code is compiled for every config listed in bird.cpp, pillar.cpp and
+* PillarManager.cpp: the 64x48 MicroOLED the game was made for, a 128x64 panel and
+* a 320x240 one.
+* Bird, Pillar, PillarManager and PillarRing are the 64x48 ones.
+******************************/
+
+#ifndef GAMECONFIG_H
+#define GAMECONFIG_H
+
+#include <stdint.h>
+#include "Difficulty.h" // The tables the pillars speed up and level up by
+#include "FixedPoint.h" // BirdDelay, which the tuning keeps the bird's numbers in
+
+// How many pairs of pillars can be on the 64x48 screen at once. The pillars are stored in
+// place in a ring buffer of this size, so it has to be known when compiling. Build with
+// -DMAX_AMOUNT_OF_PILLARS_ON_SCREEN=... to run denser courses
+#ifndef MAX_AMOUNT_OF_PILLARS_ON_SCREEN
+#define MAX_AMOUNT_OF_PILLARS_ON_SCREEN 3
+#endif
+
+// The difficulty profile every config plays. Build with -DFLAPPY_DIFFICULTY=GentleDifficulty
+// (or any other profile, see Difficulty.h) for another one
+#ifndef FLAPPY_DIFFICULTY
+#define FLAPPY_DIFFICULTY LinearDifficulty
+#endif
+
+template <int SCREEN_WIDTH_, int SCREEN_HEIGHT_, int BIRD_SIZE_, int MAX_PILLARS_, int PILLAR_WIDTH_ = 10, int BIRD_SPACE_ = 25>
+struct GameConfig {
+
+    // ==================== Geometry ======================
+    static constexpr int SCREEN_WIDTH = SCREEN_WIDTH_;
+    static constexpr int SCREEN_HEIGHT = SCREEN_HEIGHT_;
+    static constexpr int BIRD_SIZE = BIRD_SIZE_; // The bird is a circle. This is the radius
+    static constexpr int BIRD_X = SCREEN_WIDTH / 2; // The bird never leaves the middle column
+    static constexpr int MAX_PILLARS = MAX_PILLARS_; // Pairs of pillars on screen at once
+    static constexpr int PILLAR_WIDTH = PILLAR_WIDTH_;
+    static constexpr int BIRD_SPACE = BIRD_SPACE_; // The gap between the top and the bottom pillar
+
+    // ==================== Bird ======================
+    static constexpr double GRAVITATIONAL_DELAY = 50; // ms per px when the bird starts falling
+    static constexpr double FLAP_DELAY = 40; // ms per px when the bird starts flapping
+    static constexpr double BIRD_ACCELERATION_RATE = 0.3; // How much the delay decreases after each pixel in the same direction
+    static constexpr int HITBOX_INSET = 4; // See Collision::DEFAULT_HITBOX_INSET
+
+    // ==================== Pillars ======================
+    static constexpr double PILLAR_DELAY = 30; // ms per px at the start of a game
+    static constexpr double MIN_PILLAR_DELAY = 12.0; // The fastest the pillars ever go
+    static constexpr double PILLAR_ACCELERATION_RATE = 0.005; // How much the delay decreases after each pixel
+    static constexpr int MIN_PILLAR_BETWEEN_PILLAR_SPACE = 15;
+    static constexpr int MIN_HEIGHT_OF_PILLARS = 4;
+    static constexpr int PILLARS_PASSED_TO_LEVEL_UP_STARTING_POINT = 6;
+    static constexpr int PILLARS_PASSED_TO_LEVEL_UP_FACTOR = 2;
+    // The tables the pillars actually go by. LinearDifficulty makes them from the numbers above
+    typedef FLAPPY_DIFFICULTY<GameConfig> Difficulty;
+
+    // A number that changes when any of the numbers above do. Replays are only played back
+    // on the same config they were recorded with (see Replay.h)
+    static uint32_t hash() {
+        const int32_t values[] = {
+            SCREEN_WIDTH, SCREEN_HEIGHT, BIRD_SIZE, MAX_PILLARS, PILLAR_WIDTH, BIRD_SPACE,
+            (int32_t)(GRAVITATIONAL_DELAY * 1000000), (int32_t)(FLAP_DELAY * 1000000), (int32_t)(BIRD_ACCELERATION_RATE * 1000000), HITBOX_INSET,
+            (int32_t)(PILLAR_DELAY * 1000000), (int32_t)(MIN_PILLAR_DELAY * 1000000), (int32_t)(PILLAR_ACCELERATION_RATE * 1000000),
+            MIN_PILLAR_BETWEEN_PILLAR_SPACE, MIN_HEIGHT_OF_PILLARS, PILLARS_PASSED_TO_LEVEL_UP_STARTING_POINT, PILLARS_PASSED_TO_LEVEL_UP_FACTOR
+        };
+        uint32_t hash = 2166136261u; // FNV-1a
+        for (unsigned int i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+            for (int b = 0; b < 4; b++) {
+                hash ^= (uint8_t)(values[i] >> (8 * b));
+                hash *= 16777619u;
+            }
+        }
+        return hash;
+    }
+
+    // ==================== Checks ======================
+    static_assert(SCREEN_WIDTH > 0 && SCREEN_HEIGHT > 0, "The screen needs a size");
+    static_assert(BIRD_SIZE >= 1, "The bird needs to be at least 1 px");
+    static_assert(MAX_PILLARS >= 1, "There has to be room for at least one pair of pillars");
+    static_assert(BIRD_SPACE > 2 * BIRD_SIZE + 1, "The bird has to fit through the gap");
+    static_assert(SCREEN_HEIGHT - 2 * MIN_HEIGHT_OF_PILLARS - BIRD_SPACE > 0, "The pillars need room for a random height");
+    static_assert(SCREEN_WIDTH > PILLAR_WIDTH + MIN_PILLAR_BETWEEN_PILLAR_SPACE, "A new pillar has to fit on the screen");
+    static_assert(BIRD_X - BIRD_SIZE > 0, "The bird has to be on the screen");
+    static_assert(MIN_PILLAR_DELAY > 0 && PILLAR_DELAY >= MIN_PILLAR_DELAY, "The pillar delays can't go the wrong way");
+};
+
+// The SparkFun MicroOLED the game was made for
+typedef GameConfig<64, 48, 2, MAX_AMOUNT_OF_PILLARS_ON_SCREEN> MicroOledConfig;
+
+// A 128x64 panel (SSD1306 or SH1106). The bird is a bit bigger and there is room for more pillars
+typedef GameConfig<128, 64, 3, 5> LargePanelConfig;
+
+// A 320x240 panel, one bit per pixel. Room for a dozen pairs of pillars at once
+typedef GameConfig<320, 240, 3, 16> WidePanelConfig;
+
+// What Bird, Pillar, PillarManager and the sketch use
+typedef MicroOledConfig DefaultGameConfig;
+
+// The tuning numbers of a config as plain values. Bird and PillarManager play by one of
+// these, and give the pillars their gap from it. Unless they are given another one it is DefaultTuning<Config>::TUNING,
+// which the compiler works out from the config, so the game itself plays the numbers in
+// the config like it always did. `flappyhost sweep` plays thousands of games on the same
+// classes with each tuning it is given (see host/Sweep.h)
+struct GameTuning {
+    static const int SPEED_FRACTION_BITS = 16; // The physics speeds count in 1/65536 px, like the bird (see bird.h)
+
+    int birdSpace;
+    BirdDelay gravitationalDelay; // The bird's numbers are in the kind of number its delays are,
+    BirdDelay flapDelay;          // so a fixed point build never converts them while it plays
+    BirdDelay birdAccelerationRate;
+    double pillarDelay;
+    double minPillarDelay;
+    double pillarAccelerationRate;
+    int minPillarBetweenPillarSpace;
+    int levelUpStartingPoint;
+    int levelUpFactor;
+
+    // The physics mode's speeds, in px per second and px per second per second, worked out
+    // from the bird's numbers above by of() and derive(). For the config's own tuning that is
+    // the compiler's job, so there is no floating point left for the board
+    int32_t fallSpeed;
+    int32_t flapSpeed;
+    int32_t fallAcceleration;
+    int32_t flapAcceleration;
+
+    // The tables the pillars go by. of() points them at the config's difficulty profile, and
+    // a sweep at the ones it makes from the numbers above
+    const DelayStep *delays;
+    int delayCount;
+    const uint16_t *levelUps;
+    int levelUpCount;
+
+    // 1 px every d ms is 1000 / d px per second. Taking r ms off the delay for every pixel
+    // speeds it up by r / d^3 px per ms per ms, which is r / d^3 * 1000000 per second
+    static constexpr int32_t speedOf(double delay) {
+        return (int32_t)(1000.0 / delay * (1 << SPEED_FRACTION_BITS));
+    }
+    static constexpr int32_t accelerationOf(double rate, double delay) {
+        return (int32_t)(rate * 1000000.0 / (delay * delay * delay) * (1 << SPEED_FRACTION_BITS));
+    }
+
+    // The numbers the config was built with
+    template <class Config>
+    static constexpr GameTuning of() {
+        return GameTuning{
+            Config::BIRD_SPACE, BirdDelay(Config::GRAVITATIONAL_DELAY), BirdDelay(Config::FLAP_DELAY), BirdDelay(Config::BIRD_ACCELERATION_RATE),
+            Config::PILLAR_DELAY, Config::MIN_PILLAR_DELAY, Config::PILLAR_ACCELERATION_RATE,
+            Config::MIN_PILLAR_BETWEEN_PILLAR_SPACE, Config::PILLARS_PASSED_TO_LEVEL_UP_STARTING_POINT, Config::PILLARS_PASSED_TO_LEVEL_UP_FACTOR,
+            speedOf((double)BirdDelay(Config::GRAVITATIONAL_DELAY)), speedOf((double)BirdDelay(Config::FLAP_DELAY)),
+            accelerationOf((double)BirdDelay(Config::BIRD_ACCELERATION_RATE), (double)BirdDelay(Config::GRAVITATIONAL_DELAY)),
+            accelerationOf((double)BirdDelay(Config::BIRD_ACCELERATION_RATE), (double)BirdDelay(Config::FLAP_DELAY)),
+            Config::Difficulty::DELAYS, Config::Difficulty::DELAY_COUNT, Config::Difficulty::LEVEL_UPS, Config::Difficulty::LEVEL_UP_COUNT
+        };
+    }
+
+    // Works out the physics speeds again after the bird's numbers were changed, the same way
+    // of() does. The tables are left as they are
+    void derive() {
+        fallSpeed = speedOf((double)gravitationalDelay);
+        flapSpeed = speedOf((double)flapDelay);
+        fallAcceleration = accelerationOf((double)birdAccelerationRate, (double)gravitationalDelay);
+        flapAcceleration = accelerationOf((double)birdAccelerationRate, (double)flapDelay);
+    }
+
+    // The same checks as the static_asserts in GameConfig and LinearDelays, for the screen of
+    // Config. Returns what is wrong, or 0 if the numbers can be played
+    template <class Config>
+    const char *problem() const {
+        if (birdSpace <= 2 * Config::BIRD_SIZE + 1) {
+            return "The bird has to fit through the gap";
+        }
+        if (Config::SCREEN_HEIGHT - 2 * Config::MIN_HEIGHT_OF_PILLARS - birdSpace <= 0) {
+            return "The pillars need room for a random height";
+        }
+        if (minPillarBetweenPillarSpace < 0 || Config::SCREEN_WIDTH <= Config::PILLAR_WIDTH + minPillarBetweenPillarSpace) {
+            return "A new pillar has to fit on the screen";
+        }
+        if (!(minPillarDelay > 0 && pillarDelay >= minPillarDelay) || pillarAccelerationRate < 0) {
+            return "The pillar delays can't go the wrong way";
+        }
+        int64_t startNs = (int64_t)(pillarDelay * 1000000 + 0.5);
+        int64_t rateNs = (int64_t)(pillarAccelerationRate * 1000000 + 0.5);
+        if (startNs / 1000000 > 255) {
+            return "The delays are kept in a byte";
+        }
+        if ((startNs - linearSpeedUps(startNs, (int64_t)(minPillarDelay * 1000000 + 0.5), rateNs) * rateNs) / 1000000 < 1) {
+            return "The pillars have to wait at least 1 ms per px";
+        }
+        if (!(gravitationalDelay >= BirdDelay(1) && flapDelay >= BirdDelay(1) && birdAccelerationRate >= BirdDelay(0))) {
+            return "The bird has to wait at least 1 ms per px";
+        }
+        if (levelUpStartingPoint < 0 || levelUpFactor < 1) {
+            return "The level ups have to go up";
+        }
+        return 0;
+    }
+};
+
+// The tuning every Bird and PillarManager of the config plays by unless it is given
+// another one. Worked out by the compiler, so it is there before any global game is made
+template <class Config>
+struct DefaultTuning {
+    static constexpr GameTuning TUNING = GameTuning::of<Config>();
+};
+
+template <class Config> constexpr GameTuning DefaultTuning<Config>::TUNING;
+
+#endif
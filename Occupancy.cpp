@@ -0,0 +1,107 @@
+/******************************************************************************
+Occupancy.cpp
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+#include "Occupancy.h"
+
+// ================================ Public Methods ================================
+
+template <class Config>
+void BasicOccupancy<Config>::draw(const PillarRing &pillars) {
+    _first = 0;
+    drawColumns(pillars, 0, Config::SCREEN_WIDTH);
+}
+
+template <class Config>
+void BasicOccupancy<Config>::drawColumns(const PillarRing &pillars, int from, int to) {
+    from = (from < 0) ? 0 : from;
+    to = (to > Config::SCREEN_WIDTH) ? Config::SCREEN_WIDTH : to;
+    for (int x = from; x < to; x++) {
+        int slot = _slot(x) % Config::SCREEN_WIDTH;
+        uint64_t *words = _columns[slot];
+        column(pillars, x, words);
+        // And the same in the second copy
+        for (int w = 0; w < WORDS + 1; w++) {
+            _columns[slot + Config::SCREEN_WIDTH][w] = words[w];
+        }
+    }
+}
+
+template <class Config>
+void BasicOccupancy<Config>::scroll(const PillarRing &pillars, int pixels) {
+    if (pixels >= Config::SCREEN_WIDTH) {
+        draw(pillars); // Nothing that was on screen is left
+        return;
+    }
+    // Every column moves that far to the left, and the ones that were on the left come back on the right
+    _first = (_first + pixels) % Config::SCREEN_WIDTH;
+    if (pixels == 1) {
+        // The pillars are in order and don't overlap, so only the last one can be in the new
+        // column. Unless it starts right there, that column is empty or the one left of it again
+        int x = Config::SCREEN_WIDTH - 1;
+        if (pillars.isEmpty() || pillars.back().getXEnd() <= x) {
+            clearColumns(x, x + 1);
+            return;
+        }
+        if (pillars.back().getX() < x) {
+            _copyColumn(_columns[_slot(x - 1)], x);
+            return;
+        }
+    }
+    drawColumns(pillars, Config::SCREEN_WIDTH - pixels, Config::SCREEN_WIDTH);
+}
+
+template <class Config>
+void BasicOccupancy<Config>::column(const PillarRing &pillars, int x, uint64_t *words) {
+    for (int w = 0; w < WORDS + 1; w++) { // The spare one too
+        words[w] = 0;
+    }
+    // The pillars are few and in order, so the ones in this column are found by looking at them all
+    for (int i = 0; i < pillars.size() && pillars[i].getX() <= x; i++) {
+        if (x < pillars[i].getXEnd()) {
+            // Above the gap and under it, like the rects the pillar is drawn with
+            _setRows(words, 0, pillars[i].getGapTop());
+            _setRows(words, pillars[i].getGapBottom(), Config::SCREEN_HEIGHT);
+        }
+    }
+}
+
+template <class Config>
+void BasicOccupancy<Config>::clearColumns(int from, int to) {
+    static const uint64_t empty[WORDS + 1] = {};
+    from = (from < 0) ? 0 : from;
+    to = (to > Config::SCREEN_WIDTH) ? Config::SCREEN_WIDTH : to;
+    for (int x = from; x < to; x++) {
+        _copyColumn(empty, x);
+    }
+}
+
+// ================== Private Methods ============================
+
+template <class Config>
+void BasicOccupancy<Config>::_copyColumn(const uint64_t *words, int x) {
+    // Into both copies of the ring
+    int slot = _slot(x) % Config::SCREEN_WIDTH;
+    for (int w = 0; w < WORDS + 1; w++) {
+        _columns[slot][w] = words[w];
+        _columns[slot + Config::SCREEN_WIDTH][w] = words[w];
+    }
+}
+
+template <class Config>
+void BasicOccupancy<Config>::_setRows(uint64_t *words, int from, int to) {
+    for (int w = from / 64; w < WORDS && w * 64 < to; w++) {
+        int first = from - w * 64;
+        int last = to - w * 64; // Not included
+        first = (first < 0) ? 0 : first;
+        uint64_t upToLast = (last >= 64) ? ~(uint64_t)0 : ((uint64_t)1 << last) - 1;
+        words[w] |= upToLast & ~(((uint64_t)1 << first) - 1);
+    }
+}
+
+// The configs the game can be built for. See GameConfig.h
+template class BasicOccupancy<MicroOledConfig>;
+template class BasicOccupancy<LargePanelConfig>;
+template class BasicOccupancy<WidePanelConfig>;
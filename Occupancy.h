@@ -0,0 +1,167 @@
+/******************************************************************************
+Occupancy.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Crashing only when it touches * *
+* birdCrashed() treats the round bird as a box. The box reaches one column past the
+* right side of a pillar and one row under the top pillar, and its corners are where
+* the round bird has none. So the bird often "crashes" a pixel away from a pillar,
+* and the inset of 4 was there to make up for some of it.
+*
+* The pixel collision is exact instead. The occupancy keeps one bit for every pixel
+* of the screen, set where a pillar is, one column at a time: a column is 64 bit
+* words, bit 0 of the first one the top row, so the 48 or 64 rows of the small
+* screens are a single word. The bird is a mask of the same kind, one word per
+* column, filled in between the top and the bottom of the circle the game draws (see
+* CollisionMask). A crash is any column where the two have a bit in common, which is
+* one AND per column of the bird, 5 of them, however many pillars there are. On a
+* taller screen the bird can be across two words, which is one AND more.
+*
+* The occupancy is kept up to date as the pillars move, a column at a time. When the
+* pillars move 1 px the columns are a ring, so the start of the ring moves on by one
+* and only the new column on the right is worked out. Even that is mostly a copy:
+* only the last pillar can be in it, and unless that pillar starts there the new
+* column is empty or the same as the one left of it. The ring is kept twice, one
+* copy after the other, so from any start the columns of the screen are side by
+* side and hits() never has to go round the end. A pillar that is recycled takes
+* its columns with it, and nothing else is in them, so those few are cleared.
+* Nothing else ever changes on its own.
+*
+* So the pixel collision costs more than the hitbox it replaces, not less. The
+* hitbox needs nothing kept at all, and keeping the occupancy makes a pillar step
+* about a fifth to a quarter slower on the host (2 to 6 ns on 15 to 23). The check
+* is slower too, if only a little: around 1 ns more than the broadphase of
+* Collision.h, 7 to 10 ns against 6 to 8.5. collision-verify prints both. The mode
+* is there for the exact crash, and it stays off unless it is asked for. The
+* autopilot never keeps one (see Autopilot.h).
+*
+* `flappyhost collision-verify` checks the occupancy against the pillars drawn into
+* a screen buffer after every step, and the crashes against the bird drawn on top.
+******************************/
+
+#ifndef OCCUPANCY_H
+#define OCCUPANCY_H
+
+#include <stdint.h>
+#include "pillar.h"
+#include "Raster.h" // Sprite
+
+// A picture as one word per column, with everything between its top and bottom pixel filled in
+struct CollisionMask {
+    static const int MAX_WIDTH = 16;
+
+    uint32_t rows[MAX_WIDTH]; // Bit 0 is the top row
+    uint8_t width;
+    uint8_t height;
+
+    // The shape of a sprite like the bird from SpriteAtlas, which is only the outline
+    static CollisionMask filled(const Sprite &sprite) {
+        CollisionMask mask = CollisionMask();
+        mask.width = (sprite.width < MAX_WIDTH) ? sprite.width : MAX_WIDTH;
+        mask.height = sprite.height;
+        for (int column = 0; column < mask.width; column++) {
+            // From the top pixel of the column to the bottom one
+            int top = -1;
+            int bottom = -1;
+            for (int row = 0; row < 8 && row < sprite.height; row++) {
+                if (sprite.columns[column] & (1 << row)) {
+                    top = (top < 0) ? row : top;
+                    bottom = row;
+                }
+            }
+            if (top >= 0) {
+                mask.rows[column] = ((2u << bottom) - 1) & ~((1u << top) - 1);
+            }
+        }
+        return mask;
+    }
+};
+
+template <class Config>
+class BasicOccupancy {
+
+    public:
+
+        typedef typename BasicPillar<Config>::Ring PillarRing;
+
+        static const int WORDS = (Config::SCREEN_HEIGHT + 63) / 64; // Per column
+
+        // The columns come from draw(). Until then they are left as they are
+        BasicOccupancy() { _first = 0; }
+
+        void draw(const PillarRing &pillars); // Works out every column again
+        void drawColumns(const PillarRing &pillars, int from, int to); // Only these, to not included
+        void scroll(const PillarRing &pillars, int pixels = 1); // The pillars just moved that far to the left
+        void clearColumns(int from, int to); // No pillar is in these any more, to not included
+
+        // True if the mask, with its top left corner at x and y, has a pixel on a pillar.
+        // It is checked every time the bird moves, so it is in here to be inlined, like Collision.h
+        bool hits(const CollisionMask &mask, int x, int y) const;
+
+        // The words of the column at x, which has to be on the screen
+        const uint64_t *getColumn(int x) const { return _columns[_slot(x)]; }
+
+        // Without keeping an occupancy, for something that only needs a few columns. column()
+        // works out the WORDS + 1 words of the column at x, the last one 0. hitsColumns() is
+        // hits() on columns worked out like that, side by side, the first one x. The ones
+        // off the screen are never looked at, so they can be left out
+        static void column(const PillarRing &pillars, int x, uint64_t *words);
+        static bool hitsColumns(const uint64_t *columns, const CollisionMask &mask, int x, int y);
+
+    private:
+
+        // The ring twice over. One more word than the screen needs, always 0, so hits() can
+        // read two words anywhere
+        uint64_t _columns[2 * Config::SCREEN_WIDTH][WORDS + 1];
+        int _first; // The slot of column 0, in the first copy
+
+        int _slot(int x) const { return _first + x; } // In one copy or the other
+        void _copyColumn(const uint64_t *words, int x); // Sets the column at x to these words
+        static void _setRows(uint64_t *words, int from, int to); // Rows from up to to, not included
+
+        // What hits() and hitsColumns() share. words is the first column on the screen
+        static bool _touches(const uint64_t *words, const CollisionMask &mask, int x, int y);
+};
+
+template <class Config>
+inline bool BasicOccupancy<Config>::hits(const CollisionMask &mask, int x, int y) const {
+    return _touches(_columns[_slot((x < 0) ? 0 : x)], mask, x, y);
+}
+
+template <class Config>
+inline bool BasicOccupancy<Config>::hitsColumns(const uint64_t *columns, const CollisionMask &mask, int x, int y) {
+    return _touches(columns + ((x < 0) ? -x : 0) * (WORDS + 1), mask, x, y);
+}
+
+template <class Config>
+inline bool BasicOccupancy<Config>::_touches(const uint64_t *words, const CollisionMask &mask, int x, int y) {
+    if (y >= Config::SCREEN_HEIGHT || y + mask.height <= 0) {
+        return false; // All of it is off the screen, above or below
+    }
+    // The words the mask's rows fall in, and where in them it starts
+    int word = (y >= 0) ? y / 64 : 0;
+    int shift = (y >= 0) ? y % 64 : 0;
+    int cut = (y >= 0) ? 0 : -y; // Rows of the mask above the screen
+    // Only the columns on the screen
+    int from = (x < 0) ? -x : 0;
+    int to = (x + mask.width > Config::SCREEN_WIDTH) ? Config::SCREEN_WIDTH - x : mask.width;
+    words += word;
+    uint64_t touching = 0;
+    for (int column = from; column < to; column++, words += WORDS + 1) {
+        uint64_t birdRows = mask.rows[column] >> cut;
+        touching |= words[0] & (birdRows << shift);
+        if (WORDS > 1) {
+            // The rows that went on into the next word. Shifting by 64 does nothing, so it is two shifts
+            touching |= words[1] & (birdRows >> (63 - shift) >> 1);
+        }
+    }
+    return touching != 0;
+}
+
+// The 64x48 one the game uses
+typedef BasicOccupancy<DefaultGameConfig> Occupancy;
+
+#endif
@@ -6,76 +6,222 @@ Original Creation Date: July 9
 Original Completion Date: July 13
 *****************************************************************************/
 
+/*******************************
+* * Physics mode * *
+* Instead of waiting for each delay, advance() is told how much time went by and
+* works out how many 1 px steps fit in it.
+*
+* The delay is the same for every step until the next entry of the difficulty table
+* (see Difficulty.h), so the steps up to there take (steps left) * delay. advance()
+* goes a whole entry at a time while the time lasts, and the part of an entry the
+* time ends in is a division. 20 ms never reach past more than one entry, and an
+* hour only goes through the table once.
+*
+* The steps themselves don't have to be done one by one either. Most of them only
+* move every pillar 1 px to the left, or give a point when a pillar's right edge
+* gets to the bird. Only a few need the step done the usual way: the first pillar
+* leaving and getting recycled with a new random height, the last pillar getting far
+* enough from the edge while a new one waits for room, and a point that could bring
+* an extra pillar. Those come when a pillar gets to a known x, so the steps until
+* the next one are a subtraction (see _quietStepsAhead()). advance() moves
+* everything that far in one go, adding up the points on the way, does the step with
+* the event in it, and carries on. That is about two steps per pillar instead of
+* every pixel, whatever the delay is.
+******************************/
+
 #include "PillarManager.h"
 #include "Arduino/Arduino.h"
-#include <math.h>
+#include "Profiler.h"
 
 // ================== Public Methods ==============================
 
-PillarManager::PillarManager(int screenWidth, int screenHeight) {
+template <class Config>
+BasicPillarManager<Config>::BasicPillarManager(const GameTuning &tuning) {
     /*****************************************
      * Initialization Plan:
-     * 1. Fill in screen width and screen height variable for future uses
-     * 2. Random height and create a pillar
-     * 3. Initialize the following variables
-     * * * _amountOfPillarsOnScreen, _amountOfPillarsUserPassed, _pillarsPassedToLevelUp,
-     * * * and _currentPillarSpeed
+     * 1. Random height and create a pillar
+     * 2. Initialize the following variables
+     * * * _amountOfPillarsUserPassed, _steps,
+     * * * _delayIndex and _levelUps
     *****************************************/
 
+    // The screen width and height used to be filled in here. They are in the config now
 
-    // 1. Fill in screen width and screen height variable for future uses
-    _screenWidth = screenWidth;
-    _screenHeight = screenHeight;
-
-    // 2. Random height and create a pillar
+    // 1. Random height and create a pillar. The seed comes from random() until seedRandom() is called
+    _tuning = &tuning;
+    _occupancy = NULL;
+    _isSeeded = false;
+    _seedFromRandom();
     int heightForTopPillar = _generateRandomHeight();
-    _pillars[0] = _newPillarWithHeight(heightForTopPillar);
-    // 3. Initialize properties
-    _amountOfPillarsOnScreen = 1;
+    _pillars.pushBack(_newPillarWithHeight(heightForTopPillar));
+    // 2. Initialize properties
     _amountOfPillarsUserPassed = 0;
-    _currentPillarDelay = _DEFAULT_DELAY_OF_PILLARS;
-    _pillarsPassedToLevelUp = _PILLARS_PASSED_TO_LEVEL_UP_STARTING_POINT;
+    _steps = 0;
+    _delayIndex = 0;
+    _levelUps = 0;
+    _isGoneButHasntReachedYet = false;
+    _timeSinceLastStep = 0;
 }
 
-Pillar **PillarManager::timeToMove() {
+template <class Config>
+BasicPillarManager<Config>::BasicPillarManager(const State &state, const GameTuning &tuning) {
+    _tuning = &tuning;
+    _occupancy = NULL;
+    setState(state);
+}
+
+template <class Config>
+const typename BasicPillarManager<Config>::PillarRing &BasicPillarManager<Config>::timeToMove() {
+    FLAPPY_PROFILE_SCOPE(PROFILE_PILLAR_STEP);
     _timeToMove(); // Call private timeToMove function P.S. I couldn't think of a better name
     return _pillars;
 }
 
-void PillarManager::reset() {
-    // Delete all the pillars
-    for (int i = 0; i < _MAX_AMOUNT_OF_PILLARS_ON_SCREEN; i++) {
-        delete _pillars[i];
+template <class Config>
+const typename BasicPillarManager<Config>::PillarRing &BasicPillarManager<Config>::advance(unsigned long milliseconds) {
+    FLAPPY_PROFILE_SCOPE(PROFILE_PILLAR_STEP);
+    _timeSinceLastStep += (int64_t)milliseconds << _FRACTION_BITS;
+
+    int64_t timeUsed;
+    int64_t steps = _stepsWithin(_timeSinceLastStep, timeUsed);
+    _timeSinceLastStep -= timeUsed; // The part of a step that is left goes towards the next one
+
+    while (steps > 0) {
+        int64_t quiet = _quietStepsAhead();
+        if (quiet == 0) {
+            _timeToMove(); // Something happens in this one
+            steps--;
+            continue;
+        }
+        quiet = (quiet < steps) ? quiet : steps;
+        _moveQuietSteps((int)quiet);
+        steps -= quiet;
     }
+    return _pillars;
+}
+
+template <class Config>
+void BasicPillarManager<Config>::reset() {
+    // Forget all the pillars. They live in the ring buffer, so there is nothing to delete
+    _pillars.clear();
     // Reset variables
-    // 1. Random height and create a pillar
+    // 1. Random height and create a pillar. A seeded game carries on with the same numbers
+    if (!_isSeeded) {
+        _seedFromRandom();
+    }
     int heightForTopPillar = _generateRandomHeight();
-    _pillars[0] = _newPillarWithHeight(heightForTopPillar);
+    _pillars.pushBack(_newPillarWithHeight(heightForTopPillar));
     // 2. Reset the properties
-    _amountOfPillarsOnScreen = 1;
-    _amountOfPillarsUserPassed = 0;
-    _currentPillarDelay = _DEFAULT_DELAY_OF_PILLARS;
-    _pillarsPassedToLevelUp = _PILLARS_PASSED_TO_LEVEL_UP_STARTING_POINT;
     _amountOfPillarsUserPassed = 0;
+    _steps = 0;
+    _delayIndex = 0;
+    _levelUps = 0;
+    _isGoneButHasntReachedYet = false;
+    _timeSinceLastStep = 0;
+    if (_occupancy != NULL) {
+        _occupancy->draw(_pillars);
+    }
+}
+
+template <class Config>
+void BasicPillarManager<Config>::seedRandom(uint32_t seed) {
+    _isSeeded = true;
+    _seed(seed);
+}
+
+template <class Config>
+void BasicPillarManager<Config>::trackOccupancy(BasicOccupancy<Config> *occupancy) {
+    _occupancy = occupancy;
+    if (occupancy != NULL) {
+        occupancy->draw(_pillars); // Whatever was in it is from before
+    }
 }
 
 // ============================ Getter methods =============================
 
-float PillarManager::getDelay() {
-    return _currentPillarDelay;
+template <class Config>
+int BasicPillarManager<Config>::getDelay() {
+    return _tuning->delays[_delayIndex].delay;
 }
 
-int PillarManager::getCurrentAmountOfPillarsOnScreen() {
-    return _amountOfPillarsOnScreen;
+template <class Config>
+int BasicPillarManager<Config>::getUpcomingHeight(int i) {
+    return _upcomingHeights[i];
 }
 
-int PillarManager::getAmountOfPillarsUserPassed() {
+template <class Config>
+uint32_t BasicPillarManager<Config>::getSteps() {
+    return _steps;
+}
+
+template <class Config>
+const typename BasicPillarManager<Config>::PillarRing &BasicPillarManager<Config>::getPillars() {
+    return _pillars;
+}
+
+template <class Config>
+int BasicPillarManager<Config>::getCurrentAmountOfPillarsOnScreen() {
+    return _pillars.size();
+}
+
+template <class Config>
+int BasicPillarManager<Config>::getAmountOfPillarsUserPassed() {
     return _amountOfPillarsUserPassed;
 }
 
+// ============================ Saving and restoring =============================
+
+template <class Config>
+typename BasicPillarManager<Config>::State BasicPillarManager<Config>::getState() const {
+    State state = State(); // Zeroes the padding too, so equal states compare equal byte for byte
+    state.randomState = _random.getState();
+    state.steps = _steps;
+    state.timeSinceLastStep = (int32_t)_timeSinceLastStep;
+    state.pillarsPassed = _amountOfPillarsUserPassed;
+    state.delayIndex = (uint8_t)_delayIndex;
+    state.levelUps = (uint8_t)_levelUps;
+    state.isGoneButHasntReachedYet = _isGoneButHasntReachedYet;
+    state.isSeeded = _isSeeded;
+    for (int i = 0; i < HEIGHT_LOOKAHEAD; i++) {
+        state.upcomingHeights[i] = _upcomingHeights[i];
+    }
+    state.pillarCount = (uint8_t)_pillars.size();
+    for (int i = 0; i < Config::MAX_PILLARS; i++) {
+        // The empty slots are zeroed too, so two equal games always give the same bytes
+        bool isUsed = i < _pillars.size();
+        state.pillarX[i] = isUsed ? (int16_t)_pillars[i].getX() : 0;
+        state.pillarHeight[i] = isUsed ? (uint8_t)_pillars[i].getGapTop() : 0;
+    }
+    return state;
+}
+
+template <class Config>
+void BasicPillarManager<Config>::setState(const State &state) {
+    _random.setState(state.randomState);
+    _steps = state.steps;
+    _timeSinceLastStep = state.timeSinceLastStep;
+    _amountOfPillarsUserPassed = state.pillarsPassed;
+    _delayIndex = (state.delayIndex < _tuning->delayCount) ? state.delayIndex : _tuning->delayCount - 1;
+    _levelUps = state.levelUps;
+    _isGoneButHasntReachedYet = state.isGoneButHasntReachedYet;
+    _isSeeded = state.isSeeded;
+    _upcomingHeights.clear();
+    for (int i = 0; i < HEIGHT_LOOKAHEAD; i++) {
+        _upcomingHeights.pushBack(state.upcomingHeights[i]);
+    }
+    _pillars.clear();
+    for (int i = 0; i < state.pillarCount && i < Config::MAX_PILLARS; i++) {
+        _pillars.pushBack(PillarType(state.pillarHeight[i], state.pillarX[i], _tuning->birdSpace));
+    }
+    if (_occupancy != NULL) {
+        _occupancy->draw(_pillars);
+    }
+}
+
 // ================== Private Methods ============================
 
-void PillarManager::_timeToMove() {
+template <class Config>
+void BasicPillarManager<Config>::_timeToMove() {
     _addPillarsIfNeeded();
     // Record user's achievement
     if (_pillarPassed()) {
@@ -87,136 +233,245 @@ void PillarManager::_timeToMove() {
 
 // =================== Add Pillars Methods =======================
 
-void PillarManager::_addPillarsIfNeeded() {
+template <class Config>
+void BasicPillarManager<Config>::_addPillarsIfNeeded() {
     /******************************
      * Determination Plan
      * 1. If a pillar is off the screen, recycle and append
-     * 2. If the user meets the _pillarsPassedToLevelUp, then add one
+     * 2. If the user passes the next score in the level up table, then add one
     *******************************/
 
-    static bool isGoneButHasntReachedYet;
-
     // 1. If a pillar is off the screen, recycle and append
 
     // If the first pillar is gone, but when before the last pillar isn't far enough to start a new one but now it is far enough, then add a new pillar
-    if (isGoneButHasntReachedYet &&  _lastPillarIsFarEnoughToAddNew()) {
+    // (This used to be a static variable in here, which every PillarManager shared and reset() never cleared)
+    if (_isGoneButHasntReachedYet &&  _lastPillarIsFarEnoughToAddNew()) {
         _appendExtraPillar();
-        isGoneButHasntReachedYet = false;
+        _isGoneButHasntReachedYet = false;
     }
-    if (_pillars[0]->isGone() &&  _lastPillarIsFarEnoughToAddNew()) {
+    bool firstPillarIsGone = !_pillars.isEmpty() && _pillars.front().isGone();
+    if (firstPillarIsGone &&  _lastPillarIsFarEnoughToAddNew()) {
         // If the first pillar is gone and there is enough space for another pillar, then recycle the first pillar and add another pillar
         _recycleFirstPillar();
         _appendExtraPillar();
-    } else if (_pillars[0]->isGone() && !_lastPillarIsFarEnoughToAddNew()) {
+    } else if (firstPillarIsGone && !_lastPillarIsFarEnoughToAddNew()) {
         // The first pillar is gone, but the last pillar on the screen isn't far away to start a new pillar
-        // So I recorded this in a variable isGoneButHasntReachedYet
+        // So I recorded this in a variable _isGoneButHasntReachedYet
         _recycleFirstPillar();
-        isGoneButHasntReachedYet = true;
+        _isGoneButHasntReachedYet = true;
     }
 
     // 2. If the user passes the amount of pillars required to pass to level up, the max amount of pillars on screen hasn't reached yet, and there is space for another one, then add an extra pillar on screen
-    if (_amountOfPillarsUserPassed > _pillarsPassedToLevelUp && _amountOfPillarsOnScreen <= _MAX_AMOUNT_OF_PILLARS_ON_SCREEN && _lastPillarIsFarEnoughToAddNew()) {
+    // (This used to check <= the max, which let a fourth pillar be written past the end of the old array)
+    // (The score to pass used to be doubled here each time. It is looked up in the level up table now)
+    if (_levelUps < _tuning->levelUpCount && _amountOfPillarsUserPassed > _tuning->levelUps[_levelUps] && !_pillars.isFull() && _lastPillarIsFarEnoughToAddNew()) {
         _appendExtraPillar();
-        _pillarsPassedToLevelUp *= _PILLARS_PASSED_TO_LEVEL_UP_FACTOR; // Set the benchmark for next level (one more extra pillar)
+        _levelUps++; // Set the benchmark for next level (one more extra pillar)
     }
 }
 
-void PillarManager::_recycleFirstPillar() {
-    // Make the item in an array to be equal to the item after it
-    delete _pillars[0]; // Delete first pillar
-    for (int i = 0; i < _amountOfPillarsOnScreen - 1; i++) {
-        _pillars[i] = _pillars[i+1];
+template <class Config>
+void BasicPillarManager<Config>::_recycleFirstPillar() {
+    // Drop the first pillar. The ring buffer only moves its head forward, so the other
+    // pillars stay where they are and the slot gets reused by the next _appendExtraPillar
+    int x = _pillars.front().getX();
+    _pillars.popFront();
+    if (_occupancy != NULL) {
+        // It was still on screen there. The next pillar is further on, so nothing is left in them
+        _occupancy->clearColumns(x, x + Config::PILLAR_WIDTH);
     }
-    // Make sure the last item is deleted
-    _pillars[_amountOfPillarsOnScreen - 1] = NULL; // Set the last existing pillar's pointer to NULL so we don't get two pointers pointing at the same thing.
-
-    // Update the amount of pillars on screen
-    _amountOfPillarsOnScreen--; // One pillar is taken away
 }
 
-void PillarManager::_appendExtraPillar() {
+template <class Config>
+void BasicPillarManager<Config>::_appendExtraPillar() {
 
-    // Add the item that is after the previous existing item with a pillar
-    _pillars[_amountOfPillarsOnScreen] = _newPillarWithHeight(_generateRandomHeight());
-    _amountOfPillarsOnScreen++;
+    // Add the item that is after the previous existing item with a pillar. It is copied
+    // into the next free slot of the ring buffer, which is a no-op if it is already full
+    _pillars.pushBack(_newPillarWithHeight(_generateRandomHeight()));
 }
 
-bool PillarManager::_lastPillarIsFarEnoughToAddNew() {
-    // Create new 2D array for data input
-    // Input the data
-    // _amountOfPillarsOnScreen-1 for the last pillar on screen
-    int **lastPillarInformation = _pillars[_amountOfPillarsOnScreen-1]->returnPillarInformation();
-
+template <class Config>
+bool BasicPillarManager<Config>::_lastPillarIsFarEnoughToAddNew() {
+    // With no pillar on screen there is nothing in the way
+    if (_pillars.isEmpty()) {
+        return true;
+    }
     // Determine if it passes the point or not
-    int lastPillarX = lastPillarInformation[0][0]; // X point
-    int lastPillarWidth = lastPillarInformation[0][2]; // Width
-    int lastPillarXEnd = lastPillarX + lastPillarWidth; // The end of that pillar
-    int maxSpaceItCanBe = _screenWidth - _MIN_PILLAR_BETWEEN_PILLAR_SPACE; // What is the benchmark
+    int lastPillarXEnd = _pillars.back().getXEnd(); // The end of that pillar
+    int maxSpaceItCanBe = Config::SCREEN_WIDTH - _tuning->minPillarBetweenPillarSpace; // What is the benchmark
 
-    // Delete the information since it was created by the new keyword which was used in the returnPillarInformation method
-    for (int i = 0; i < 2; i++) {
-        delete lastPillarInformation[i];
-    }
-    delete[] lastPillarInformation;
     return (lastPillarXEnd < maxSpaceItCanBe); // Return if the last pillar passes the benchmark
 }
 
 
 // ========================= Pillar Construction Methods =======================
 
-int PillarManager::_generateRandomHeight() {
+template <class Config>
+int BasicPillarManager<Config>::_generateRandomHeight() {
+    // The height was drawn a few pillars ago. Draw one more so the lookahead stays full
+    int height = _upcomingHeights.front();
+    _upcomingHeights.popFront();
+    _upcomingHeights.pushBack((uint8_t)_drawHeight());
+    return height;
+}
+
+template <class Config>
+int BasicPillarManager<Config>::_drawHeight() {
     // Random's rnage is from the min height of the pillars to the max height, which is the entire screen height minus the min space required for the bottom pillar minus the space needed for the bird
-    return random(_MIN_HEIGHT_OF_PILLARS, _screenHeight - _MIN_HEIGHT_OF_PILLARS - Pillar::BIRD_SPACE);
+    int min = Config::MIN_HEIGHT_OF_PILLARS;
+    int max = Config::SCREEN_HEIGHT - Config::MIN_HEIGHT_OF_PILLARS - _tuning->birdSpace;
+    return _random.between(min, max); // Same range as random(min, max), without its bias
+}
+
+template <class Config>
+void BasicPillarManager<Config>::_seed(uint64_t seed) {
+    _random.seed(seed);
+    _upcomingHeights.clear();
+    while (!_upcomingHeights.isFull()) {
+        _upcomingHeights.pushBack((uint8_t)_drawHeight());
+    }
+}
+
+template <class Config>
+void BasicPillarManager<Config>::_seedFromRandom() {
+    // random() only promises 31 bits, so the seed is two halves of 16
+    uint32_t high = (uint32_t)random(0x10000);
+    uint32_t low = (uint32_t)random(0x10000);
+    _seed((high << 16) | low);
 }
 
-Pillar *PillarManager::_newPillarWithHeight(int height) {
-    Pillar *nPillar = new Pillar(_screenWidth, _screenHeight, height);
-    return nPillar;
+template <class Config>
+typename BasicPillarManager<Config>::PillarType BasicPillarManager<Config>::_newPillarWithHeight(int height) {
+    return PillarType(height, Config::SCREEN_WIDTH, _tuning->birdSpace); // It starts just off the right side of the screen
 }
 
-void PillarManager::_oneMorePillarPassed() {
+template <class Config>
+void BasicPillarManager<Config>::_oneMorePillarPassed() {
     _amountOfPillarsUserPassed++;
 }
 
-bool PillarManager::_pillarPassed() {
+template <class Config>
+bool BasicPillarManager<Config>::_pillarPassed() {
     bool pillarPassed = false;
 
-    for (int i = 0; i < _amountOfPillarsOnScreen; i++) {
+    for (int i = 0; i < _pillars.size(); i++) {
 
-        // Initialize this 2D array
-        int **pillarInfo = _pillars[i]->returnPillarInformation();
         // Get the point in which the pillar ends at
-        int xPosition = pillarInfo[0][0] + pillarInfo[0][2];
+        int xPosition = _pillars[i].getXEnd();
 
-        if (xPosition == _screenWidth / 2) {
+        if (xPosition == Config::BIRD_X) {
             // If the end of the pillar is smaller than the screen width, it means that it has passed it
             pillarPassed = true;
 
         }
-
-        // Delete pillarInfo since it was created with a new keyword being used in returnPillarInformation method
-        for(int j = 0 ; j < 2 ; j++) {
-            delete pillarInfo[j];
-        }
-        delete[] pillarInfo;
     }
     return pillarPassed;
 }
 
 // Update Delay of the Pillars
 
-void PillarManager::_updateDelaySpeedOfPillars() {
+template <class Config>
+void BasicPillarManager<Config>::_updateDelaySpeedOfPillars() {
+    // One more step. Once it reaches the next entry of the table, that is the delay from now on
+    _steps++;
+    if (_delayIndex + 1 < _tuning->delayCount && _steps >= _tuning->delays[_delayIndex + 1].fromStep) {
+        _delayIndex++;
+    }
+}
+
+// Update the position of the pillars
+
+template <class Config>
+void BasicPillarManager<Config>::_move1Px() {
+    for (int i = 0; i < _pillars.size(); i++) { // Loop through all pillars
+        _pillars[i].changePillars(1); // Shift them to the left by 1 px. Sry about the horrible name
+    }
+    if (_occupancy != NULL) {
+        _occupancy->scroll(_pillars); // Only the column that came in on the right is new
+    }
+}
 
-    if (_currentPillarDelay > _MIN_DELAY_OF_PILLARS) {
-        _currentPillarDelay -= _ACCELERATION_RATE;
+// Physics mode
 
+template <class Config>
+int BasicPillarManager<Config>::_quietStepsAhead() {
+    // With no pillars the next step adds one
+    if (_pillars.isEmpty()) {
+        return 0;
+    }
+    // The first pillar is recycled once it gets to 0, so nothing is further away than that
+    int ahead = _pillars.front().getX();
+    // A pillar waiting for room comes once the last one's right edge is left of the line
+    // _lastPillarIsFarEnoughToAddNew() checks. The same check as _addPillarsIfNeeded()
+    bool isLevelUpWaiting = _levelUps < _tuning->levelUpCount && _amountOfPillarsUserPassed > _tuning->levelUps[_levelUps] && !_pillars.isFull();
+    if (_isGoneButHasntReachedYet || isLevelUpWaiting) {
+        int room = _pillars.back().getXEnd() - (Config::SCREEN_WIDTH - _tuning->minPillarBetweenPillarSpace) + 1;
+        room = (room > 0) ? room : 0;
+        ahead = (room < ahead) ? room : ahead;
+    }
+    // A point comes when a right edge gets to the bird, like _pillarPassed(). Points are
+    // only added up in _moveQuietSteps(), except the one that takes the score past the
+    // next level up, which makes an extra pillar wait for room from then on
+    if (_levelUps < _tuning->levelUpCount && !_pillars.isFull() && !isLevelUpWaiting) {
+        long pointsLeft = (long)_tuning->levelUps[_levelUps] - (long)_amountOfPillarsUserPassed; // That don't
+        // The pillars are in order, so their points come in order too
+        for (int i = 0; i < _pillars.size(); i++) {
+            int pass = _pillars[i].getXEnd() - Config::BIRD_X;
+            if (pass >= 0 && pointsLeft-- == 0) {
+                ahead = (pass < ahead) ? pass : ahead;
+                break;
+            }
+        }
     }
+    return ahead;
 }
 
-// Update the position of the pillars
+template <class Config>
+void BasicPillarManager<Config>::_moveQuietSteps(int steps) {
+    // The same as that many _timeToMove() calls, when _quietStepsAhead() says none of them does anything else
+    _steps += steps;
+    while (_delayIndex + 1 < _tuning->delayCount && _steps >= _tuning->delays[_delayIndex + 1].fromStep) {
+        _delayIndex++; // The table goes up by at least 1 step an entry, so one step never passes two
+    }
+    for (int i = 0; i < _pillars.size(); i++) {
+        int pass = _pillars[i].getXEnd() - Config::BIRD_X;
+        if (pass >= 0 && pass < steps) {
+            _oneMorePillarPassed(); // Its right edge got to the bird on the way
+        }
+        _pillars[i].changePillars(steps);
+    }
+    if (_occupancy != NULL) {
+        _occupancy->scroll(_pillars, steps);
+    }
+}
 
-void PillarManager::_move1Px() {
-    for (int i = 0; i < _amountOfPillarsOnScreen; i++) { // Loop through all pillars
-        _pillars[i]->changePillars(1); // Shift them to the left by 1 px. Sry about the horrible name
+template <class Config>
+int64_t BasicPillarManager<Config>::_stepsWithin(int64_t time, int64_t &timeUsed) {
+    int64_t steps = 0;
+    timeUsed = 0;
+    int index = _delayIndex;
+    uint32_t step = _steps;
+    while (true) {
+        int64_t delay = (int64_t)_tuning->delays[index].delay << _FRACTION_BITS;
+        if (index + 1 < _tuning->delayCount) {
+            // The steps left at this delay, if they all fit
+            int64_t stepsHere = _tuning->delays[index + 1].fromStep - step;
+            if (stepsHere * delay <= time - timeUsed) {
+                steps += stepsHere;
+                timeUsed += stepsHere * delay;
+                step += (uint32_t)stepsHere;
+                index++;
+                continue;
+            }
+        }
+        // The time runs out at this delay
+        int64_t stepsLeft = (time - timeUsed) / delay;
+        timeUsed += stepsLeft * delay;
+        return steps + stepsLeft;
     }
 }
+
+// The configs the game can be built for. Anything else has to be added here
+template class BasicPillarManager<MicroOledConfig>;
+template class BasicPillarManager<LargePanelConfig>;
+template class BasicPillarManager<WidePanelConfig>;
@@ -9,43 +9,97 @@ Original Completion Date: July 13
 #ifndef PILLARMANAGER_H
 #define PILLARMANAGER_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include "pillar.h"
+#include "Random.h" // Where the heights come from
+#include "Occupancy.h" // The pillars' pixels, for the pixel collision
 
-class PillarManager {
+template <class Config>
+class BasicPillarManager {
 
     public:
-        PillarManager(int screenWidth, int screenHeight); // Constructor method
-        Pillar **timeToMove(); // Call this every 20 mil sec
+        typedef BasicPillar<Config> PillarType;
+        typedef typename PillarType::Ring PillarRing; // Holds up to Config::MAX_PILLARS pillars
+        typedef typename Config::Difficulty Difficulty; // The config's delay and level up tables, see Difficulty.h
+
+        static const int HEIGHT_LOOKAHEAD = 4; // Heights of the pillars to come that are already drawn
+
+        // Everything that changes while the game runs, packed as small as it goes. The pillars
+        // are listed from left to right. A GameSnapshot (see Autopilot.h) keeps one of these
+        struct State {
+            uint64_t randomState;
+            uint32_t steps; // 1 px steps since the round started
+            int32_t timeSinceLastStep; // Less than one step, so it fits in 32 bits
+            uint32_t pillarsPassed;
+            uint8_t delayIndex; // The entry of the delay table the pillars are at
+            uint8_t levelUps; // Extra pairs of pillars added so far
+            bool isGoneButHasntReachedYet;
+            bool isSeeded;
+            uint8_t upcomingHeights[HEIGHT_LOOKAHEAD]; // The next one first
+            uint8_t pillarCount;
+            int16_t pillarX[Config::MAX_PILLARS];
+            uint8_t pillarHeight[Config::MAX_PILLARS];
+        };
+
+        // Constructor method. The screen size comes from the config, and the gap, the spacing
+        // and the difficulty tables from the tuning, which has to outlive the manager (see GameConfig.h)
+        explicit BasicPillarManager(const GameTuning &tuning = DefaultTuning<Config>::TUNING);
+        // Carries on from a saved state. Unlike the one above, it never calls random()
+        explicit BasicPillarManager(const State &state, const GameTuning &tuning = DefaultTuning<Config>::TUNING);
+        const PillarRing &timeToMove(); // Call this every 20 mil sec
+
+        // Physics mode, instead of timeToMove(). Does all the 1 px steps that fit in the time
+        // that went by and keeps the time left over for next time. Read the notes at PillarManager.cpp
+        const PillarRing &advance(unsigned long milliseconds);
         void reset(); // Restart the game
 
+        // From now on the heights come from this seed, so the same seed always gives the same
+        // pillars, on any board. Without it every round takes a new seed from random(). Call
+        // reset() after it to start over
+        void seedRandom(uint32_t seed);
+
+        // Keep this occupancy up to date as the pillars move, for the pixel collision (see
+        // Occupancy.h). It is the caller's, and has to outlive the manager or be taken back
+        // with NULL, which is how it starts. A copy of the manager keeps the same one
+        void trackOccupancy(BasicOccupancy<Config> *occupancy);
+
         // Getter methods
-        float getDelay();
+        int getDelay(); // Whole ms, from the difficulty table
+        int getUpcomingHeight(int i); // The gap top of the i-th pillar still to come, below HEIGHT_LOOKAHEAD
+        uint32_t getSteps(); // 1 px steps since the round started
+        const PillarRing &getPillars();
         int getCurrentAmountOfPillarsOnScreen();
         int getAmountOfPillarsUserPassed();
 
+        // Saving and restoring. setState(getState()) changes nothing
+        State getState() const;
+        void setState(const State &state);
+
     private:
 
-        // ==================== Constants ======================
-        static const int _MAX_AMOUNT_OF_PILLARS_ON_SCREEN = 3;
-        const int _BIRD_SPACE = Pillar::BIRD_SPACE;
-        const int _DEFAULT_AMOUNT_OF_PILLARS_ON_SCREEN = 0;
-        const int _DEFAULT_DELAY_OF_PILLARS = 30;
-        const int _PILLARS_PASSED_TO_LEVEL_UP_FACTOR = 2;
-        const int _PILLARS_PASSED_TO_LEVEL_UP_STARTING_POINT = 6;
-        const int _MIN_PILLAR_BETWEEN_PILLAR_SPACE = 15;
-        const int _MIN_HEIGHT_OF_PILLARS = 4;
-        const float _MIN_DELAY_OF_PILLARS = 12.0;
-        const float _ACCELERATION_RATE = 0.005;
+        // The constants (delays, spaces, when to level up) are in the tuning. The config's
+        // own tables are checked here, and a sweep checks the ones it makes (see GameTuning::problem())
 
+        static_assert(Difficulty::DELAY_COUNT >= 1 && Difficulty::DELAY_COUNT <= 255, "The delay table needs 1 to 255 entries");
+        static_assert(isDelayTableValid<Difficulty>(), "The delay table has to start at step 0 and go up");
 
         // =================== Variables ======================
-        int _screenWidth;
-        int _screenHeight;
-        int _amountOfPillarsOnScreen;
-        int _pillarsPassedToLevelUp;
+        const GameTuning *_tuning;
         unsigned int _amountOfPillarsUserPassed;
-        float _currentPillarDelay;
-        Pillar *_pillars[_MAX_AMOUNT_OF_PILLARS_ON_SCREEN]; // All the pillars
+        uint32_t _steps; // 1 px steps since the round started, which is what the delay table goes by
+        int _delayIndex; // _tuning->delays[_delayIndex] is the delay now
+        int _levelUps; // _tuning->levelUps[_levelUps] is the score for the next extra pair
+        bool _isGoneButHasntReachedYet; // The first pillar left but there was no room for a new one yet
+        bool _isSeeded; // seedRandom() was called, so reset() doesn't take a new seed
+        Pcg32 _random;
+        RingBuffer<uint8_t, HEIGHT_LOOKAHEAD> _upcomingHeights; // Always full, so the next pillars are known ahead
+
+        // Physics mode. Time in ms with 16 bits after the point
+        static const int _FRACTION_BITS = 16;
+        int64_t _timeSinceLastStep; // How far into the wait for the next 1 px step we are
+        PillarRing _pillars; // All the pillars, stored in place so no pillar is ever created with new
+        BasicOccupancy<Config> *_occupancy; // NULL unless trackOccupancy() was given one. Most managers, like the autopilot's, never are
 
 
 
@@ -68,8 +122,11 @@ class PillarManager {
         bool _lastPillarIsFarEnoughToAddNew();
 
         // Pillar construction methods
-        int _generateRandomHeight();
-        Pillar *_newPillarWithHeight(int height);
+        int _generateRandomHeight(); // Takes the next height from _upcomingHeights and draws one more behind it
+        int _drawHeight();
+        void _seed(uint64_t seed); // Starts _random over and fills _upcomingHeights from it
+        void _seedFromRandom(); // The same, with a seed from random()
+        PillarType _newPillarWithHeight(int height);
 
         // 2. Update amount of pillars user passed
         void _oneMorePillarPassed();
@@ -80,7 +137,14 @@ class PillarManager {
 
         // 4. Update the position of the pillars
         void _move1Px();
+
+        // Physics mode: how many steps fit in the time, and how much of it they take
+        int64_t _stepsWithin(int64_t time, int64_t &timeUsed);
+        int _quietStepsAhead(); // Steps from now that only move the pillars, before anything else happens
+        void _moveQuietSteps(int steps); // Does that many of them at once
 };
 
+// The 64x48 one the game uses
+typedef BasicPillarManager<DefaultGameConfig> PillarManager;
 
 #endif
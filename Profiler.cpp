@@ -0,0 +1,269 @@
+/******************************************************************************
+Profiler.cpp
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+#include "Profiler.h"
+
+#ifdef FLAPPY_PROFILE
+
+#include <string.h>
+#ifdef FLAPPY_HOST
+#include <time.h>
+#else
+#include "application.h" // Serial
+#endif
+
+// The cycle counter is part of the Cortex-M3's debug unit (DWT). It is off after a reset
+#define PROFILER_DEMCR (*(volatile uint32_t *)0xE000EDFC) // Debug control, bit 24 turns the DWT on
+#define PROFILER_DWT_CONTROL (*(volatile uint32_t *)0xE0001000) // Bit 0 starts the counter
+#define PROFILER_DWT_CYCLES (*(volatile uint32_t *)0xE0001004)
+
+static const char *STAGE_NAMES[PROFILE_STAGES] = {
+    "pillars", "drawpill", "bird", "drawbird", "crash", "hud", "flush", "input", "plan"
+};
+
+Profiler::StageStats Profiler::_stages[PROFILE_STAGES];
+Profiler::TaskStats Profiler::_tasks[MAX_TASKS];
+int Profiler::_pauses = 0;
+uint8_t Profiler::_dump[_DUMP_SIZE];
+int Profiler::_dumpLength = 0;
+int Profiler::_dumpSent = 0;
+unsigned long Profiler::_lastDumpTime = 0;
+unsigned long Profiler::_dumpsSent = 0;
+
+#ifdef FLAPPY_HOST
+static FILE *dumpFile = NULL;
+static int dumpBytesPerPump = 64;
+#endif
+
+// ================================ Public Methods ================================
+
+void Profiler::begin() {
+#ifndef FLAPPY_HOST
+    PROFILER_DEMCR |= (1UL << 24);
+    PROFILER_DWT_CYCLES = 0;
+    PROFILER_DWT_CONTROL |= 1UL;
+    Serial.begin(9600); // USB serial, so the speed doesn't matter
+#endif
+    reset();
+}
+
+uint32_t Profiler::now() {
+#ifdef FLAPPY_HOST
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    // Cut down to 32 bits like the cycle counter. Differences still come out right across the wrap
+    return (uint32_t)((uint64_t)time.tv_sec * 1000000000ULL + time.tv_nsec);
+#else
+    return PROFILER_DWT_CYCLES;
+#endif
+}
+
+uint32_t Profiler::getTicksPerSecond() {
+#ifdef FLAPPY_HOST
+    return 1000000000UL;
+#else
+    return 120000000UL; // The Photon's STM32F205 runs at 120 MHz
+#endif
+}
+
+void Profiler::record(ProfileStage stage, uint32_t ticks) {
+    if (_pauses > 0) {
+        return;
+    }
+    StageStats &stats = _stages[stage];
+    stats.count++;
+    stats.totalTicks += ticks;
+    if (ticks > stats.maxTicks) {
+        stats.maxTicks = ticks;
+    }
+    stats.buckets[_bucketOf(ticks)]++;
+}
+
+void Profiler::pause() {
+    _pauses++;
+}
+
+void Profiler::resume() {
+    if (_pauses > 0) {
+        _pauses--;
+    }
+}
+
+void Profiler::recordLateness(int task, const char *name, unsigned long lateness) {
+    if (task < 0 || task >= MAX_TASKS) {
+        return;
+    }
+    TaskStats &stats = _tasks[task];
+    stats.name = name;
+    stats.runs++;
+    if (lateness > 0) {
+        stats.misses++;
+    }
+    uint32_t late = (uint32_t)lateness;
+    if (late > stats.maxLateness) {
+        stats.maxLateness = late;
+    }
+    stats.buckets[_bucketOf(late)]++;
+}
+
+void Profiler::pump(unsigned long nowMs) {
+    // Start a new dump once the last one is all out and it is time
+    if (_dumpSent == _dumpLength && nowMs - _lastDumpTime >= DUMP_PERIOD) {
+        _lastDumpTime = nowMs;
+        _takeSnapshot(nowMs);
+    }
+
+    // Only send what fits. The rest goes out on the next loops
+    int left = _dumpLength - _dumpSent;
+    if (left == 0) {
+        return;
+    }
+    int room = _sinkRoom();
+    int chunk = (left < room) ? left : room;
+    if (chunk <= 0) {
+        return;
+    }
+    _sinkWrite(_dump + _dumpSent, chunk);
+    _dumpSent += chunk;
+    if (_dumpSent == _dumpLength) {
+        _dumpsSent++;
+    }
+}
+
+void Profiler::reset() {
+    memset(_stages, 0, sizeof(_stages));
+    memset(_tasks, 0, sizeof(_tasks));
+}
+
+#ifdef FLAPPY_HOST
+void Profiler::setDumpFile(FILE *file, int bytesPerPump) {
+    dumpFile = file;
+    dumpBytesPerPump = bytesPerPump;
+}
+#endif
+
+// ============================ Getter methods =============================
+
+uint32_t Profiler::getCount(ProfileStage stage) {
+    return _stages[stage].count;
+}
+
+uint32_t Profiler::getMaxTicks(ProfileStage stage) {
+    return _stages[stage].maxTicks;
+}
+
+uint64_t Profiler::getTotalTicks(ProfileStage stage) {
+    return _stages[stage].totalTicks;
+}
+
+uint32_t Profiler::getMisses(int task) {
+    return (task >= 0 && task < MAX_TASKS) ? _tasks[task].misses : 0;
+}
+
+unsigned long Profiler::getDumpsSent() {
+    return _dumpsSent;
+}
+
+// ================================ Private Methods ================================
+
+int Profiler::_bucketOf(uint32_t value) {
+    // 0 goes in bucket 0, and everything else in 1 + the number of its highest bit
+    return (value == 0) ? 0 : 32 - __builtin_clz(value);
+}
+
+/*******************************
+* * Dump layout * *
+* Everything is little endian, like both the Photon and a PC.
+*
+*   "FPRF", version (1 byte), stages, tasks, buckets (1 byte each)
+*   ticks per second (4 bytes), millis() when it was taken (4), length of the whole dump (4)
+*   then for each stage: name (8 bytes, 0 padded), count (4), max ticks (4), total ticks (8), buckets (4 each)
+*   then for each task:  name (8 bytes, 0 padded), runs (4), misses (4), max lateness in ms (4), buckets (4 each)
+*
+* A reader that lost its place can look for "FPRF" and check the length.
+******************************/
+
+static uint8_t *put8(uint8_t *out, uint8_t value) {
+    *out = value;
+    return out + 1;
+}
+
+static uint8_t *put32(uint8_t *out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+    return out + 4;
+}
+
+static uint8_t *put64(uint8_t *out, uint64_t value) {
+    out = put32(out, (uint32_t)value);
+    return put32(out, (uint32_t)(value >> 32));
+}
+
+static uint8_t *putName(uint8_t *out, const char *name, int length) {
+    memset(out, 0, length);
+    if (name != NULL) {
+        strncpy((char *)out, name, length);
+    }
+    return out + length;
+}
+
+void Profiler::_takeSnapshot(unsigned long nowMs) {
+    uint8_t *out = _dump;
+    out = put8(out, 'F');
+    out = put8(out, 'P');
+    out = put8(out, 'R');
+    out = put8(out, 'F');
+    out = put8(out, 1);
+    out = put8(out, PROFILE_STAGES);
+    out = put8(out, MAX_TASKS);
+    out = put8(out, BUCKETS);
+    out = put32(out, getTicksPerSecond());
+    out = put32(out, (uint32_t)nowMs);
+    out = put32(out, _DUMP_SIZE);
+
+    for (int stage = 0; stage < PROFILE_STAGES; stage++) {
+        const StageStats &stats = _stages[stage];
+        out = putName(out, STAGE_NAMES[stage], NAME_LENGTH);
+        out = put32(out, stats.count);
+        out = put32(out, stats.maxTicks);
+        out = put64(out, stats.totalTicks);
+        for (int b = 0; b < BUCKETS; b++) {
+            out = put32(out, stats.buckets[b]);
+        }
+    }
+    for (int task = 0; task < MAX_TASKS; task++) {
+        const TaskStats &stats = _tasks[task];
+        out = putName(out, stats.name, NAME_LENGTH);
+        out = put32(out, stats.runs);
+        out = put32(out, stats.misses);
+        out = put32(out, stats.maxLateness);
+        for (int b = 0; b < BUCKETS; b++) {
+            out = put32(out, stats.buckets[b]);
+        }
+    }
+
+    _dumpLength = out - _dump;
+    _dumpSent = 0;
+}
+
+int Profiler::_sinkRoom() {
+#ifdef FLAPPY_HOST
+    return (dumpFile != NULL) ? dumpBytesPerPump : 0;
+#else
+    return Serial.availableForWrite();
+#endif
+}
+
+void Profiler::_sinkWrite(const uint8_t *bytes, int length) {
+#ifdef FLAPPY_HOST
+    fwrite(bytes, 1, length, dumpFile);
+#else
+    Serial.write(bytes, length);
+#endif
+}
+
+#endif
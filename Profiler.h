@@ -0,0 +1,175 @@
+/******************************************************************************
+Profiler.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Where does a frame's time go? * *
+* Moving the pillars, drawing them, the HUD, sending the screen, the crash check and
+* reading the button all happen between two deadlines, and if they take too long the
+* next step runs late and the animation stutters. This measures each of those stages.
+*
+* Each stage puts FLAPPY_PROFILE_SCOPE(stage) at the top of the function that does it.
+* That starts a timer, and when the function returns the time goes into the stage's
+* histogram. The timer is the CPU's own cycle counter (DWT on the Photon, so 1 tick is
+* 1/120 of a microsecond), or clock_gettime() in nanoseconds on the host.
+*
+* The histograms are log2 ones: bucket b counts the times that were at least 2^(b-1)
+* and less than 2^b ticks (bucket 0 is exactly 0). That is 32 numbers per stage no
+* matter how long the game runs, and still shows if a stage is usually fast but
+* sometimes slow. The scheduler also records how late each task ran against its
+* deadline, in ms, with a miss being anything later than 0.
+*
+* Every few seconds loop() takes a copy of everything as bytes and sends it out a bit
+* at a time, only as much as fits in Serial's buffer right now, so it never waits. On
+* the host it goes into a file, and `flappyhost profile` reads it back. The layout is
+* at the bottom of Profiler.cpp.
+*
+* It is all off unless FLAPPY_PROFILE is defined. Otherwise the macros are empty
+* and Profiler.cpp compiles to nothing, so the game is exactly what it was.
+******************************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// #define FLAPPY_PROFILE // Uncomment to measure the game on the Photon. The host uses `make PROFILE=1`
+
+#ifdef FLAPPY_PROFILE
+
+#include <stdint.h>
+#include <stdio.h>
+
+// The parts of a frame that get timed
+enum ProfileStage {
+    PROFILE_PILLAR_STEP, // PillarManager::timeToMove() and advance()
+    PROFILE_DRAW_PILLARS, // CourseRenderer::draw()
+    PROFILE_BIRD_STEP, // Bird::userInput() and advance()
+    PROFILE_DRAW_BIRD,
+    PROFILE_CRASH_CHECK, // Bird::birdCrashed()
+    PROFILE_HUD, // The scores
+    PROFILE_FLUSH, // Handing the frame to the screen, which used to be oled.display(). With DMA it doesn't wait for the bus
+    PROFILE_INPUT, // Reading the button and setting the bird's next deadline
+    PROFILE_PLAN, // Autopilot::decide(). The steps it plays don't count towards the stages above
+    PROFILE_STAGES // How many there are
+};
+
+class Profiler {
+
+    public:
+
+        static const int BUCKETS = 32; // One for every bit of a 32 bit time
+        static const int MAX_TASKS = 8; // Same as Scheduler::MAX_TASKS
+        static const int NAME_LENGTH = 8; // Names are cut to this in the dump
+        static const unsigned long DUMP_PERIOD = 5000; // ms between dumps
+
+        static void begin(); // Starts the cycle counter. Call it once, before anything is timed
+        static uint32_t now(); // Ticks. Only the difference between two of these means anything
+        static uint32_t getTicksPerSecond();
+
+        static void record(ProfileStage stage, uint32_t ticks);
+        static void recordLateness(int task, const char *name, unsigned long lateness);
+
+        // While paused, record() drops everything. Calls nest, so only the last resume() counts
+        static void pause();
+        static void resume();
+
+        // Call this every loop(). Starts a new dump every DUMP_PERIOD, and sends as much of
+        // the one in progress as there is room for without waiting
+        static void pump(unsigned long nowMs);
+
+        static void reset(); // Forget everything measured so far
+
+        // Getter methods
+        static uint32_t getCount(ProfileStage stage);
+        static uint32_t getMaxTicks(ProfileStage stage);
+        static uint64_t getTotalTicks(ProfileStage stage);
+        static uint32_t getMisses(int task);
+        static unsigned long getDumpsSent();
+
+#ifdef FLAPPY_HOST
+        // Where the dumps go on the host, and how many bytes a pump() may write, like the
+        // room in the Photon's USB serial buffer. NULL to stop dumping
+        static void setDumpFile(FILE *file, int bytesPerPump);
+#endif
+
+    private:
+
+        struct StageStats {
+            uint32_t count;
+            uint32_t maxTicks;
+            uint64_t totalTicks;
+            uint32_t buckets[BUCKETS];
+        };
+
+        struct TaskStats {
+            const char *name;
+            uint32_t runs;
+            uint32_t misses;
+            uint32_t maxLateness;
+            uint32_t buckets[BUCKETS];
+        };
+
+        // magic, version, counts, ticks per second, time and length, then the stages and the tasks
+        static const int _HEADER_SIZE = 4 + 4 + 4 + 4 + 4;
+        static const int _STAGE_SIZE = NAME_LENGTH + 4 + 4 + 8 + 4 * BUCKETS;
+        static const int _TASK_SIZE = NAME_LENGTH + 4 + 4 + 4 + 4 * BUCKETS;
+        static const int _DUMP_SIZE = _HEADER_SIZE + PROFILE_STAGES * _STAGE_SIZE + MAX_TASKS * _TASK_SIZE;
+
+        static StageStats _stages[PROFILE_STAGES];
+        static TaskStats _tasks[MAX_TASKS];
+        static int _pauses; // pause()s not resumed yet
+
+        static uint8_t _dump[_DUMP_SIZE]; // The copy being sent
+        static int _dumpLength;
+        static int _dumpSent;
+        static unsigned long _lastDumpTime;
+        static unsigned long _dumpsSent;
+
+        static int _bucketOf(uint32_t value);
+        static void _takeSnapshot(unsigned long nowMs);
+        static int _sinkRoom(); // Bytes the output can take right now without waiting
+        static void _sinkWrite(const uint8_t *bytes, int length);
+};
+
+// Times from where it is made to the end of the scope it is in
+class ProfileScope {
+
+    public:
+
+        explicit ProfileScope(ProfileStage stage) : _stage(stage), _start(Profiler::now()) {}
+        ~ProfileScope() { Profiler::record(_stage, Profiler::now() - _start); }
+
+    private:
+
+        ProfileStage _stage;
+        uint32_t _start;
+};
+
+// Nothing is recorded from where it is made to the end of the scope it is in
+class ProfilePause {
+
+    public:
+
+        ProfilePause() { Profiler::pause(); }
+        ~ProfilePause() { Profiler::resume(); }
+};
+
+#define FLAPPY_PROFILE_SCOPE(stage) ProfileScope _profileScope(stage)
+#define FLAPPY_PROFILE_PAUSE() ProfilePause _profilePause
+#define FLAPPY_PROFILE_LATENESS(task, name, lateness) Profiler::recordLateness(task, name, lateness)
+#define FLAPPY_PROFILE_BEGIN() Profiler::begin()
+#define FLAPPY_PROFILE_PUMP(nowMs) Profiler::pump(nowMs)
+
+#else
+
+// Compiled out: nothing is left of any of these
+#define FLAPPY_PROFILE_SCOPE(stage)
+#define FLAPPY_PROFILE_PAUSE()
+#define FLAPPY_PROFILE_LATENESS(task, name, lateness)
+#define FLAPPY_PROFILE_BEGIN()
+#define FLAPPY_PROFILE_PUMP(nowMs)
+
+#endif
+
+#endif
@@ -0,0 +1,84 @@
+/******************************************************************************
+Random.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Random numbers * *
+* The pillar heights used to come from random(min, max), which is a different
+* generator on the Photon and on a computer, and which is min + value % (max - min).
+* The % makes some heights come up more often than others, because 2^32 doesn't
+* split evenly into (max - min) piles.
+*
+* Pcg32 is the PCG generator (pcg-random.org): a 64 bit number that goes up by a
+* multiply and an add, and 32 bits shuffled out of it by a shift and a rotate. It
+* is 8 bytes, a handful of instructions, and gives the same numbers on any board.
+*
+* below(n) is Lemire's way of getting a number under n without the bias: multiply
+* the 32 random bits by n and keep the top 32 bits of the 64 bit answer. The few
+* values that would make some answers more likely than others are thrown away and
+* drawn again, which happens less than once in a million draws for pillar heights.
+******************************/
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <stdint.h>
+
+class Pcg32 {
+
+    public:
+
+        Pcg32() : _state(0) {}
+        explicit Pcg32(uint64_t value) { seed(value); }
+
+        // The same seed always gives the same numbers
+        void seed(uint64_t value) {
+            _state = 0;
+            next();
+            _state += value;
+            next();
+        }
+
+        // 32 random bits
+        uint32_t next() {
+            uint64_t old = _state;
+            _state = old * _MULTIPLIER + _INCREMENT;
+            uint32_t shuffled = (uint32_t)(((old >> 18) ^ old) >> 27);
+            uint32_t rotation = (uint32_t)(old >> 59);
+            return (shuffled >> rotation) | (shuffled << ((-rotation) & 31));
+        }
+
+        // A number from 0 up to but not including bound, every one as likely as the others
+        uint32_t below(uint32_t bound) {
+            uint64_t product = (uint64_t)next() * bound;
+            uint32_t low = (uint32_t)product;
+            if (low < bound) {
+                uint32_t threshold = (0u - bound) % bound; // 2^32 % bound, the values that would be extra
+                while (low < threshold) {
+                    product = (uint64_t)next() * bound;
+                    low = (uint32_t)product;
+                }
+            }
+            return (uint32_t)(product >> 32);
+        }
+
+        // min is included, max is not, like random(min, max)
+        int32_t between(int32_t min, int32_t max) {
+            return (min >= max) ? min : min + (int32_t)below((uint32_t)(max - min));
+        }
+
+        // For saving and restoring. setState(getState()) changes nothing
+        uint64_t getState() const { return _state; }
+        void setState(uint64_t state) { _state = state; }
+
+    private:
+
+        static const uint64_t _MULTIPLIER = 6364136223846793005ULL;
+        static const uint64_t _INCREMENT = 1442695040888963407ULL; // Any odd number. This is PCG's own default
+
+        uint64_t _state;
+};
+
+#endif
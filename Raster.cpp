@@ -0,0 +1,180 @@
+/******************************************************************************
+Raster.cpp
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+#include "Raster.h"
+#include <string.h>
+
+static const uint64_t EVERY_BYTE = 0x0101010101010101ULL; // Times a byte, that byte in all 8
+
+// ================================ Public Methods ================================
+
+Raster::Raster(uint8_t *buffer, int width, int height) {
+    _buffer = buffer;
+    _width = width;
+    _height = (height > MAX_HEIGHT) ? MAX_HEIGHT : height;
+    _pages = _height / 8;
+    _forgetDrawn();
+}
+
+void Raster::clear() {
+    memset(_buffer, 0, _width * _pages);
+    _forgetDrawn();
+}
+
+void Raster::clearDrawn() {
+    for (int page = 0; page < _pages; page++) {
+        if (_drawnFrom[page] < _drawnTo[page]) {
+            memset(_buffer + page * _width + _drawnFrom[page], 0, _drawnTo[page] - _drawnFrom[page]);
+        }
+    }
+    _forgetDrawn();
+}
+
+void Raster::rect(int x, int y, int width, int height, bool white) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    // The top and the bottom row, then the two sides between them. The library draws the
+    // same 4 lines, with the sides left out when there is no room between the rows
+    fillRect(x, y, width, 1, white);
+    fillRect(x, y + height - 1, width, 1, white);
+    _column(x, y + 1, y + height - 1, white);
+    _column(x + width - 1, y + 1, y + height - 1, white);
+}
+
+void Raster::fillRect(int x, int y, int width, int height, bool white) {
+    // Cut it down to the buffer
+    int left = (x < 0) ? 0 : x;
+    int right = (x + width > _width) ? _width : x + width;
+    int top = (y < 0) ? 0 : y;
+    int bottom = (y + height > _height) ? _height : y + height;
+    if (left >= right || top >= bottom) {
+        return;
+    }
+
+    // Each page it covers is one run of bytes with the same mask
+    for (int page = top / 8; page * 8 < bottom; page++) {
+        int firstRow = (top > page * 8) ? top - page * 8 : 0;
+        int lastRow = (bottom < page * 8 + 8) ? bottom - page * 8 : 8; // Not included
+        uint8_t mask = (uint8_t)((0xFF << firstRow) & (0xFF >> (8 - lastRow)));
+        _span(page, left, right, (uint8_t)~mask, white ? mask : 0);
+    }
+}
+
+void Raster::blit(const Sprite &sprite, int x, int y, bool opaque) {
+    if (y <= -sprite.height || y >= _height || sprite.height > 8) {
+        return; // Nothing of it is on screen, or it isn't a sprite the atlas makes
+    }
+    int first = (x < 0) ? -x : 0; // The first and the last (not included) column of the sprite that are on screen
+    int last = (x + sprite.width > _width) ? _width - x : sprite.width;
+    if (first >= last) {
+        return;
+    }
+
+    // Which pixels of a column belong to the sprite. Only opaque sprites clear the rest of them
+    uint8_t heightMask = opaque ? (uint8_t)(0xFF >> (8 - sprite.height)) : 0;
+
+    // A column of the sprite lands on 2 pages, unless it happens to line up with one. Above
+    // the screen, the part that is left is shifted up into page 0 instead
+    int page = (y < 0) ? 0 : y / 8;
+    int up = (y < 0) ? -y : 0;
+    int down = (y < 0) ? 0 : y % 8;
+
+    for (int part = 0; part < 2; part++) {
+        int target = page + part;
+        if (target >= _pages || (part == 1 && down == 0)) {
+            break;
+        }
+        // Shifting a whole word moves bits into the next column's byte, so they are masked off
+        int shiftLeft = (part == 0) ? down : 0;
+        int shiftRight = (part == 0) ? up : 8 - down;
+        uint8_t byteMask = (uint8_t)(((0xFF >> shiftRight) << shiftLeft) & 0xFF);
+        uint64_t wordMask = byteMask * EVERY_BYTE;
+        uint8_t keep = (uint8_t)~(((heightMask >> shiftRight) << shiftLeft) & 0xFF);
+        uint64_t keepWord = keep * EVERY_BYTE;
+
+        const uint8_t *from = sprite.columns + first;
+        uint8_t *to = _buffer + target * _width + x + first;
+        int count = last - first;
+        for (; count >= 8; count -= 8, from += 8, to += 8) {
+            uint64_t bits, screen;
+            memcpy(&bits, from, 8);
+            memcpy(&screen, to, 8);
+            bits = ((bits >> shiftRight) << shiftLeft) & wordMask;
+            screen = (screen & keepWord) | bits;
+            memcpy(to, &screen, 8);
+        }
+        for (; count > 0; count--, from++, to++) {
+            uint8_t bits = (uint8_t)(((*from >> shiftRight) << shiftLeft) & 0xFF);
+            *to = (*to & keep) | bits;
+        }
+        _markDrawn(target, x + first, x + last);
+    }
+}
+
+// ============================ Getter methods =============================
+
+uint8_t *Raster::getBuffer() {
+    return _buffer;
+}
+
+int Raster::getWidth() {
+    return _width;
+}
+
+int Raster::getHeight() {
+    return _height;
+}
+
+// ================== Private Methods ============================
+
+void Raster::_span(int page, int from, int to, uint8_t keep, uint8_t bits) {
+    uint8_t *byte = _buffer + page * _width + from;
+    int count = to - from;
+
+    // 8 columns at a time, then 4, then the rest. memcpy lets the words start on any byte
+    uint64_t keepWord = keep * EVERY_BYTE;
+    uint64_t bitsWord = bits * EVERY_BYTE;
+    for (; count >= 8; count -= 8, byte += 8) {
+        uint64_t word;
+        memcpy(&word, byte, 8);
+        word = (word & keepWord) | bitsWord;
+        memcpy(byte, &word, 8);
+    }
+    if (count >= 4) {
+        uint32_t word;
+        memcpy(&word, byte, 4);
+        word = (word & (uint32_t)keepWord) | (uint32_t)bitsWord;
+        memcpy(byte, &word, 4);
+        count -= 4;
+        byte += 4;
+    }
+    for (; count > 0; count--, byte++) {
+        *byte = (*byte & keep) | bits;
+    }
+    _markDrawn(page, from, to);
+}
+
+void Raster::_column(int x, int top, int bottom, bool white) {
+    // A column 1 px wide is a filled rect too, one byte per page
+    fillRect(x, top, 1, bottom - top, white);
+}
+
+void Raster::_markDrawn(int page, int from, int to) {
+    if (from < _drawnFrom[page]) {
+        _drawnFrom[page] = (int16_t)from;
+    }
+    if (to > _drawnTo[page]) {
+        _drawnTo[page] = (int16_t)to;
+    }
+}
+
+void Raster::_forgetDrawn() {
+    for (int page = 0; page < _MAX_PAGES; page++) {
+        _drawnFrom[page] = INT16_MAX;
+        _drawnTo[page] = 0;
+    }
+}
@@ -0,0 +1,94 @@
+/******************************************************************************
+Raster.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Drawing a whole word at a time * *
+* oled.rect() draws each side as a line, and a line is one pixel() call per pixel:
+* work out the byte, work out the bit, set it. Six pillar outlines a frame is a few
+* hundred of those, after oled.clear(PAGE) wiped all 384 bytes.
+*
+* The screen buffer is page major: page p holds rows 8p to 8p + 7, one byte per
+* column, the lowest bit at the top. So a horizontal run of pixels in one page is
+* a run of bytes next to each other that all get the same bit mask. Raster writes
+* those runs 8 bytes (64 bits) at a time, then 4, then one at a time for the end:
+*
+*     byte = (byte & keep) | bits    with keep and bits copied into every byte
+*
+* A rect outline is two of those runs and two columns, a filled rect is one run for
+* every page it covers, and a sprite (see SpriteAtlas.h) is shifted down into the 2
+* pages it lands on for 8 columns at once, then ORed in.
+*
+* Raster also remembers which columns of each page it drew into since the last
+* clear(), so clearDrawn() only wipes those instead of the whole buffer. That only
+* works if everything on screen since clear() came through Raster. After drawing
+* with the library (print(), drawChar()...) call clear() again.
+*
+* The pixels are the same ones the library draws. `flappyhost raster-verify` checks
+* that against the pixel() way and against frames of whole games.
+******************************/
+
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <stdint.h>
+
+// A picture to blit. It doesn't own its bytes, they belong to the atlas or a NumberText.
+// Stored like the screen: one byte per column, the lowest bit is the top pixel, so a
+// picture can be at most 8 pixels tall
+struct Sprite {
+    const uint8_t *columns;
+    uint8_t width;
+    uint8_t height;
+};
+
+class Raster {
+
+    public:
+
+        static const int MAX_HEIGHT = 256; // Up to 32 pages
+
+        // Draws into a page major buffer of width * height / 8 bytes, which it doesn't own
+        Raster(uint8_t *buffer, int width, int height);
+
+        void clear(); // The whole buffer, like oled.clear(PAGE)
+        void clearDrawn(); // Only the columns drawn into since the last clear
+
+        // Same pixels as oled.rect() and oled.rectFill(). Anything off the buffer is cut off.
+        // white false clears the pixels instead
+        void rect(int x, int y, int width, int height, bool white = true);
+        void fillRect(int x, int y, int width, int height, bool white = true);
+
+        // Copies a sprite in with its top left corner at x, y. Opaque sprites also clear
+        // their dark pixels, like text does; the others only light pixels up
+        void blit(const Sprite &sprite, int x, int y, bool opaque);
+
+        // Getter methods
+        uint8_t *getBuffer();
+        int getWidth();
+        int getHeight();
+
+    private:
+
+        static const int _MAX_PAGES = MAX_HEIGHT / 8;
+
+        uint8_t *_buffer;
+        int _width;
+        int _height;
+        int _pages;
+
+        // The columns of each page drawn into since the last clear, from and to (not included)
+        int16_t _drawnFrom[_MAX_PAGES];
+        int16_t _drawnTo[_MAX_PAGES];
+
+        // byte = (byte & keep) | bits for the columns from and to (not included) of one page
+        void _span(int page, int from, int to, uint8_t keep, uint8_t bits);
+        // The same for the rows top to bottom (not included) of one column
+        void _column(int x, int top, int bottom, bool white);
+        void _markDrawn(int page, int from, int to);
+        void _forgetDrawn();
+};
+
+#endif
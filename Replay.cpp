@@ -0,0 +1,226 @@
+/******************************************************************************
+Replay.cpp
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+#include "Replay.h"
+#include <string.h>
+
+// ================================ Replay ================================
+
+uint32_t Replay::hashStep(uint32_t hash, int32_t value) {
+    for (int i = 0; i < 4; i++) {
+        hash ^= (uint8_t)(value >> (8 * i));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// ================================ ReplayRecorder ================================
+
+ReplayRecorder::ReplayRecorder() {
+    _length = 0;
+    _lastEventTime = 0;
+    _lastPressed = false;
+    _finished = false;
+}
+
+void ReplayRecorder::start(uint32_t seed, uint32_t configHash, uint8_t mode) {
+    memcpy(_bytes, "FRPL", 4);
+    _bytes[4] = Replay::VERSION;
+    _bytes[5] = mode;
+    _bytes[6] = 0; // Flags
+    _bytes[7] = 0;
+    for (int i = 0; i < 4; i++) {
+        _bytes[8 + i] = (uint8_t)(configHash >> (8 * i));
+        _bytes[12 + i] = (uint8_t)(seed >> (8 * i));
+    }
+    _length = Replay::HEADER_SIZE;
+    _lastEventTime = 0;
+    _lastPressed = false; // The player starts from a button that isn't pressed too
+    _finished = false;
+}
+
+void ReplayRecorder::sample(unsigned long gameTime, bool pressed) {
+    if (_finished || pressed == _lastPressed || (_bytes[6] & Replay::FLAG_TRUNCATED)) {
+        return;
+    }
+    // The end is kept free for the crash, so even a replay that ran out of room says how the game ended
+    if (_length + 5 + _CRASH_ROOM > Replay::MAX_BYTES) {
+        _bytes[6] |= Replay::FLAG_TRUNCATED;
+        return;
+    }
+    _lastPressed = pressed;
+    _event(gameTime, Replay::EVENT_EDGE);
+}
+
+void ReplayRecorder::crash(unsigned long gameTime, int score) {
+    if (_finished) {
+        return;
+    }
+    _event(gameTime, Replay::EVENT_CRASH);
+    _varint(score);
+    _finished = true;
+}
+
+// ============================ Getter methods =============================
+
+const uint8_t *ReplayRecorder::getBytes() {
+    return _bytes;
+}
+
+int ReplayRecorder::getLength() {
+    return _length;
+}
+
+bool ReplayRecorder::isFinished() {
+    return _finished;
+}
+
+// ================== Private Methods ============================
+
+void ReplayRecorder::_event(unsigned long gameTime, int type) {
+    // Times only go forward, so the difference is always small and positive
+    uint32_t delta = gameTime - _lastEventTime;
+    _lastEventTime = gameTime;
+    _varint((delta << 2) | type);
+}
+
+void ReplayRecorder::_varint(uint32_t value) {
+    // Up to 5 bytes. sample() made sure there is room
+    while (value >= 0x80) {
+        _bytes[_length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    _bytes[_length++] = (uint8_t)value;
+}
+
+// ================================ ReplayPlayer ================================
+
+ReplayPlayer::ReplayPlayer() {
+    _bytes = NULL;
+    _length = 0;
+    _isOpen = false;
+}
+
+bool ReplayPlayer::open(const uint8_t *bytes, int length) {
+    _isOpen = false;
+    if (bytes == NULL || length < Replay::HEADER_SIZE || memcmp(bytes, "FRPL", 4) != 0 || bytes[4] != Replay::VERSION) {
+        return false;
+    }
+    _bytes = bytes;
+    _length = length;
+    _mode = bytes[5];
+    _flags = bytes[6];
+    _configHash = 0;
+    _seed = 0;
+    for (int i = 0; i < 4; i++) {
+        _configHash |= (uint32_t)bytes[8 + i] << (8 * i);
+        _seed |= (uint32_t)bytes[12 + i] << (8 * i);
+    }
+
+    // Go through it once to count the edges and find the crash
+    int position = Replay::HEADER_SIZE;
+    unsigned long time = 0;
+    int type;
+    _edgeCount = 0;
+    while (_readEvent(position, time, type)) {
+        if (type == Replay::EVENT_EDGE) {
+            _edgeCount++;
+            continue;
+        }
+        uint32_t score;
+        if (type != Replay::EVENT_CRASH || !_readVarint(position, score)) {
+            return false;
+        }
+        _crashTime = time;
+        _score = score;
+        _isOpen = true;
+        break;
+    }
+    if (!_isOpen) {
+        return false; // It never says how the game ended
+    }
+
+    // Ready to play from the start
+    _position = Replay::HEADER_SIZE;
+    _nextEventTime = 0;
+    if (!_readEvent(_position, _nextEventTime, _nextEventType)) {
+        _nextEventType = Replay::EVENT_CRASH;
+    }
+    _pressed = false;
+    return true;
+}
+
+bool ReplayPlayer::isOpen() {
+    return _isOpen;
+}
+
+bool ReplayPlayer::buttonAt(unsigned long gameTime) {
+    // Every edge up to now flips the button
+    while (_isOpen && _nextEventType == Replay::EVENT_EDGE && _nextEventTime <= gameTime) {
+        _pressed = !_pressed;
+        if (!_readEvent(_position, _nextEventTime, _nextEventType)) {
+            _nextEventType = Replay::EVENT_CRASH;
+        }
+    }
+    return _pressed;
+}
+
+// ============================ Getter methods =============================
+
+uint32_t ReplayPlayer::getSeed() {
+    return _seed;
+}
+
+uint32_t ReplayPlayer::getConfigHash() {
+    return _configHash;
+}
+
+uint8_t ReplayPlayer::getMode() {
+    return _mode;
+}
+
+bool ReplayPlayer::isTruncated() {
+    return (_flags & Replay::FLAG_TRUNCATED) != 0;
+}
+
+int ReplayPlayer::getEdgeCount() {
+    return _edgeCount;
+}
+
+unsigned long ReplayPlayer::getCrashTime() {
+    return _crashTime;
+}
+
+int ReplayPlayer::getScore() {
+    return _score;
+}
+
+// ================== Private Methods ============================
+
+bool ReplayPlayer::_readEvent(int &position, unsigned long &time, int &type) {
+    uint32_t value;
+    if (!_readVarint(position, value)) {
+        return false;
+    }
+    time += value >> 2;
+    type = value & 3;
+    return true;
+}
+
+bool ReplayPlayer::_readVarint(int &position, uint32_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (position >= _length) {
+            return false;
+        }
+        uint8_t byte = _bytes[position++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
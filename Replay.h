@@ -0,0 +1,131 @@
+/******************************************************************************
+Replay.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Replays * *
+* If a player says "the bird went through the pillar", there was no way to see that
+* game again. The pillars come from random() and the button is read whenever the bird
+* happens to be due, so the same player never plays the same game twice.
+*
+* In the deterministic mode (FlappyGame::record()), everything that decides what
+* happens is pinned down:
+*   - every game starts the pillars' random numbers from a seed that is written down
+*   - every task works from its deadline instead of millis(), so running a bit late
+*     doesn't change anything
+*   - every time the button is read and it is different from the last read, the time
+*     of that edge is written down, in ms since the game started
+* A game is then only its seed and its edges. Playing them back through the same code
+* gives the same game, on the Photon or on the host, any number of times.
+*
+* * Layout * *
+*   "FRPL", version, motion mode, flags (bit 0: ran out of room), 0
+*   config hash (4 bytes, little endian), seed (4 bytes)
+*   then one event after another, each a varint of (time since the last event << 2 | type)
+*     type 0: the button changed
+*     type 1: the bird crashed, followed by a varint of the score
+* A varint is 7 bits per byte, lowest first, with the top bit set on all but the last.
+* An edge a few hundred ms after the last one takes 2 bytes.
+******************************/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+
+class Replay {
+
+    public:
+
+        static const int HEADER_SIZE = 16;
+        static const int MAX_BYTES = 4000; // About 5 minutes of someone flapping twice a second
+        static const uint8_t VERSION = 1;
+
+        static const int EVENT_EDGE = 0;
+        static const int EVENT_CRASH = 1;
+
+        static const uint8_t FLAG_TRUNCATED = 1;
+
+        // Mixes one more number into a hash (FNV-1a), for the config hash
+        static uint32_t hashStep(uint32_t hash, int32_t value);
+};
+
+// Writes down one game
+class ReplayRecorder {
+
+    public:
+
+        ReplayRecorder();
+
+        void start(uint32_t seed, uint32_t configHash, uint8_t mode); // A new game, forgets the last one
+        void sample(unsigned long gameTime, bool pressed); // Every read of the button. Only changes are kept
+        void crash(unsigned long gameTime, int score); // The end of the game
+
+        // Getter methods
+        const uint8_t *getBytes();
+        int getLength();
+        bool isFinished();
+
+    private:
+
+        static const int _CRASH_ROOM = 10; // The crash and the score, 5 bytes each at most
+
+        uint8_t _bytes[Replay::MAX_BYTES];
+        int _length;
+        unsigned long _lastEventTime;
+        bool _lastPressed;
+        bool _finished;
+
+        void _event(unsigned long gameTime, int type);
+        void _varint(uint32_t value);
+};
+
+// Plays one back
+class ReplayPlayer {
+
+    public:
+
+        ReplayPlayer();
+
+        // Checks the header and finds the crash. False if it isn't a whole replay
+        bool open(const uint8_t *bytes, int length);
+        bool isOpen();
+
+        // What the button was at that time of the game. Times have to go forward
+        bool buttonAt(unsigned long gameTime);
+
+        // Getter methods
+        uint32_t getSeed();
+        uint32_t getConfigHash();
+        uint8_t getMode();
+        bool isTruncated();
+        int getEdgeCount();
+        unsigned long getCrashTime(); // When the recorded game ended, in ms since it started
+        int getScore(); // And what the score was
+
+    private:
+
+        const uint8_t *_bytes;
+        int _length;
+        bool _isOpen;
+        uint32_t _seed;
+        uint32_t _configHash;
+        uint8_t _mode;
+        uint8_t _flags;
+        int _edgeCount;
+        unsigned long _crashTime;
+        int _score;
+
+        // Where buttonAt() is up to
+        int _position;
+        unsigned long _nextEventTime;
+        int _nextEventType;
+        bool _pressed;
+
+        bool _readEvent(int &position, unsigned long &time, int &type);
+        bool _readVarint(int &position, uint32_t &value);
+};
+
+#endif
@@ -0,0 +1,198 @@
+/******************************************************************************
+ReplayStore.cpp
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Sector layout * *
+* A 16 byte header, little endian:
+*   magic 0x52, 0, length (2 bytes), sequence (4), CRC-32 of the replay (4), CRC-32 of the first 12 (4)
+* then the replay itself. The header is written after the replay.
+******************************/
+
+#include "ReplayStore.h"
+#include "ScoreStore.h" // crc32()
+#include <string.h>
+
+using namespace Flashee;
+
+// ================================ Public Methods ================================
+
+ReplayStore::ReplayStore() {
+    _flash = NULL;
+    _sectorCount = 0;
+    _newestSector = -1;
+    _nextSequence = 1;
+    _targetSector = 0;
+    _isTargetErased = false;
+    _isInUse = false;
+    _pendingLength = 0;
+    _pendingWritten = 0;
+    _hasPending = false;
+    _erases = 0;
+}
+
+void ReplayStore::begin(FlashDevice *flash) {
+    _flash = flash;
+    _sectorCount = (flash != NULL) ? flash->pageCount() : 0;
+    _newestSector = -1;
+    _nextSequence = 1;
+    _hasPending = false;
+    if (_sectorCount < 2 || flash->pageSize() < HEADER_SIZE + Replay::MAX_BYTES) {
+        _flash = NULL; // Nowhere to rotate to, or no room for a replay, so nothing is saved
+        return;
+    }
+
+    // Every sector's header, for the biggest sequence
+    uint32_t newestSequence = 0;
+    for (int sector = 0; sector < _sectorCount; sector++) {
+        uint32_t sequence;
+        int length;
+        uint32_t crc;
+        if (_readHeader(sector, sequence, length, crc) && (_newestSector < 0 || sequence > newestSequence)) {
+            _newestSector = sector;
+            newestSequence = sequence;
+        }
+    }
+    _nextSequence = newestSequence + 1;
+    _targetSector = (_newestSector < 0) ? 0 : (_newestSector + 1) % _sectorCount;
+    _isTargetErased = _isErased(_targetSector); // Left ready by the last time, unless the power went out
+    _isInUse = false;
+}
+
+void ReplayStore::submit(const uint8_t *bytes, int length) {
+    if (_flash == NULL || length <= 0 || length > Replay::MAX_BYTES) {
+        return;
+    }
+    if (_hasPending && _pendingWritten > 0) {
+        _isTargetErased = false; // Some of the old one is in there already
+    }
+    _isInUse = true;
+    memcpy(_pending, bytes, length);
+    _pendingLength = length;
+    _pendingWritten = 0;
+    _hasPending = true;
+}
+
+bool ReplayStore::work(unsigned long timeLeft) {
+    if (_flash == NULL) {
+        return false;
+    }
+    if (_isInUse && !_isTargetErased) {
+        // The next sector is made ready even with nothing to write yet, so a game that ends
+        // never waits for it. Only once games are being recorded, so nothing is erased for nothing
+        if (timeLeft < ERASE_TIME) {
+            return false;
+        }
+        _flash->erasePage(_address(_targetSector));
+        _erases++;
+        _isTargetErased = true;
+        return true;
+    }
+    if (!_hasPending) {
+        return false;
+    }
+    if (_pendingWritten < _pendingLength) {
+        int length = _pendingLength - _pendingWritten;
+        length = (length < CHUNK_SIZE) ? length : CHUNK_SIZE;
+        _flash->write(_pending + _pendingWritten, _address(_targetSector) + HEADER_SIZE + _pendingWritten, length);
+        _pendingWritten += length;
+        return true;
+    }
+    // All of it is there, so the header makes it the newest
+    _writeHeader(_targetSector, _nextSequence++, _pendingLength, ScoreStore::crc32(_pending, _pendingLength));
+    _newestSector = _targetSector;
+    _targetSector = (_targetSector + 1) % _sectorCount;
+    _isTargetErased = false;
+    _hasPending = false;
+    return true;
+}
+
+bool ReplayStore::hasWork() {
+    return _flash != NULL && (_hasPending || (_isInUse && !_isTargetErased));
+}
+
+int ReplayStore::read(uint8_t *bytes, int maxLength) {
+    if (_hasPending) {
+        if (_pendingLength > maxLength) {
+            return 0;
+        }
+        memcpy(bytes, _pending, _pendingLength);
+        return _pendingLength;
+    }
+    uint32_t sequence;
+    int length;
+    uint32_t crc;
+    if (_flash == NULL || _newestSector < 0 || !_readHeader(_newestSector, sequence, length, crc) || length > maxLength) {
+        return 0;
+    }
+    if (!_flash->read(bytes, _address(_newestSector) + HEADER_SIZE, length) || ScoreStore::crc32(bytes, length) != crc) {
+        return 0;
+    }
+    return length;
+}
+
+// ============================ Getter methods =============================
+
+int ReplayStore::getNewestSector() {
+    return _newestSector;
+}
+
+unsigned long ReplayStore::getErases() {
+    return _erases;
+}
+
+// ================== Private Methods ============================
+
+bool ReplayStore::_readHeader(int sector, uint32_t &sequence, int &length, uint32_t &crc) {
+    uint8_t bytes[HEADER_SIZE];
+    if (!_flash->read(bytes, _address(sector), HEADER_SIZE) || bytes[0] != _MAGIC) {
+        return false; // Erased reads as 0xFF
+    }
+    uint32_t headerCrc = bytes[12] | (bytes[13] << 8) | (bytes[14] << 16) | ((uint32_t)bytes[15] << 24);
+    if (headerCrc != ScoreStore::crc32(bytes, 12)) {
+        return false;
+    }
+    length = bytes[2] | (bytes[3] << 8);
+    sequence = bytes[4] | (bytes[5] << 8) | (bytes[6] << 16) | ((uint32_t)bytes[7] << 24);
+    crc = bytes[8] | (bytes[9] << 8) | (bytes[10] << 16) | ((uint32_t)bytes[11] << 24);
+    return length >= Replay::HEADER_SIZE && length <= Replay::MAX_BYTES;
+}
+
+void ReplayStore::_writeHeader(int sector, uint32_t sequence, int length, uint32_t crc) {
+    uint8_t bytes[HEADER_SIZE];
+    bytes[0] = _MAGIC;
+    bytes[1] = 0;
+    bytes[2] = (uint8_t)length;
+    bytes[3] = (uint8_t)(length >> 8);
+    for (int i = 0; i < 4; i++) {
+        bytes[4 + i] = (uint8_t)(sequence >> (8 * i));
+        bytes[8 + i] = (uint8_t)(crc >> (8 * i));
+    }
+    uint32_t headerCrc = ScoreStore::crc32(bytes, 12);
+    for (int i = 0; i < 4; i++) {
+        bytes[12 + i] = (uint8_t)(headerCrc >> (8 * i));
+    }
+    _flash->write(bytes, _address(sector), HEADER_SIZE);
+}
+
+bool ReplayStore::_isErased(int sector) {
+    uint8_t bytes[CHUNK_SIZE];
+    for (int at = 0; at < _flash->pageSize(); at += CHUNK_SIZE) {
+        int length = (_flash->pageSize() - at < CHUNK_SIZE) ? _flash->pageSize() - at : CHUNK_SIZE;
+        if (!_flash->read(bytes, _address(sector) + at, length)) {
+            return false;
+        }
+        for (int i = 0; i < length; i++) {
+            if (bytes[i] != 0xFF) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+flash_addr_t ReplayStore::_address(int sector) {
+    return _flash->pageAddress(sector);
+}
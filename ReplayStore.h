@@ -0,0 +1,91 @@
+/******************************************************************************
+ReplayStore.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Saving the last game without stopping the game * *
+* The last recorded game used to be written right when the bird crashed, through
+* the default store. That is up to 4 KB, and the default store erases and rewrites
+* a whole page for any write that needs it, so the crash stalled for as long as that
+* took, and the same 2 pages were erased after every game.
+*
+* This keeps the replays in sectors of their own instead, one replay a sector, and a
+* new one always goes into the sector after the last. That sector is erased ahead of
+* time, while the game is waiting anyway, so when a game ends there is nothing to
+* erase. submit() only copies the replay into memory. work() writes a chunk of it
+* (or erases the next sector) per call, and FlappyGame calls it from the scheduler's
+* idle time next to ScoreStore::work().
+*
+* Each sector starts with a header: the length, a sequence number that goes up with
+* every replay, and CRCs of the header and of the replay. The header is written
+* last, so a replay that was cut off by a power loss has none and the one before it
+* is still the newest. begin() reads every sector's header to find the newest, and
+* checks that the sector after it is still erased. Nothing is erased until a game has
+* been recorded, so a Photon that doesn't record never touches these sectors.
+******************************/
+
+#ifndef REPLAYSTORE_H
+#define REPLAYSTORE_H
+
+#include <stdint.h>
+#include "flashee-eeprom/flashee-eeprom.h"
+#include "Replay.h"
+
+class ReplayStore {
+
+    public:
+
+        static const int HEADER_SIZE = 16;
+        static const int CHUNK_SIZE = 256; // Bytes written per work()
+        static const unsigned long ERASE_TIME = 50; // ms an erase may take. work() only erases with this much time to spare
+
+        ReplayStore();
+
+        // Finds the newest replay. The flash is a raw region of whole sectors, at least 2
+        // of them, each big enough for a whole replay
+        void begin(Flashee::FlashDevice *flash);
+
+        // A game ended. Only copies it. A replay that wasn't all written yet is dropped for this one
+        void submit(const uint8_t *bytes, int length);
+
+        // Does one step of writing, if it fits in timeLeft ms. Returns false when there was
+        // nothing to do, or the next step didn't fit
+        bool work(unsigned long timeLeft);
+        bool hasWork();
+
+        // The newest replay, even if it is still being written. Returns its length, 0 if there is none
+        int read(uint8_t *bytes, int maxLength);
+
+        // Getter methods
+        int getNewestSector(); // -1 when there is none on the flash
+        unsigned long getErases();
+
+    private:
+
+        static const uint8_t _MAGIC = 0x52;
+
+        Flashee::FlashDevice *_flash;
+        int _sectorCount;
+
+        int _newestSector;
+        uint32_t _nextSequence;
+        int _targetSector; // Where the next replay goes
+        bool _isTargetErased;
+        bool _isInUse; // A game was submitted since begin(), so more are likely to come
+
+        uint8_t _pending[Replay::MAX_BYTES]; // The replay being written
+        int _pendingLength;
+        int _pendingWritten;
+        bool _hasPending;
+
+        unsigned long _erases;
+
+        bool _readHeader(int sector, uint32_t &sequence, int &length, uint32_t &crc);
+        void _writeHeader(int sector, uint32_t sequence, int length, uint32_t crc);
+        bool _isErased(int sector); // Every byte 0xFF
+        Flashee::flash_addr_t _address(int sector);
+};
+
+#endif
@@ -0,0 +1,84 @@
+/******************************************************************************
+RingBuffer.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Why a ring buffer * *
+* The pillars come in on the right and leave on the left, so they are a queue.
+* Keeping them in a plain array means that every time the first one leaves, all
+* the others have to be shifted down by one, and creating them with new and
+* delete means the Photon's small heap gets chopped up over a long session.
+*
+* A ring buffer keeps the items in place in a fixed array, and only remembers
+* where the first one is and how many there are. Adding to the back and taking
+* from the front are both just moving an index, no matter how many items there
+* are. The capacity is a template parameter, so the memory is all reserved up
+* front and the same code works for 3 pillars or 300.
+******************************/
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+template <typename T, int Capacity>
+class RingBuffer {
+
+    public:
+
+        RingBuffer() {
+            _head = 0;
+            _count = 0;
+        }
+
+        // Getter methods
+        int size() const { return _count; }
+        bool isEmpty() const { return _count == 0; }
+        bool isFull() const { return _count == Capacity; }
+        static int capacity() { return Capacity; }
+
+        // Index 0 is always the oldest item (the front), size() - 1 the newest (the back)
+        T &operator[](int i) { return _items[_wrap(_head + i)]; }
+        const T &operator[](int i) const { return _items[_wrap(_head + i)]; }
+        T &front() { return _items[_head]; }
+        const T &front() const { return _items[_head]; }
+        T &back() { return (*this)[_count - 1]; }
+        const T &back() const { return (*this)[_count - 1]; }
+
+        // Copies the item into the next free slot. Returns false if it is full
+        bool pushBack(const T &item) {
+            if (isFull()) {
+                return false;
+            }
+            _items[_wrap(_head + _count)] = item;
+            _count++;
+            return true;
+        }
+
+        // Forgets the oldest item. The slot is reused by a later pushBack
+        void popFront() {
+            if (isEmpty()) {
+                return;
+            }
+            _head = _wrap(_head + 1);
+            _count--;
+        }
+
+        void clear() {
+            _head = 0;
+            _count = 0;
+        }
+
+    private:
+
+        T _items[Capacity];
+        int _head; // Slot of the front item
+        int _count; // How many slots are in use
+
+        // Both _head and i are smaller than Capacity, so one subtraction is enough and we avoid a division
+        static int _wrap(int index) {
+            return (index >= Capacity) ? index - Capacity : index;
+        }
+};
+
+#endif
@@ -0,0 +1,222 @@
+/******************************************************************************
+Scheduler.cpp
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+#include "Scheduler.h"
+#include "Arduino/Arduino.h"
+#include "Profiler.h"
+
+// ================================ Public Methods ================================
+
+Scheduler::Scheduler() {
+    _taskCount = 0;
+    _heapSize = 0;
+    _idleFunction = NULL;
+    _idleContext = NULL;
+    _sleepSlice = 0;
+    _isWoken = false;
+}
+
+int Scheduler::addTask(const char *name, TaskFunction function, void *context) {
+    if (_taskCount == MAX_TASKS) {
+        return -1;
+    }
+    Task &task = _tasks[_taskCount];
+    task.name = name;
+    task.function = function;
+    task.context = context;
+    task.deadline = 0;
+    task.heapIndex = -1;
+    task.runs = 0;
+    task.maxLateness = 0;
+    task.totalLateness = 0;
+    return _taskCount++;
+}
+
+void Scheduler::schedule(int task, unsigned long deadline) {
+    if (task < 0 || task >= _taskCount) {
+        return;
+    }
+    if (_tasks[task].heapIndex >= 0) {
+        // Already waiting, so take it out and put it back with the new deadline
+        _removeAt(_tasks[task].heapIndex);
+    }
+    _tasks[task].deadline = deadline;
+    _tasks[task].heapIndex = _heapSize;
+    _heap[_heapSize] = task;
+    _heapSize++;
+    _siftUp(_heapSize - 1);
+}
+
+void Scheduler::cancel(int task) {
+    if (isScheduled(task)) {
+        _removeAt(_tasks[task].heapIndex);
+    }
+}
+
+bool Scheduler::isScheduled(int task) {
+    return task >= 0 && task < _taskCount && _tasks[task].heapIndex >= 0;
+}
+
+int Scheduler::runDue(unsigned long now) {
+    int ran = 0;
+    while (_heapSize > 0 && isDue(_tasks[_heap[0]].deadline, now)) {
+        int id = _heap[0];
+        Task &task = _tasks[id];
+        _removeAt(0);
+
+        // Keep track of how late it is, which is the animation's jitter
+        unsigned long lateness = now - task.deadline;
+        task.runs++;
+        task.totalLateness += lateness;
+        if (lateness > task.maxLateness) {
+            task.maxLateness = lateness;
+        }
+        FLAPPY_PROFILE_LATENESS(id, task.name, lateness);
+
+        task.function(task.context, task.deadline);
+        ran++;
+        // The task might have taken a while, so look at the clock again
+        now = millis();
+    }
+    return ran;
+}
+
+void Scheduler::sleepUntilNext() {
+    if (_heapSize == 0) {
+        return;
+    }
+    unsigned long now = millis();
+    unsigned long deadline = _tasks[_heap[0]].deadline;
+    // The spare time goes to the idle task one small step at a time, and the clock is
+    // checked after each one, so it can't make the next task late by more than a step
+    while (_idleFunction != NULL && !_isWoken && !isDue(deadline, now) && _idleFunction(_idleContext, deadline - now)) {
+        now = millis();
+    }
+    while (!_isWoken && !isDue(deadline, now)) {
+        unsigned long left = deadline - now;
+        delay((_sleepSlice > 0 && left > _sleepSlice) ? _sleepSlice : left); // On the Photon, delay() also keeps the cloud connection going
+        now = millis();
+    }
+    _isWoken = false;
+}
+
+void Scheduler::wake() {
+    _isWoken = true;
+}
+
+void Scheduler::setSleepSlice(unsigned long ms) {
+    _sleepSlice = ms;
+}
+
+void Scheduler::setIdleTask(IdleFunction function, void *context) {
+    _idleFunction = function;
+    _idleContext = context;
+}
+
+// ============================ Getter methods =============================
+
+bool Scheduler::isEmpty() {
+    return _heapSize == 0;
+}
+
+unsigned long Scheduler::getNextDeadline() {
+    return (_heapSize > 0) ? _tasks[_heap[0]].deadline : 0;
+}
+
+unsigned long Scheduler::getDeadline(int task) {
+    return _tasks[task].deadline;
+}
+
+int Scheduler::getTaskCount() {
+    return _taskCount;
+}
+
+const char *Scheduler::getTaskName(int task) {
+    return _tasks[task].name;
+}
+
+unsigned long Scheduler::getRuns(int task) {
+    return _tasks[task].runs;
+}
+
+unsigned long Scheduler::getMaxLateness(int task) {
+    return _tasks[task].maxLateness;
+}
+
+unsigned long Scheduler::getTotalLateness(int task) {
+    return _tasks[task].totalLateness;
+}
+
+bool Scheduler::isDue(unsigned long deadline, unsigned long now) {
+    // now - deadline is small and positive once the deadline has passed, and huge
+    // (negative as a long) before it, even when millis() wrapped in between
+    return (long)(now - deadline) >= 0;
+}
+
+// ================== Private Methods ============================
+
+bool Scheduler::_earlier(int heapA, int heapB) {
+    const Task &a = _tasks[_heap[heapA]];
+    const Task &b = _tasks[_heap[heapB]];
+    long difference = (long)(a.deadline - b.deadline);
+    if (difference != 0) {
+        return difference < 0;
+    }
+    // Same deadline: the task that was added first goes first, so the order is the same every time
+    return _heap[heapA] < _heap[heapB];
+}
+
+void Scheduler::_swap(int heapA, int heapB) {
+    int task = _heap[heapA];
+    _heap[heapA] = _heap[heapB];
+    _heap[heapB] = task;
+    _tasks[_heap[heapA]].heapIndex = heapA;
+    _tasks[_heap[heapB]].heapIndex = heapB;
+}
+
+void Scheduler::_siftUp(int heapIndex) {
+    while (heapIndex > 0) {
+        int parent = (heapIndex - 1) / 2;
+        if (!_earlier(heapIndex, parent)) {
+            return;
+        }
+        _swap(heapIndex, parent);
+        heapIndex = parent;
+    }
+}
+
+void Scheduler::_siftDown(int heapIndex) {
+    while (true) {
+        int earliest = heapIndex;
+        int left = heapIndex * 2 + 1;
+        int right = left + 1;
+        if (left < _heapSize && _earlier(left, earliest)) {
+            earliest = left;
+        }
+        if (right < _heapSize && _earlier(right, earliest)) {
+            earliest = right;
+        }
+        if (earliest == heapIndex) {
+            return;
+        }
+        _swap(heapIndex, earliest);
+        heapIndex = earliest;
+    }
+}
+
+void Scheduler::_removeAt(int heapIndex) {
+    int task = _heap[heapIndex];
+    _heapSize--;
+    if (heapIndex != _heapSize) {
+        // Fill the hole with the last item, which may need to go either way
+        int moved = _heap[_heapSize];
+        _heap[heapIndex] = moved;
+        _tasks[moved].heapIndex = heapIndex;
+        _siftUp(heapIndex);
+        _siftDown(_tasks[moved].heapIndex);
+    }
+    _tasks[task].heapIndex = -1;
+}
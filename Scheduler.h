@@ -0,0 +1,102 @@
+/******************************************************************************
+Scheduler.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Scheduler * *
+* The game used to spin in loop() checking millis() against a "next time" for the
+* bird and one for the pillars. This keeps those next times (deadlines) in a small
+* min-heap instead, so the earliest one is always on top. loop() runs whatever is
+* due and then sleeps exactly until the next deadline, instead of polling every
+* millisecond.
+*
+* Deadlines are millis() values, and millis() wraps around after about 49 days.
+* Comparing them with a signed difference instead of < keeps working across the
+* wrap, as long as no deadline is more than 24 days away.
+******************************/
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+class Scheduler {
+
+    public:
+
+        // A task gets its context back, and the deadline it was scheduled for
+        typedef void (*TaskFunction)(void *context, unsigned long deadline);
+        // The idle task gets the ms left before the next deadline. It does one small step
+        // of its work and returns true, or returns false when there is nothing (that fits)
+        typedef bool (*IdleFunction)(void *context, unsigned long timeLeft);
+
+        static const int MAX_TASKS = 8;
+
+        Scheduler();
+
+        // Registers a task and returns its id, or -1 if there is no room. It won't
+        // run until it is scheduled
+        int addTask(const char *name, TaskFunction function, void *context);
+
+        void schedule(int task, unsigned long deadline); // Sets or moves the task's deadline
+        void cancel(int task);
+        bool isScheduled(int task);
+
+        // Runs every task whose deadline has come, earliest first. A task may schedule
+        // itself again, and runs again in the same call if that deadline has come too
+        int runDue(unsigned long now);
+        // delay()s until the earliest deadline. Returns right away if something is due.
+        // The idle task gets the time first, for as long as it has something to do
+        void sleepUntilNext();
+        void setIdleTask(IdleFunction function, void *context); // NULL for none
+        // Ends the sleep early, at the end of the current slice. Safe to call from an interrupt
+        void wake();
+        // The longest single delay() of a sleep, so a wake() is seen that soon. 0 (the
+        // default) sleeps in one go, and nothing can wake it
+        void setSleepSlice(unsigned long ms);
+
+        // Getter methods
+        bool isEmpty();
+        unsigned long getNextDeadline(); // Only meaningful when !isEmpty()
+        unsigned long getDeadline(int task); // Only meaningful when isScheduled(task)
+        int getTaskCount();
+        const char *getTaskName(int task);
+
+        // How late each task ran, in ms after its deadline
+        unsigned long getRuns(int task);
+        unsigned long getMaxLateness(int task);
+        unsigned long getTotalLateness(int task);
+
+        // True once now has reached the deadline, across a millis() wrap too
+        static bool isDue(unsigned long deadline, unsigned long now);
+
+    private:
+
+        struct Task {
+            const char *name;
+            TaskFunction function;
+            void *context;
+            unsigned long deadline;
+            int heapIndex; // Where it is in _heap, -1 when it isn't scheduled
+            unsigned long runs;
+            unsigned long maxLateness;
+            unsigned long totalLateness;
+        };
+
+        Task _tasks[MAX_TASKS];
+        int _taskCount;
+        int _heap[MAX_TASKS]; // Task ids, earliest deadline first
+        int _heapSize;
+        IdleFunction _idleFunction;
+        void *_idleContext;
+        unsigned long _sleepSlice;
+        volatile bool _isWoken;
+
+        bool _earlier(int heapA, int heapB);
+        void _swap(int heapA, int heapB);
+        void _siftUp(int heapIndex);
+        void _siftDown(int heapIndex);
+        void _removeAt(int heapIndex);
+};
+
+#endif
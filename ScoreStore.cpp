@@ -0,0 +1,311 @@
+/******************************************************************************
+ScoreStore.cpp
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Record layout * *
+* 16 bytes, little endian:
+*   magic 0x5C, kind, player (2 bytes), score (4), sequence (4), CRC-32 of the first 12 (4)
+* An erased slot is all 0xFF. A slot that is neither erased nor has the right CRC was
+* cut off while it was being written, and is skipped.
+*
+* A sector always starts with a snapshot: one record per leaderboard line, then an end
+* mark. The new scores come after that, until the sector is full.
+******************************/
+
+#include "ScoreStore.h"
+#include <string.h>
+
+using namespace Flashee;
+
+// ================================ Public Methods ================================
+
+ScoreStore::ScoreStore() {
+    _flash = NULL;
+    _sectorCount = 0;
+    _recordsPerSector = 0;
+    _entryCount = 0;
+    _activeSector = -1;
+    _nextSlot = 0;
+    _nextSequence = 1;
+    _isRotating = false;
+    _rotationErased = false;
+    _rotationSector = 0;
+    _snapshotWritten = 0;
+    _snapshotCount = 0;
+    _snapshotNeeded = false;
+    _recordsWritten = 0;
+    _erases = 0;
+}
+
+void ScoreStore::begin(FlashDevice *flash) {
+    _flash = flash;
+    _sectorCount = (flash != NULL) ? flash->pageCount() : 0;
+    // The log only goes round the sectors begin() looks at, or a reboot would miss the newest
+    _sectorCount = (_sectorCount < _MAX_SECTORS) ? _sectorCount : _MAX_SECTORS;
+    _recordsPerSector = (flash != NULL) ? flash->pageSize() / RECORD_SIZE : 0;
+    _entryCount = 0;
+    _activeSector = -1;
+    _nextSlot = 0;
+    _nextSequence = 1;
+    _queue.clear();
+    if (_sectorCount < 2) {
+        _flash = NULL; // Nowhere to rotate to, so nothing is saved
+        return;
+    }
+
+    // Only the first record of every sector is read to find the newest one. Then that
+    // sector is read, and if its snapshot was never finished, the one before it
+    uint32_t firstSequence[_MAX_SECTORS];
+    bool isCandidate[_MAX_SECTORS];
+    for (int sector = 0; sector < _sectorCount; sector++) {
+        Record record = { 0, 0, 0, 0 };
+        bool erased;
+        isCandidate[sector] = _readRecord(sector, 0, record, erased) && (record.kind == _KIND_SNAPSHOT || record.kind == _KIND_SNAPSHOT_END);
+        firstSequence[sector] = record.sequence;
+    }
+    while (true) {
+        int newest = -1;
+        for (int sector = 0; sector < _sectorCount; sector++) {
+            if (isCandidate[sector] && (newest < 0 || firstSequence[sector] > firstSequence[newest])) {
+                newest = sector;
+            }
+        }
+        if (newest < 0) {
+            _entryCount = 0;
+            return; // Brand new flash, or nothing whole on it. The first score starts the log
+        }
+        uint32_t lastSequence;
+        if (_loadSector(newest, lastSequence)) {
+            _activeSector = newest;
+            _nextSequence = lastSequence + 1;
+            return;
+        }
+        isCandidate[newest] = false;
+    }
+}
+
+bool ScoreStore::submit(uint16_t player, uint32_t score) {
+    ScoreEntry entry = { player, score };
+    if (!_addToBoard(entry)) {
+        return false;
+    }
+    Record record = { _KIND_SCORE, player, score, 0 };
+    if (!_queue.pushBack(record)) {
+        // No room to queue it. The next snapshot has it anyway, so make sure there is one
+        _snapshotNeeded = true;
+    }
+    return true;
+}
+
+bool ScoreStore::work(unsigned long timeLeft) {
+    if (_flash == NULL) {
+        return false;
+    }
+    if (_isRotating) {
+        if (!_rotationErased && timeLeft < ERASE_TIME) {
+            return false; // Wait for a longer break
+        }
+        _rotationStep();
+        return true;
+    }
+    if (_snapshotNeeded || (!_queue.isEmpty() && (_activeSector < 0 || _nextSlot >= _recordsPerSector))) {
+        _startRotation();
+        return true;
+    }
+    if (_queue.isEmpty()) {
+        return false;
+    }
+    const Record &record = _queue.front();
+    _writeRecord(_activeSector, _nextSlot, record.kind, record.player, record.score);
+    _nextSlot++;
+    _queue.popFront();
+    return true;
+}
+
+bool ScoreStore::hasWork() {
+    return _flash != NULL && (_isRotating || _snapshotNeeded || !_queue.isEmpty());
+}
+
+uint32_t ScoreStore::crc32(const uint8_t *bytes, int length) {
+    // A bit at a time. The records are only ever 12 bytes, and a replay is only checked when it is read
+    uint32_t crc = 0xFFFFFFFFu;
+    for (int i = 0; i < length; i++) {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+// ============================ Getter methods =============================
+
+int ScoreStore::getEntryCount() {
+    return _entryCount;
+}
+
+ScoreEntry ScoreStore::getEntry(int place) {
+    return _board[place];
+}
+
+uint32_t ScoreStore::getBestScore() {
+    return (_entryCount > 0) ? _board[0].score : 0;
+}
+
+int ScoreStore::getActiveSector() {
+    return _activeSector;
+}
+
+unsigned long ScoreStore::getRecordsWritten() {
+    return _recordsWritten;
+}
+
+unsigned long ScoreStore::getErases() {
+    return _erases;
+}
+
+// ================== Private Methods ============================
+
+bool ScoreStore::_addToBoard(ScoreEntry entry) {
+    // A player only has one line, their best
+    int place = -1;
+    for (int i = 0; i < _entryCount; i++) {
+        if (_board[i].player == entry.player) {
+            if (entry.score <= _board[i].score) {
+                return false;
+            }
+            place = i;
+            break;
+        }
+    }
+    if (place < 0) {
+        if (_entryCount < LEADERBOARD_SIZE) {
+            place = _entryCount++;
+        } else if (entry.score > _board[_entryCount - 1].score) {
+            place = _entryCount - 1; // Pushes the last one off
+        } else {
+            return false;
+        }
+    }
+    // Move it up to where it belongs, like one pass of insertion sort
+    while (place > 0 && _board[place - 1].score < entry.score) {
+        _board[place] = _board[place - 1];
+        place--;
+    }
+    _board[place] = entry;
+    return true;
+}
+
+void ScoreStore::_startRotation() {
+    // The snapshot has everything on the board right now, so what was queued is in it too
+    memcpy(_snapshot, _board, sizeof(_snapshot));
+    _snapshotCount = _entryCount;
+    _queue.clear();
+    _snapshotNeeded = false;
+    _rotationSector = (_activeSector < 0) ? 0 : (_activeSector + 1) % _sectorCount;
+    _rotationErased = false;
+    _snapshotWritten = 0;
+    _isRotating = true;
+}
+
+void ScoreStore::_rotationStep() {
+    if (!_rotationErased) {
+        _flash->erasePage(_address(_rotationSector, 0));
+        _erases++;
+        _rotationErased = true;
+    } else if (_snapshotWritten < _snapshotCount) {
+        const ScoreEntry &entry = _snapshot[_snapshotWritten];
+        _writeRecord(_rotationSector, _snapshotWritten, _KIND_SNAPSHOT, entry.player, entry.score);
+        _snapshotWritten++;
+    } else {
+        // The end mark makes the new sector the one that is read at startup
+        _writeRecord(_rotationSector, _snapshotCount, _KIND_SNAPSHOT_END, 0, 0);
+        _activeSector = _rotationSector;
+        _nextSlot = _snapshotCount + 1;
+        _isRotating = false;
+    }
+}
+
+void ScoreStore::_writeRecord(int sector, int slot, uint8_t kind, uint16_t player, uint32_t score) {
+    Record record = { kind, player, score, _nextSequence++ };
+    uint8_t bytes[RECORD_SIZE];
+    _encode(record, bytes);
+    _flash->write(bytes, _address(sector, slot), RECORD_SIZE);
+    _recordsWritten++;
+}
+
+bool ScoreStore::_readRecord(int sector, int slot, Record &record, bool &erased) {
+    uint8_t bytes[RECORD_SIZE];
+    erased = false;
+    if (!_flash->read(bytes, _address(sector, slot), RECORD_SIZE)) {
+        return false;
+    }
+    erased = true;
+    for (int i = 0; i < RECORD_SIZE; i++) {
+        erased &= (bytes[i] == 0xFF);
+    }
+    if (erased || bytes[0] != _MAGIC) {
+        return false;
+    }
+    uint32_t crc = bytes[12] | (bytes[13] << 8) | (bytes[14] << 16) | ((uint32_t)bytes[15] << 24);
+    if (crc != crc32(bytes, 12)) {
+        return false;
+    }
+    record.kind = bytes[1];
+    record.player = bytes[2] | (bytes[3] << 8);
+    record.score = bytes[4] | (bytes[5] << 8) | (bytes[6] << 16) | ((uint32_t)bytes[7] << 24);
+    record.sequence = bytes[8] | (bytes[9] << 8) | (bytes[10] << 16) | ((uint32_t)bytes[11] << 24);
+    return true;
+}
+
+bool ScoreStore::_loadSector(int sector, uint32_t &lastSequence) {
+    bool snapshotIsWhole = false;
+    _entryCount = 0;
+    lastSequence = 0;
+    _nextSlot = _recordsPerSector;
+    for (int slot = 0; slot < _recordsPerSector; slot++) {
+        Record record;
+        bool erased;
+        if (!_readRecord(sector, slot, record, erased)) {
+            if (erased) {
+                _nextSlot = slot; // The log ends here
+                break;
+            }
+            continue; // Cut off by a power loss. The next record goes after it
+        }
+        if (record.sequence > lastSequence) {
+            lastSequence = record.sequence;
+        }
+        ScoreEntry entry = { record.player, record.score };
+        if (!snapshotIsWhole && record.kind == _KIND_SNAPSHOT) {
+            _addToBoard(entry);
+        } else if (!snapshotIsWhole && record.kind == _KIND_SNAPSHOT_END) {
+            snapshotIsWhole = true;
+        } else if (snapshotIsWhole && record.kind == _KIND_SCORE) {
+            _addToBoard(entry);
+        }
+    }
+    return snapshotIsWhole;
+}
+
+flash_addr_t ScoreStore::_address(int sector, int slot) {
+    return _flash->pageAddress(sector) + slot * RECORD_SIZE;
+}
+
+void ScoreStore::_encode(const Record &record, uint8_t *bytes) {
+    bytes[0] = _MAGIC;
+    bytes[1] = record.kind;
+    bytes[2] = (uint8_t)record.player;
+    bytes[3] = (uint8_t)(record.player >> 8);
+    for (int i = 0; i < 4; i++) {
+        bytes[4 + i] = (uint8_t)(record.score >> (8 * i));
+        bytes[8 + i] = (uint8_t)(record.sequence >> (8 * i));
+    }
+    uint32_t crc = crc32(bytes, 12);
+    for (int i = 0; i < 4; i++) {
+        bytes[12 + i] = (uint8_t)(crc >> (8 * i));
+    }
+}
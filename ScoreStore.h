@@ -0,0 +1,130 @@
+/******************************************************************************
+ScoreStore.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Saving scores without wearing out the flash * *
+* The high score used to be written to address 10 every time it was beaten. Flash
+* can only turn 1 bits into 0 bits, so rewriting the same address means erasing its
+* whole sector every time, and a sector only survives so many erases. The write also
+* happened right on the game over screen, and an erase can take tens of ms.
+*
+* This keeps a log instead. Every new score is a 16 byte record added after the last
+* one, so nothing is ever rewritten, and a sector is only erased once it is full of
+* records and the log moves on to the next one. With 4 sectors each one gets erased a
+* quarter as often as one sector would be.
+*
+* Each record has a CRC, so one that was only half written when the power went out is
+* skipped instead of read as garbage. When the log moves to a new sector, it starts it
+* with a copy of the whole leaderboard and an end mark, so at startup only the newest
+* sector has to be read. If the power went out before the end mark, the sector before
+* it is still whole and is used instead.
+*
+* submit() only changes the leaderboard in memory and puts the record in a queue.
+* work() writes one record (or erases one sector) per call, and FlappyGame calls it
+* from the scheduler's idle time, when nothing is due for a while.
+******************************/
+
+#ifndef SCORESTORE_H
+#define SCORESTORE_H
+
+#include <stdint.h>
+#include "flashee-eeprom/flashee-eeprom.h"
+#include "RingBuffer.h"
+
+// One line of the leaderboard
+struct ScoreEntry {
+    uint16_t player;
+    uint32_t score;
+};
+
+class ScoreStore {
+
+    public:
+
+        static const int LEADERBOARD_SIZE = 5; // Best scores kept, at most one per player
+        static const int RECORD_SIZE = 16;
+        static const int QUEUE_SIZE = 8; // Scores waiting to be written
+        static const unsigned long ERASE_TIME = 50; // ms an erase may take. work() only erases with this much time to spare
+
+        ScoreStore();
+
+        // Reads the log back. The flash is a raw region of whole sectors, at least 2 of them.
+        // Only the first 16 are used
+        void begin(Flashee::FlashDevice *flash);
+
+        // A game ended. Returns true if it made the leaderboard. Nothing is written yet
+        bool submit(uint16_t player, uint32_t score);
+
+        // Does one step of writing, if it fits in timeLeft ms. Returns false when there was
+        // nothing to do, or the next step didn't fit
+        bool work(unsigned long timeLeft);
+        bool hasWork();
+
+        // Getter methods
+        int getEntryCount();
+        ScoreEntry getEntry(int place); // 0 is the best
+        uint32_t getBestScore(); // 0 when there is none
+        int getActiveSector();
+        unsigned long getRecordsWritten();
+        unsigned long getErases();
+
+        // The usual CRC-32. ReplayStore checks its replays with it too
+        static uint32_t crc32(const uint8_t *bytes, int length);
+
+    private:
+
+        enum RecordKind {
+            _KIND_SCORE = 1, // A player's new best
+            _KIND_SNAPSHOT = 2, // A leaderboard line copied to the start of a sector
+            _KIND_SNAPSHOT_END = 3 // The copy is whole
+        };
+
+        struct Record {
+            uint8_t kind;
+            uint16_t player;
+            uint32_t score;
+            uint32_t sequence; // Goes up by one with every record, so the newest sector has the biggest
+        };
+
+        static const uint8_t _MAGIC = 0x5C;
+        static const int _MAX_SECTORS = 16; // Only this many are used. The rest of a bigger region is left alone
+
+        Flashee::FlashDevice *_flash;
+        int _sectorCount;
+        int _recordsPerSector;
+
+        ScoreEntry _board[LEADERBOARD_SIZE];
+        int _entryCount;
+
+        int _activeSector; // -1 when there is no good sector yet
+        int _nextSlot; // Where the next record goes in the active sector
+        uint32_t _nextSequence;
+        RingBuffer<Record, QUEUE_SIZE> _queue;
+
+        // Moving to the next sector, one step at a time
+        bool _isRotating;
+        bool _rotationErased;
+        int _rotationSector;
+        int _snapshotWritten; // Snapshot lines written so far. _snapshotCount means the end mark is next
+        ScoreEntry _snapshot[LEADERBOARD_SIZE];
+        int _snapshotCount;
+        bool _snapshotNeeded; // The queue overflowed, so the next write is a whole snapshot
+
+        unsigned long _recordsWritten;
+        unsigned long _erases;
+
+        bool _addToBoard(ScoreEntry entry);
+        void _startRotation();
+        void _rotationStep();
+        void _writeRecord(int sector, int slot, uint8_t kind, uint16_t player, uint32_t score);
+        bool _readRecord(int sector, int slot, Record &record, bool &erased);
+        bool _loadSector(int sector, uint32_t &lastSequence); // Fills _board and _nextSlot
+        Flashee::flash_addr_t _address(int sector, int slot);
+
+        static void _encode(const Record &record, uint8_t *bytes);
+};
+
+#endif
@@ -0,0 +1,108 @@
+/******************************************************************************
+SpriteAtlas.cpp
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+#include "SpriteAtlas.h"
+#include <string.h>
+
+// ================================ Public Methods ================================
+
+SpriteAtlas::SpriteAtlas(MicroOLED &oled) : _oled(oled) {
+    memset(_digits, 0, sizeof(_digits));
+    memset(_highLabel, 0, sizeof(_highLabel));
+    memset(_bird, 0, sizeof(_bird));
+    _birdSize = 0;
+}
+
+void SpriteAtlas::build(int birdSize) {
+    if (birdSize > MAX_BIRD_SIZE) {
+        birdSize = MAX_BIRD_SIZE; // A bigger bird wouldn't fit in one byte per column
+    }
+    _birdSize = birdSize;
+
+    // Everything is drawn at the top left corner, where the top page of the buffer starts,
+    // so the bytes can be copied as they are
+    for (int digit = 0; digit < 10; digit++) {
+        _oled.clear(PAGE);
+        _oled.drawChar(0, 0, '0' + digit, WHITE, NORM);
+        _capture(_digits[digit], GLYPH_WIDTH);
+    }
+
+    _oled.clear(PAGE);
+    const char *label = "High";
+    for (int i = 0; label[i] != '\0'; i++) {
+        _oled.drawChar(i * GLYPH_WIDTH, 0, label[i], WHITE, NORM);
+    }
+    _capture(_highLabel, sizeof(_highLabel));
+
+    _oled.clear(PAGE);
+    _oled.circle(birdSize, birdSize, birdSize);
+    _capture(_bird, 2 * birdSize + 1);
+
+    _oled.clear(PAGE);
+}
+
+// ============================ Getter methods =============================
+
+Sprite SpriteAtlas::getDigit(int digit) {
+    Sprite sprite = { _digits[digit], GLYPH_WIDTH, GLYPH_HEIGHT };
+    return sprite;
+}
+
+Sprite SpriteAtlas::getHighLabel() {
+    Sprite sprite = { _highLabel, sizeof(_highLabel), GLYPH_HEIGHT };
+    return sprite;
+}
+
+Sprite SpriteAtlas::getBird() {
+    Sprite sprite = { _bird, (uint8_t)(2 * _birdSize + 1), (uint8_t)(2 * _birdSize + 1) };
+    return sprite;
+}
+
+int SpriteAtlas::getBirdSize() {
+    return _birdSize;
+}
+
+// ================== Private Methods ============================
+
+void SpriteAtlas::_capture(uint8_t *columns, int width) {
+    memcpy(columns, _oled.getScreenBuffer(), width);
+}
+
+// ================================ NumberText ================================
+
+NumberText::NumberText() {
+    _value = 0;
+    _isDrawn = false;
+    _width = 0;
+    memset(_columns, 0, sizeof(_columns));
+}
+
+void NumberText::set(SpriteAtlas &atlas, int value) {
+    if (_isDrawn && value == _value) {
+        return; // Same number as last time, the bytes are still good
+    }
+    _value = value;
+    _isDrawn = true;
+
+    // Take the digits off from the right, then copy them in from the left
+    int digits[MAX_DIGITS];
+    int count = 0;
+    do {
+        digits[count++] = value % 10;
+        value /= 10;
+    } while (value > 0 && count < MAX_DIGITS);
+
+    _width = 0;
+    for (int i = count - 1; i >= 0; i--) {
+        memcpy(_columns + _width, atlas.getDigit(digits[i]).columns, SpriteAtlas::GLYPH_WIDTH);
+        _width += SpriteAtlas::GLYPH_WIDTH;
+    }
+}
+
+Sprite NumberText::getSprite() {
+    Sprite sprite = { _columns, _width, SpriteAtlas::GLYPH_HEIGHT };
+    return sprite;
+}
@@ -0,0 +1,81 @@
+/******************************************************************************
+SpriteAtlas.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Drawing from ready-made pictures * *
+* Printing the score turned a number into a String on the heap and drew it pixel by
+* pixel from the font, and oled.circle() worked out the bird's circle again, on every
+* frame. None of that changes between frames.
+*
+* The atlas draws the digits, the "High" label and the bird once, with the library's
+* own drawChar() and circle(), and keeps the bytes. After that they are copied
+* straight into the screen buffer with Raster::blit(), 8 columns at a time. The
+* pixels are the same ones the library would have drawn.
+*
+* Pictures are stored like the screen (see Sprite in Raster.h), so a picture can be
+* at most 8 pixels tall.
+******************************/
+
+#ifndef SPRITEATLAS_H
+#define SPRITEATLAS_H
+
+#include <stdint.h>
+#include "SparkFunMicroOLED/SparkFunMicroOLED.h"
+#include "Raster.h"
+
+class SpriteAtlas {
+
+    public:
+
+        static const int GLYPH_WIDTH = 6; // 5 columns of font and 1 blank one, the same as print()
+        static const int GLYPH_HEIGHT = 8;
+        static const int MAX_BIRD_SIZE = 3; // The bird is 2 * size + 1 pixels tall, and it has to fit in 8
+
+        SpriteAtlas(MicroOLED &oled);
+
+        // Draws everything once and keeps it. Call it after oled.begin(). It uses the screen
+        // buffer to draw in, so the buffer is cleared afterwards
+        void build(int birdSize);
+
+        // Getter methods
+        Sprite getDigit(int digit);
+        Sprite getHighLabel();
+        Sprite getBird();
+        int getBirdSize();
+
+    private:
+
+        MicroOLED &_oled;
+        uint8_t _digits[10][GLYPH_WIDTH];
+        uint8_t _highLabel[4 * GLYPH_WIDTH];
+        uint8_t _bird[2 * MAX_BIRD_SIZE + 1];
+        int _birdSize;
+
+        void _capture(uint8_t *columns, int width); // Copies the first columns of the top page
+};
+
+// A number drawn with the atlas digits. It is only drawn again when the number changes,
+// so most frames just blit the bytes from last time
+class NumberText {
+
+    public:
+
+        static const int MAX_DIGITS = 10; // Enough for any int that isn't negative
+
+        NumberText();
+
+        void set(SpriteAtlas &atlas, int value); // The value can't be negative
+        Sprite getSprite();
+
+    private:
+
+        int _value;
+        bool _isDrawn;
+        uint8_t _width;
+        uint8_t _columns[MAX_DIGITS * SpriteAtlas::GLYPH_WIDTH];
+};
+
+#endif
@@ -0,0 +1,77 @@
+/******************************************************************************
+SpscQueue.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * A queue an interrupt can write to * *
+* RingBuffer is fine as long as only loop() touches it. The button's interrupt can
+* cut into loop() anywhere though, even halfway through a pushBack, so the two sides
+* can't share a count they both change.
+*
+* This one has exactly one writer (the interrupt) and one reader (loop()). The writer
+* only ever moves _tail and the reader only ever moves _head, so neither has to stop
+* the other, and no interrupts have to be turned off. std::atomic makes sure the item
+* is all written before the new _tail can be seen, on the Photon and on a PC with
+* real threads too.
+*
+* One slot is always left empty, so head == tail means empty and nothing else does.
+* The capacity has to be a power of 2 so wrapping around is a bit mask.
+******************************/
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+
+template <typename T, int Capacity>
+class SpscQueue {
+
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "The capacity has to be a power of 2");
+
+    public:
+
+        SpscQueue() : _head(0), _tail(0) {}
+
+        // ===== Writer side (the interrupt) =====
+
+        // Copies the item in. Returns false if it is full, and the item is dropped
+        bool push(const T &item) {
+            unsigned int tail = _tail.load(std::memory_order_relaxed);
+            unsigned int next = (tail + 1) & (Capacity - 1);
+            if (next == _head.load(std::memory_order_acquire)) {
+                return false;
+            }
+            _items[tail] = item;
+            _tail.store(next, std::memory_order_release); // Only now can the reader see it
+            return true;
+        }
+
+        // ===== Reader side (loop()) =====
+
+        // Takes the oldest item out. Returns false if there is none
+        bool pop(T &item) {
+            unsigned int head = _head.load(std::memory_order_relaxed);
+            if (head == _tail.load(std::memory_order_acquire)) {
+                return false;
+            }
+            item = _items[head];
+            _head.store((head + 1) & (Capacity - 1), std::memory_order_release); // The slot can be written again
+            return true;
+        }
+
+        bool isEmpty() const {
+            return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+        }
+
+        static int capacity() { return Capacity - 1; }
+
+    private:
+
+        T _items[Capacity];
+        std::atomic<unsigned int> _head; // Next slot to read
+        std::atomic<unsigned int> _tail; // Next slot to write
+};
+
+#endif
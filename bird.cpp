@@ -21,71 +21,94 @@ Original Completion Date: July 13
 * the delay, from the existing delay property. And if it changes and for instance, the
 * user starts flapping, then the gravitational delay gets changed into the default one,
 * and the flap delay starts accelerating.
+*
+* * Physics mode * *
+* Moving 1 px and then waiting ties how smooth it looks to how fast the bird is, and
+* after a long stall the bird can only make up for it one pixel at a time. The
+* physics mode gives the bird a speed and an acceleration instead, and works out
+* where it is after any amount of time with the formula from physics class:
+*
+*     y = y0 + v * t + a * t * t / 2
+*
+* So going forward 20 ms or 20 seconds is the same amount of work. The speeds start
+* where the delays start (1 px every 50 ms falling, 1 px every 40 ms flapping), and
+* the acceleration is what taking 0.3 ms off the delay for each pixel works out to at
+* those speeds. Changing direction starts the speed over, just like the delays.
+*
+* Everything is kept in fixed point, whole numbers with 16 bits of fraction, so the
+* bird can be part of the way to the next pixel, and there is no floating point in
+* the math that runs every frame.
 ******************************/
 #include "bird.h"
+#include "Profiler.h"
 
 // ================================ Public Methods ================================
-Bird::Bird(int birdSize, int screenWidth, int screenHeight) {
-    // Initialize properties
-    _birdSize = birdSize;
-    _screenHeight = screenHeight;
-    _screenWidth = screenWidth;
-    _birdPosition = _screenHeight / 3;
+template <class Config>
+BasicBird<Config>::BasicBird(int hitboxInset, const GameTuning &tuning) {
+    // Initialize properties. The size of the bird and the screen are in the config
+    _tuning = &tuning;
+    _hitboxInset = hitboxInset;
+    _birdPosition = Config::SCREEN_HEIGHT / 3;
 
     // Set delay for gravity fall and flap rise for user input
     _currentDelay = 0;
     // These are named current, but they are not the current delay in the UI, it just
     // means if this property is called, what is its current value
-    _currentGravitationalDelay = _DEFAULT_GRAVITATIONAL_DELAY;
-    _currentFlapDelay = _DEFAULT_FLAP_DELAY;
+    _currentGravitationalDelay = _tuning->gravitationalDelay;
+    _currentFlapDelay = _tuning->flapDelay;
+    _resetPhysics();
+}
+
+template <class Config>
+BasicBird<Config>::BasicBird(const State &state, const GameTuning &tuning) {
+    _tuning = &tuning;
+    setState(state);
 }
 
-bool Bird::birdCrashed(Pillar **pillars, int amountOfPillars) {
+template <class Config>
+bool BasicBird<Config>::birdCrashed(const PillarRing &pillars) {
+    FLAPPY_PROFILE_SCOPE(PROFILE_CRASH_CHECK);
     // If the bottom of the circle or the top touches the top or bottom of the screen, the bird is crashed
     //
-    // It first checks if it touches the pillars, and then checks if it touches the top and the bottom
-
-    for (int i = 0; i < amountOfPillars; i++) {
-        // Get pillars information
-        Pillar *pillar = pillars[i];
-        int **pillarInformation = pillar->returnPillarInformation();
-
-        int xStarting;
-        int xEnding;
-        int yBottom;
-        int yTop;
-        xStarting = pillarInformation[0][0];
-        xEnding = xStarting + pillarInformation[0][2];
-        yBottom = pillarInformation[0][3];
-        yTop = pillarInformation[1][1];
-
-
-        int birdTop = _birdPosition + _birdSize - 4;
-        int birdBottom = _birdPosition - _birdSize + 4;
-        // -4 and + 4 because of the slow refreshing rate. It is proven that the crashing will be more accurate for some reasons
-        int birdStarting = _screenWidth / 2 - _birdSize;
-        int birdEnding = _screenWidth / 2 + _birdSize;
-
-        if (birdTop <= yBottom || birdBottom >= yTop) {
-            // If the bird's top is above the top pillar's bottom or if the bird's bottom is underneath the bottom pillar's top
-            if (birdStarting <= xEnding && birdEnding >= xStarting) {
-                // Part of bird is in the same x position as the pillars
-                return true;
-            }
-        }
-
-        // Delete since the returnPillarInformation methods creates a "new" object
-        for (int x = 0; x < 2; x++) {
-            delete pillarInformation[x];
-        }
-        delete[] pillarInformation;
+    // It first checks if it touches the pillars, and then checks if it touches the top and the bottom.
+    // The pillar part is in Collision.h. It only looks at the pillars in the same columns as the bird
+    Hitbox box = Collision::birdHitbox(Config::BIRD_X, _birdPosition, Config::BIRD_SIZE, _hitboxInset);
+    if (Collision::hitsAnyPillar(pillars, box)) {
+        return true;
+    }
+    int maxYPosition = Config::SCREEN_HEIGHT - Config::BIRD_SIZE;
+    int minYPosition = Config::BIRD_SIZE;
+    return (_birdPosition >= maxYPosition || _birdPosition <= minYPosition);
+}
+
+template <class Config>
+bool BasicBird<Config>::birdCrashed(const BasicOccupancy<Config> &occupancy, const CollisionMask &shape) {
+    FLAPPY_PROFILE_SCOPE(PROFILE_CRASH_CHECK);
+    // No hitbox inset here. The shape is exactly the pixels the bird is drawn over
+    if (occupancy.hits(shape, Config::BIRD_X - Config::BIRD_SIZE, _birdPosition - Config::BIRD_SIZE)) {
+        return true;
     }
-    int maxYPosition = _screenHeight - _birdSize;
-    int minYPosition = _birdSize;
+    // The top and the bottom of the screen the same as always
+    int maxYPosition = Config::SCREEN_HEIGHT - Config::BIRD_SIZE;
+    int minYPosition = Config::BIRD_SIZE;
     return (_birdPosition >= maxYPosition || _birdPosition <= minYPosition);
 }
 
-void Bird::userInput(bool flap) {
+template <class Config>
+bool BasicBird<Config>::birdCrashed(const uint64_t *columns, const CollisionMask &shape) {
+    FLAPPY_PROFILE_SCOPE(PROFILE_CRASH_CHECK);
+    int x = Config::BIRD_X - Config::BIRD_SIZE;
+    if (BasicOccupancy<Config>::hitsColumns(columns, shape, x, _birdPosition - Config::BIRD_SIZE)) {
+        return true;
+    }
+    int maxYPosition = Config::SCREEN_HEIGHT - Config::BIRD_SIZE;
+    int minYPosition = Config::BIRD_SIZE;
+    return (_birdPosition >= maxYPosition || _birdPosition <= minYPosition);
+}
+
+template <class Config>
+void BasicBird<Config>::userInput(bool flap) {
+    FLAPPY_PROFILE_SCOPE(PROFILE_BIRD_STEP);
     // Determine if it is a flap or a fall
     if (flap) {
         _flap();
@@ -94,44 +117,136 @@ void Bird::userInput(bool flap) {
     }
 }
 
-void Bird::_freeFall() {
+template <class Config>
+void BasicBird<Config>::advance(unsigned long milliseconds, bool flap) {
+    FLAPPY_PROFILE_SCOPE(PROFILE_BIRD_STEP);
+    if (milliseconds > _MAX_ADVANCE) {
+        milliseconds = _MAX_ADVANCE; // So t * t can't overflow
+    }
+
+    // Changing direction starts the speed over, like the delays do
+    int direction = flap ? -1 : 1;
+    int32_t acceleration;
+    if (flap) {
+        acceleration = -_tuning->flapAcceleration;
+    } else {
+        acceleration = _tuning->fallAcceleration;
+    }
+    if (direction != _direction) {
+        _direction = direction;
+        _velocity = flap ? -_tuning->flapSpeed : _tuning->fallSpeed;
+    }
+
+    // y = y0 + v * t + a * t * t / 2, and v = v0 + a * t. t is in ms and v and a are per second
+    int64_t t = milliseconds;
+    _subPixelPosition += (int32_t)(((int64_t)_velocity * t) / 1000 + ((int64_t)acceleration * t * t) / 2000000);
+    _velocity += (int32_t)(((int64_t)acceleration * t) / 1000);
+
+    // The nearest whole pixel is what gets drawn and what crashes
+    _birdPosition = (_subPixelPosition + (1 << (_FRACTION_BITS - 1))) >> _FRACTION_BITS;
+}
+
+template <class Config>
+void BasicBird<Config>::jump(int pixels) {
+    _subPixelPosition -= pixels << _FRACTION_BITS;
+    _birdPosition -= pixels;
+}
+
+template <class Config>
+void BasicBird<Config>::_freeFall() {
 
     // Set the current delay to gravitational. In another word, swtich mode
-    _currentDelay = _currentGravitationalDelay;
+    _currentDelay = (int)_currentGravitationalDelay;
     // Accelerate the gravity, or decrease the delay
-    _currentGravitationalDelay -= _DEFAULT_ACCELERATION_RATE;
+    _currentGravitationalDelay -= _tuning->birdAccelerationRate;
     _birdPosition++; // Keep track of the bird's position by moving it by 1px down, or more
-    _currentFlapDelay = _DEFAULT_FLAP_DELAY; // Reset the flap delay
+    _currentFlapDelay = _tuning->flapDelay; // Reset the flap delay
 }
 
-void Bird::_flap() {
+template <class Config>
+void BasicBird<Config>::_flap() {
     // Same thing as freeFall, the opposite way
-    _currentDelay = _currentFlapDelay;
-    _currentFlapDelay -= _DEFAULT_ACCELERATION_RATE;
+    _currentDelay = (int)_currentFlapDelay;
+    _currentFlapDelay -= _tuning->birdAccelerationRate;
     _birdPosition --;
-    _currentGravitationalDelay = _DEFAULT_GRAVITATIONAL_DELAY;
+    _currentGravitationalDelay = _tuning->gravitationalDelay;
 }
 
 // Getter methods
 
-int Bird::getDelay() {
+template <class Config>
+int BasicBird<Config>::getDelay() {
     return _currentDelay;
 }
 
-bool Bird::getGoingUp() {
+template <class Config>
+bool BasicBird<Config>::getGoingUp() {
     return (_currentDelay > 0);
 }
 
-int Bird::getBirdPosition() {
+template <class Config>
+int BasicBird<Config>::getBirdPosition() {
     return _birdPosition;
 }
 
+template <class Config>
+int BasicBird<Config>::getHitboxInset() {
+    return _hitboxInset;
+}
+
+template <class Config>
+void BasicBird<Config>::setHitboxInset(int hitboxInset) {
+    _hitboxInset = hitboxInset;
+}
+
+// Saving and restoring
+
+template <class Config>
+typename BasicBird<Config>::State BasicBird<Config>::getState() const {
+    State state = State(); // Zeroes the padding too, so equal states compare equal byte for byte
+    state.gravitationalDelay = _currentGravitationalDelay;
+    state.flapDelay = _currentFlapDelay;
+    state.subPixelPosition = _subPixelPosition;
+    state.velocity = _velocity;
+    state.position = (int16_t)_birdPosition;
+    state.delay = (int16_t)_currentDelay;
+    state.direction = (int8_t)_direction;
+    state.hitboxInset = (int8_t)_hitboxInset;
+    return state;
+}
+
+template <class Config>
+void BasicBird<Config>::setState(const State &state) {
+    _currentGravitationalDelay = state.gravitationalDelay;
+    _currentFlapDelay = state.flapDelay;
+    _subPixelPosition = state.subPixelPosition;
+    _velocity = state.velocity;
+    _birdPosition = state.position;
+    _currentDelay = state.delay;
+    _direction = state.direction;
+    _hitboxInset = state.hitboxInset;
+}
+
 // Reset all data
 
-void Bird::reset() {
-    _birdPosition = _screenHeight / 3;
+template <class Config>
+void BasicBird<Config>::reset() {
+    _birdPosition = Config::SCREEN_HEIGHT / 3;
     // Set delay for gravity fall and flap rise for user input
     _currentDelay = 0;
-    _currentGravitationalDelay = _DEFAULT_GRAVITATIONAL_DELAY;
-    _currentFlapDelay = _DEFAULT_FLAP_DELAY;
+    _currentGravitationalDelay = _tuning->gravitationalDelay;
+    _currentFlapDelay = _tuning->flapDelay;
+    _resetPhysics();
+}
+
+template <class Config>
+void BasicBird<Config>::_resetPhysics() {
+    _subPixelPosition = _birdPosition << _FRACTION_BITS;
+    _velocity = 0;
+    _direction = 0;
 }
+
+// The configs the game can be built for. Anything else has to be added here
+template class BasicBird<MicroOledConfig>;
+template class BasicBird<LargePanelConfig>;
+template class BasicBird<WidePanelConfig>;
@@ -11,45 +11,95 @@ Original Completion Date: July 13
 #ifndef BIRD_H
 #define BIRD_H
 
+#include <stdint.h>
 #include "pillar.h"
+#include "Collision.h"
+#include "Occupancy.h" // The pixel collision
+#include "FixedPoint.h" // BirdDelay is a double, or a fixed point number on boards without floating point
 
-class Bird {
+template <class Config>
+class BasicBird {
     public:
 
-        Bird(int birdSize, int screenWidth, int screenHeight);
+        typedef typename BasicPillar<Config>::Ring PillarRing; // The pillars this bird can crash into
+
+        // Everything about the bird that changes while it flies, packed as small as it goes.
+        // A GameSnapshot (see Autopilot.h) keeps one of these to copy the bird in one go
+        struct State {
+            BirdDelay gravitationalDelay;
+            BirdDelay flapDelay;
+            int32_t subPixelPosition;
+            int32_t velocity;
+            int16_t position;
+            int16_t delay;
+            int8_t direction;
+            int8_t hitboxInset;
+        };
+
+        // The bird's delays and how fast it speeds up come from the tuning, which has to
+        // outlive the bird (see GameConfig.h)
+        explicit BasicBird(int hitboxInset = Config::HITBOX_INSET, const GameTuning &tuning = DefaultTuning<Config>::TUNING);
+        // A bird that carries on from a saved state
+        explicit BasicBird(const State &state, const GameTuning &tuning = DefaultTuning<Config>::TUNING);
         void userInput(bool flap);
 
+        // Physics mode, instead of userInput(). Moves the bird by however much time went by,
+        // in one go, and keeps the part of a pixel it didn't get to. Read the notes at bird.cpp
+        void advance(unsigned long milliseconds, bool flap);
+        void jump(int pixels); // Moves the bird up right away, like the boost at the start of a flap
+
         // Getter methods
         int getDelay();
         bool getGoingUp();
         int getBirdPosition();
+        int getHitboxInset();
+
+        void setHitboxInset(int hitboxInset); // See GameConfig::HITBOX_INSET
+
+        // Saving and restoring the bird. setState(getState()) changes nothing
+        State getState() const;
+        void setState(const State &state);
 
         // Determine if the bird crashed or not
-        bool birdCrashed(Pillar **pillars, int amountOfPillars);
+        bool birdCrashed(const PillarRing &pillars);
+        // The same, but only when a pixel of the bird's shape is on a pillar's (see Occupancy.h).
+        // The shape is where the bird is drawn, with its top left corner BIRD_SIZE up and left of it
+        bool birdCrashed(const BasicOccupancy<Config> &occupancy, const CollisionMask &shape);
+        // The same again, with only the shape's columns worked out, by BasicOccupancy::column()
+        bool birdCrashed(const uint64_t *columns, const CollisionMask &shape);
 
         // Reset
         void reset();
 
     private:
-        // Constants that keep track of the acceleration
-        const double _DEFAULT_GRAVITATIONAL_DELAY = 50; // Default delay
-        const double _DEFAULT_FLAP_DELAY = 40;
-        const double _DEFAULT_ACCELERATION_RATE = 0.3; // How much the delay decreases after the animation of each pixel if the user keeps pressing
+        // The delays and how fast they go down are in the tuning (gravitationalDelay, flapDelay and birdAccelerationRate)
+        const GameTuning *_tuning;
+        BirdDelay _currentGravitationalDelay; // Free falling delay
+        BirdDelay _currentFlapDelay; // Flapping delay
 
-        double _currentGravitationalDelay; // Free falling delay
-        double _currentFlapDelay; // Flapping delay
-
-        int _birdSize;
         int _birdPosition;
-        int _screenHeight;
-        int _screenWidth;
         int _currentDelay;
+        int _hitboxInset;
         bool _goingUp;
 
+        // Physics mode. Numbers with 16 bits after the point, so 65536 is 1 px.
+        // Speeds are in px per second and accelerations in px per second per second.
+        // Where they start is in the tuning (fallSpeed, flapSpeed and the accelerations)
+        static const int _FRACTION_BITS = GameTuning::SPEED_FRACTION_BITS;
+        static const unsigned long _MAX_ADVANCE = 60000; // Longer than the bird could ever stay on screen without input
+        int32_t _subPixelPosition;
+        int32_t _velocity; // Down is positive, like y on the screen
+        int _direction; // 1 falling, -1 flapping, 0 not moving yet
+
+        void _resetPhysics();
+
         void _freeFall();
         void _flap();
 
 
 };
 
+// The 64x48 one the game uses
+typedef BasicBird<DefaultGameConfig> Bird;
+
 #endif
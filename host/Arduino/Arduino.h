@@ -0,0 +1,92 @@
+/******************************************************************************
+Arduino.h (host stand-in)
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Host stand-in * *
+* This is NOT the Arduino library. It is just enough of its functions for the game
+* to compile and run on a normal computer. Time comes from a virtual clock that only
+* moves when delay() is called or when the driver moves it, random() comes from a
+* seeded generator, and digitalRead() asks a scripted input source. All three are
+* controlled through HostPlatform.h.
+*
+* An interrupt attached to the button is called whenever the script changes while
+* the clock moves, which is checked every virtual ms.
+*
+* SPI only has the DMA transfer, the one that returns right away and calls back when
+* it is done. The bytes take as long as they would at the bus speed set in
+* HostPlatform.h, and the callback runs when the clock gets past that.
+******************************/
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+// Pin names used by the sketch. On the host they are only numbers
+enum {
+    D0 = 0, D1, D2, D3, D4, D5, D6, D7,
+    A0 = 10, A1, A2, A3, A4, A5
+};
+
+#define INPUT 0
+#define OUTPUT 1
+#define LOW 0
+#define HIGH 1
+
+enum InterruptMode { CHANGE, RISING, FALLING };
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned int seed);
+
+void pinMode(uint16_t pin, int mode);
+int32_t digitalRead(uint16_t pin);
+void digitalWrite(uint16_t pin, uint8_t value);
+
+// Only one interrupt, and only CHANGE, which is all the game uses
+bool attachInterrupt(uint16_t pin, void (*handler)(), InterruptMode mode);
+void detachInterrupt(uint16_t pin);
+void noInterrupts();
+void interrupts();
+
+// Only the DMA transfer. tx is read until the callback runs, rx has to be NULL
+typedef void (*wiring_spi_dma_transfercomplete_callback_t)(void);
+
+class SPIClass {
+
+    public:
+
+        void transfer(void *tx, void *rx, size_t length, wiring_spi_dma_transfercomplete_callback_t callback);
+};
+
+extern SPIClass SPI;
+
+// The sketch casts numbers to String before printing them. This keeps the same
+// behaviour, including the heap allocation a real String makes
+class String {
+
+    public:
+
+        String(const char *text) : _text(text) {}
+        String(int value) : _text(std::to_string(value)) {}
+        String(unsigned int value) : _text(std::to_string(value)) {}
+        String(long value) : _text(std::to_string(value)) {}
+
+        const char *c_str() const { return _text.c_str(); }
+        unsigned int length() const { return _text.size(); }
+
+    private:
+
+        std::string _text;
+};
+
+#endif
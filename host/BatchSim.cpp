@@ -0,0 +1,438 @@
+/******************************************************************************
+BatchSim.cpp
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+#include "BatchSim.h"
+#include "../Collision.h"
+#include <string.h>
+
+// Bird turns the GameConfig numbers into doubles, and the batch has to do the exact same
+// arithmetic on them to stay bit for bit identical
+static const double DEFAULT_GRAVITATIONAL_DELAY = DefaultGameConfig::GRAVITATIONAL_DELAY;
+static const double DEFAULT_FLAP_DELAY = DefaultGameConfig::FLAP_DELAY;
+static const double DEFAULT_ACCELERATION_RATE = DefaultGameConfig::BIRD_ACCELERATION_RATE;
+
+// PillarManager goes by the same tables
+typedef DefaultGameConfig::Difficulty Difficulty;
+static const int32_t NEVER = 0x7FFFFFFF; // The step or score of a table entry past the end
+
+/*******************************
+* * Vector helpers * *
+* The kernels below are written once against these few functions, and only the
+* functions change with the instruction set. Masks are all ones for true and all
+* zeros for false, like the compare instructions return them.
+******************************/
+
+#if defined(__AVX2__) && !defined(BATCHSIM_SCALAR)
+#include <immintrin.h>
+
+#define INT_LANES 8
+#define DOUBLE_LANES 4
+#define SIMD_NAME "avx2"
+
+typedef __m256i vint;
+typedef __m256d vdouble;
+
+static inline vint loadInt(const int32_t *p) { return _mm256_loadu_si256((const __m256i *)p); }
+static inline void storeInt(int32_t *p, vint v) { _mm256_storeu_si256((__m256i *)p, v); }
+static inline vint setInt(int32_t a) { return _mm256_set1_epi32(a); }
+static inline vint addInt(vint a, vint b) { return _mm256_add_epi32(a, b); }
+static inline vint subInt(vint a, vint b) { return _mm256_sub_epi32(a, b); }
+static inline vint andInt(vint a, vint b) { return _mm256_and_si256(a, b); }
+static inline vint orInt(vint a, vint b) { return _mm256_or_si256(a, b); }
+static inline vint andNotInt(vint a, vint b) { return _mm256_andnot_si256(a, b); } // ~a & b
+static inline vint equalInt(vint a, vint b) { return _mm256_cmpeq_epi32(a, b); }
+static inline vint greaterInt(vint a, vint b) { return _mm256_cmpgt_epi32(a, b); }
+static inline int maskBits(vint m) { return _mm256_movemask_ps(_mm256_castsi256_ps(m)); }
+// One byte flag per game, widened to a 0 or 1 per lane
+static inline vint loadFlags(const uint8_t *p) { return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)p)); }
+
+
+static inline vdouble loadDouble(const double *p) { return _mm256_loadu_pd(p); }
+static inline void storeDouble(double *p, vdouble v) { _mm256_storeu_pd(p, v); }
+static inline vdouble setDouble(double a) { return _mm256_set1_pd(a); }
+static inline vdouble subDouble(vdouble a, vdouble b) { return _mm256_sub_pd(a, b); }
+static inline vdouble selectDouble(vdouble m, vdouble a, vdouble b) { return _mm256_blendv_pd(b, a, m); }
+static inline vdouble flagMaskDouble(const uint8_t *p) {
+    int32_t four;
+    memcpy(&four, p, sizeof(four));
+    vint wide = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(four));
+    return _mm256_castsi256_pd(_mm256_cmpgt_epi64(wide, _mm256_setzero_si256()));
+}
+// (int) of each lane, truncating like a C cast
+static inline void storeTruncated(int32_t *p, vdouble v) { _mm_storeu_si128((__m128i *)p, _mm256_cvttpd_epi32(v)); }
+
+#elif defined(__SSE2__) && !defined(BATCHSIM_SCALAR)
+#include <emmintrin.h>
+
+#define INT_LANES 4
+#define DOUBLE_LANES 2
+#define SIMD_NAME "sse2"
+
+typedef __m128i vint;
+typedef __m128d vdouble;
+
+static inline vint loadInt(const int32_t *p) { return _mm_loadu_si128((const __m128i *)p); }
+static inline void storeInt(int32_t *p, vint v) { _mm_storeu_si128((__m128i *)p, v); }
+static inline vint setInt(int32_t a) { return _mm_set1_epi32(a); }
+static inline vint addInt(vint a, vint b) { return _mm_add_epi32(a, b); }
+static inline vint subInt(vint a, vint b) { return _mm_sub_epi32(a, b); }
+static inline vint andInt(vint a, vint b) { return _mm_and_si128(a, b); }
+static inline vint orInt(vint a, vint b) { return _mm_or_si128(a, b); }
+static inline vint andNotInt(vint a, vint b) { return _mm_andnot_si128(a, b); }
+static inline vint equalInt(vint a, vint b) { return _mm_cmpeq_epi32(a, b); }
+static inline vint greaterInt(vint a, vint b) { return _mm_cmpgt_epi32(a, b); }
+static inline int maskBits(vint m) { return _mm_movemask_ps(_mm_castsi128_ps(m)); }
+static inline vint loadFlags(const uint8_t *p) {
+    int32_t four;
+    memcpy(&four, p, sizeof(four));
+    __m128i zero = _mm_setzero_si128();
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(four), zero), zero);
+}
+
+
+static inline vdouble loadDouble(const double *p) { return _mm_loadu_pd(p); }
+static inline void storeDouble(double *p, vdouble v) { _mm_storeu_pd(p, v); }
+static inline vdouble setDouble(double a) { return _mm_set1_pd(a); }
+static inline vdouble subDouble(vdouble a, vdouble b) { return _mm_sub_pd(a, b); }
+static inline vdouble selectDouble(vdouble m, vdouble a, vdouble b) { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+static inline vdouble flagMaskDouble(const uint8_t *p) {
+    return _mm_castsi128_pd(_mm_set_epi64x(p[1] ? -1 : 0, p[0] ? -1 : 0));
+}
+static inline void storeTruncated(int32_t *p, vdouble v) { _mm_storel_epi64((__m128i *)p, _mm_cvttpd_epi32(v)); }
+
+#else
+
+#define INT_LANES 1
+#define DOUBLE_LANES 1
+#define SIMD_NAME "scalar"
+
+// Without vectors a "mask" is a plain bool for doubles, and 0 or -1 for ints
+typedef int32_t vint;
+typedef double vdouble;
+
+static inline vint loadInt(const int32_t *p) { return *p; }
+static inline void storeInt(int32_t *p, vint v) { *p = v; }
+static inline vint setInt(int32_t a) { return a; }
+static inline vint addInt(vint a, vint b) { return a + b; }
+static inline vint subInt(vint a, vint b) { return a - b; }
+static inline vint andInt(vint a, vint b) { return a & b; }
+static inline vint orInt(vint a, vint b) { return a | b; }
+static inline vint andNotInt(vint a, vint b) { return ~a & b; }
+static inline vint equalInt(vint a, vint b) { return -(int32_t)(a == b); }
+static inline vint greaterInt(vint a, vint b) { return -(int32_t)(a > b); }
+static inline int maskBits(vint m) { return m & 1; }
+static inline vint loadFlags(const uint8_t *p) { return *p ? 1 : 0; }
+
+
+static inline vdouble loadDouble(const double *p) { return *p; }
+static inline void storeDouble(double *p, vdouble v) { *p = v; }
+static inline vdouble setDouble(double a) { return a; }
+static inline vdouble subDouble(vdouble a, vdouble b) { return a - b; }
+static inline vdouble selectDouble(bool m, vdouble a, vdouble b) { return m ? a : b; }
+static inline bool flagMaskDouble(const uint8_t *p) { return *p != 0; }
+static inline void storeTruncated(int32_t *p, vdouble v) { *p = (int32_t)v; }
+
+#endif
+
+// ================================ Public Methods ================================
+
+BatchSim::BatchSim(int games, int screenWidth, int screenHeight, int birdSize) {
+    _games = games;
+    _stride = (games + INT_LANES - 1) / INT_LANES * INT_LANES;
+    _screenWidth = screenWidth;
+    _screenHeight = screenHeight;
+    _birdSize = birdSize;
+
+    // The padding games run like any other game, they are just never reported
+    _birdPosition.assign(_stride, 0);
+    _birdDelay.assign(_stride, 0);
+    _gravitationalDelay.assign(_stride, 0);
+    _flapDelay.assign(_stride, 0);
+    _pillarCount.assign(_stride, 0);
+    _score.assign(_stride, 0);
+    _levelUps.assign(_stride, 0);
+    _levelUpScore.assign(_stride, 0);
+    _isGoneButHasntReachedYet.assign(_stride, 0);
+    _steps.assign(_stride, 0);
+    _delayIndex.assign(_stride, 0);
+    _nextDelayStep.assign(_stride, 0);
+    _pillarDelay.assign(_stride, 0);
+    _randomState.assign(_stride, 0);
+    _random.assign(_stride, Pcg32());
+    _pillarX.assign(_stride * _MAX_PILLARS, 0);
+    _pillarHeight.assign(_stride * _MAX_PILLARS, 0);
+    _crashed.assign(_stride, 0);
+    _bestScore.assign(_stride, 0);
+    _crashes.assign(_stride, 0);
+
+    seed(1);
+}
+
+void BatchSim::seed(uint32_t baseSeed) {
+    _baseSeed = baseSeed;
+    _totalCrashes = 0;
+    for (int i = 0; i < _stride; i++) {
+        // Same rule as HostPlatform::seedRandom, zero would get xorshift stuck
+        uint32_t seed = seedOf(i);
+        _randomState[i] = (seed == 0) ? 2463534242u : seed;
+        _bestScore[i] = 0;
+        _crashes[i] = 0;
+        _resetGame(i);
+    }
+}
+
+uint32_t BatchSim::seedOf(int game) const {
+    return _baseSeed + game;
+}
+
+void BatchSim::advancePillars() {
+    const vint zero = setInt(0);
+    const vint one = setInt(1);
+    const vint pillarWidth = setInt(_PILLAR_WIDTH);
+    const vint birdX = setInt(_screenWidth / 2);
+    const vint maxPillars = setInt(_MAX_PILLARS);
+
+    for (int i = 0; i < _stride; i += INT_LANES) {
+        // 1. Add pillars. Only games where the first pillar is gone, a pillar is waiting
+        // for room, or the player could level up need it, and those go one at a time
+        vint count = loadInt(&_pillarCount[i]);
+        vint firstGone = andInt(greaterInt(count, zero), equalInt(loadInt(&_pillarX[i]), zero));
+        vint waiting = greaterInt(loadInt(&_isGoneButHasntReachedYet[i]), zero);
+        vint levelUp = andInt(greaterInt(loadInt(&_score[i]), loadInt(&_levelUpScore[i])), greaterInt(maxPillars, count));
+        int needsWork = maskBits(orInt(orInt(firstGone, waiting), levelUp));
+        for (int lane = 0; needsWork != 0; lane++, needsWork >>= 1) {
+            if (needsWork & 1) {
+                _addPillarsIfNeeded(i + lane);
+            }
+        }
+
+        // 2. Count the pillar whose end reaches the bird, and 4. move every pillar by 1 px
+        count = loadInt(&_pillarCount[i]);
+        vint passed = zero;
+        for (int s = 0; s < _MAX_PILLARS; s++) {
+            vint active = greaterInt(count, setInt(s));
+            vint x = loadInt(&_pillarX[s * _stride + i]);
+            passed = orInt(passed, andInt(active, equalInt(addInt(x, pillarWidth), birdX)));
+            storeInt(&_pillarX[s * _stride + i], subInt(x, andInt(active, one)));
+        }
+        // passed is all ones (-1) where a pillar was passed, so subtracting it adds one
+        storeInt(&_score[i], subInt(loadInt(&_score[i]), passed));
+    }
+
+    // 3. Count the step, and look up the next delay in the games that reach the next entry of the table
+    for (int i = 0; i < _stride; i += INT_LANES) {
+        vint steps = addInt(loadInt(&_steps[i]), one);
+        storeInt(&_steps[i], steps);
+        int reached = maskBits(equalInt(steps, loadInt(&_nextDelayStep[i])));
+        for (int lane = 0; reached != 0; lane++, reached >>= 1) {
+            if (reached & 1) {
+                _nextDelay(i + lane);
+            }
+        }
+    }
+}
+
+void BatchSim::advanceBirds(const uint8_t *flaps) {
+    // Bird::_flap and Bird::_freeFall, picked per game by the flap flag
+    const vdouble rate = setDouble(DEFAULT_ACCELERATION_RATE);
+    const vdouble defaultGravity = setDouble(DEFAULT_GRAVITATIONAL_DELAY);
+    const vdouble defaultFlap = setDouble(DEFAULT_FLAP_DELAY);
+    for (int i = 0; i < _stride; i += DOUBLE_LANES) {
+        vdouble flap = flagMaskDouble(&flaps[i]);
+        vdouble gravitationalDelay = loadDouble(&_gravitationalDelay[i]);
+        vdouble flapDelay = loadDouble(&_flapDelay[i]);
+        storeTruncated(&_birdDelay[i], selectDouble(flap, flapDelay, gravitationalDelay));
+        storeDouble(&_flapDelay[i], selectDouble(flap, subDouble(flapDelay, rate), defaultFlap));
+        storeDouble(&_gravitationalDelay[i], selectDouble(flap, defaultGravity, subDouble(gravitationalDelay, rate)));
+    }
+
+    // Bird::birdCrashed, with the same default hitbox inset as the scalar class
+    const vint zero = setInt(0);
+    const vint one = setInt(1);
+    const vint pillarWidth = setInt(_PILLAR_WIDTH);
+    const vint birdSpace = setInt(_BIRD_SPACE);
+    const vint topOffset = setInt(_birdSize - DefaultGameConfig::HITBOX_INSET);
+    const vint bottomOffset = setInt(-_birdSize + DefaultGameConfig::HITBOX_INSET);
+    const vint birdStarting = setInt(_screenWidth / 2 - _birdSize);
+    const vint birdEnding = setInt(_screenWidth / 2 + _birdSize);
+    const vint maxYPosition = setInt(_screenHeight - _birdSize);
+    const vint minYPosition = setInt(_birdSize);
+
+    for (int i = 0; i < _stride; i += INT_LANES) {
+        // Up 1 px for a flap, down 1 px otherwise
+        vint flap = loadFlags(&flaps[i]);
+        vint position = addInt(loadInt(&_birdPosition[i]), subInt(one, addInt(flap, flap)));
+        storeInt(&_birdPosition[i], position);
+
+        vint birdTop = addInt(position, topOffset);
+        vint birdBottom = addInt(position, bottomOffset);
+        vint count = loadInt(&_pillarCount[i]);
+
+        // Off the top or the bottom of the screen
+        vint crashed = orInt(greaterInt(position, subInt(maxYPosition, one)), greaterInt(addInt(minYPosition, one), position));
+        for (int s = 0; s < _MAX_PILLARS; s++) {
+            vint active = greaterInt(count, setInt(s));
+            vint xStarting = loadInt(&_pillarX[s * _stride + i]);
+            vint xEnding = addInt(xStarting, pillarWidth);
+            vint yBottom = loadInt(&_pillarHeight[s * _stride + i]);
+            vint yTop = addInt(yBottom, birdSpace);
+            // (birdTop <= yBottom || birdBottom >= yTop) is !(birdTop > yBottom && yTop > birdBottom)
+            vint outsideGap = andNotInt(andInt(greaterInt(birdTop, yBottom), greaterInt(yTop, birdBottom)), setInt(-1));
+            // (birdStarting <= xEnding && birdEnding >= xStarting)
+            vint sameColumns = andNotInt(orInt(greaterInt(birdStarting, xEnding), greaterInt(xStarting, birdEnding)), setInt(-1));
+            crashed = orInt(crashed, andInt(active, andInt(outsideGap, sameColumns)));
+        }
+        storeInt(&_crashed[i], crashed);
+
+        int crashedBits = maskBits(andNotInt(equalInt(crashed, zero), setInt(-1)));
+        for (int lane = 0; crashedBits != 0; lane++, crashedBits >>= 1) {
+            if (crashedBits & 1) {
+                int game = i + lane;
+                if (_score[game] > _bestScore[game]) {
+                    _bestScore[game] = _score[game];
+                }
+                _crashes[game]++;
+                if (game < _games) {
+                    _totalCrashes++;
+                }
+                _resetGame(game);
+            }
+        }
+    }
+}
+
+void BatchSim::botFlaps(uint8_t *flaps) const {
+    // Hold the button whenever the bird is below the middle of the gap it is heading for
+    int birdX = _screenWidth / 2;
+    for (int i = 0; i < _stride; i++) {
+        int target = _screenHeight / 2;
+        for (int s = 0; s < _pillarCount[i]; s++) {
+            if (_pillarX[s * _stride + i] + _PILLAR_WIDTH >= birdX - _birdSize) {
+                int upHeight = _pillarHeight[s * _stride + i];
+                target = (upHeight + upHeight + _BIRD_SPACE) / 2;
+                break;
+            }
+        }
+        flaps[i] = _birdPosition[i] > target;
+    }
+}
+
+// ============================ Getter methods =============================
+
+int BatchSim::games() const { return _games; }
+int BatchSim::paddedGames() const { return _stride; }
+int BatchSim::getBirdPosition(int game) const { return _birdPosition[game]; }
+int BatchSim::getBirdDelay(int game) const { return _birdDelay[game]; }
+int BatchSim::getPillarDelay(int game) const { return _pillarDelay[game]; }
+int BatchSim::getScore(int game) const { return _score[game]; }
+int BatchSim::getBestScore(int game) const { return _bestScore[game] > _score[game] ? _bestScore[game] : _score[game]; }
+long BatchSim::getCrashes(int game) const { return _crashes[game]; }
+long BatchSim::getTotalCrashes() const { return _totalCrashes; }
+int BatchSim::getPillarCount(int game) const { return _pillarCount[game]; }
+int BatchSim::getPillarX(int game, int pillar) const { return _pillarX[pillar * _stride + game]; }
+
+const char *BatchSim::simdName() { return SIMD_NAME; }
+int BatchSim::simdLanes() { return INT_LANES; }
+
+// ================== Scalar per-game work ============================
+// These follow PillarManager line by line, including the random number an append
+// draws even when there is no room for the pillar. PillarManager draws its heights a
+// few pillars ahead, but they come out of the generator in the same order either way
+
+void BatchSim::_resetGame(int game) {
+    // Bird::reset
+    _birdPosition[game] = _screenHeight / 3;
+    _birdDelay[game] = 0;
+    _gravitationalDelay[game] = DEFAULT_GRAVITATIONAL_DELAY;
+    _flapDelay[game] = DEFAULT_FLAP_DELAY;
+
+    // PillarManager::reset, for a game that isn't seeded: a new seed from random() first
+    uint32_t high = _hostRandom(game) % 0x10000;
+    uint32_t low = _hostRandom(game) % 0x10000;
+    _random[game].seed((high << 16) | low);
+    _pillarCount[game] = 0;
+    _appendExtraPillar(game);
+    _score[game] = 0;
+    _steps[game] = 0;
+    _delayIndex[game] = -1;
+    _nextDelay(game);
+    _levelUps[game] = 0;
+    _levelUpScore[game] = (Difficulty::LEVEL_UP_COUNT > 0) ? Difficulty::LEVEL_UPS[0] : NEVER;
+    _isGoneButHasntReachedYet[game] = 0;
+}
+
+void BatchSim::_addPillarsIfNeeded(int game) {
+    if (_isGoneButHasntReachedYet[game] && _lastPillarIsFarEnoughToAddNew(game)) {
+        _appendExtraPillar(game);
+        _isGoneButHasntReachedYet[game] = 0;
+    }
+    bool firstPillarIsGone = _pillarCount[game] > 0 && _pillarX[game] == 0;
+    if (firstPillarIsGone && _lastPillarIsFarEnoughToAddNew(game)) {
+        _recycleFirstPillar(game);
+        _appendExtraPillar(game);
+    } else if (firstPillarIsGone) {
+        _recycleFirstPillar(game);
+        _isGoneButHasntReachedYet[game] = 1;
+    }
+    if (_score[game] > _levelUpScore[game] && _pillarCount[game] < _MAX_PILLARS && _lastPillarIsFarEnoughToAddNew(game)) {
+        _appendExtraPillar(game);
+        int levelUps = ++_levelUps[game];
+        _levelUpScore[game] = (levelUps < Difficulty::LEVEL_UP_COUNT) ? Difficulty::LEVEL_UPS[levelUps] : NEVER;
+    }
+}
+
+bool BatchSim::_lastPillarIsFarEnoughToAddNew(int game) const {
+    int count = _pillarCount[game];
+    if (count == 0) {
+        return true;
+    }
+    int lastPillarXEnd = _pillarX[(count - 1) * _stride + game] + _PILLAR_WIDTH;
+    return lastPillarXEnd < _screenWidth - _MIN_PILLAR_BETWEEN_PILLAR_SPACE;
+}
+
+void BatchSim::_appendExtraPillar(int game) {
+    int height = _generateRandomHeight(game);
+    int count = _pillarCount[game];
+    if (count == _MAX_PILLARS) {
+        return;
+    }
+    _pillarX[count * _stride + game] = _screenWidth;
+    _pillarHeight[count * _stride + game] = height;
+    _pillarCount[game] = count + 1;
+}
+
+void BatchSim::_recycleFirstPillar(int game) {
+    // The slots are few, so shifting them down keeps slot 0 the leftmost for the vector code
+    int count = _pillarCount[game];
+    for (int s = 0; s < count - 1; s++) {
+        _pillarX[s * _stride + game] = _pillarX[(s + 1) * _stride + game];
+        _pillarHeight[s * _stride + game] = _pillarHeight[(s + 1) * _stride + game];
+    }
+    _pillarCount[game] = count - 1;
+}
+
+void BatchSim::_nextDelay(int game) {
+    int index = ++_delayIndex[game];
+    _pillarDelay[game] = Difficulty::DELAYS[index].delay;
+    _nextDelayStep[game] = (index + 1 < Difficulty::DELAY_COUNT) ? (int32_t)Difficulty::DELAYS[index + 1].fromStep : NEVER;
+}
+
+int BatchSim::_generateRandomHeight(int game) {
+    // PillarManager::_drawHeight
+    int min = _MIN_HEIGHT_OF_PILLARS;
+    int max = _screenHeight - _MIN_HEIGHT_OF_PILLARS - _BIRD_SPACE;
+    return _random[game].between(min, max);
+}
+
+uint32_t BatchSim::_hostRandom(int game) {
+    // The host's random(): xorshift32
+    uint32_t state = _randomState[game];
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    _randomState[game] = state;
+    return state;
+}
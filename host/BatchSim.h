@@ -0,0 +1,126 @@
+/******************************************************************************
+BatchSim.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Batched games * *
+* Runs thousands of independent games at once, for bot training and difficulty
+* tuning. One Bird and one PillarManager per game spends most of its time jumping
+* between objects, so here every property is an array with one entry per game
+* (struct of arrays), and each step runs the same few instructions over all the
+* games, 8 at a time with AVX2, 4 with SSE2, or one at a time without either.
+*
+* One step is exactly one headless tick of the real classes:
+*   1. advancePillars(): PillarManager::timeToMove() for every game
+*   2. the caller decides who flaps, for instance with botFlaps()
+*   3. advanceBirds(): Bird::userInput() and Bird::birdCrashed() for every game,
+*      and the games that crashed are reset
+*
+* Adding and recycling pillars happens rarely and needs random numbers, so only
+* the games that need it drop out of the vector code for that. Everything else
+* (moving pillars, counting passed pillars, speeding up, bird physics and the
+* crash test) is vectorized, and so is counting the steps the difficulty table goes
+* by. A game only looks the table up when it reaches the next entry. Each game has
+* its own copy of the host's xorshift generator, which seeds its own Pcg32 at every
+* reset like random() seeds PillarManager's, so game i here plays exactly like the
+* scalar classes do after HostPlatform::seedRandom(seedOf(i)), bit for bit.
+* "flappyhost batch-verify" checks that.
+******************************/
+
+#ifndef BATCHSIM_H
+#define BATCHSIM_H
+
+#include <stdint.h>
+#include <vector>
+#include "../pillar.h"
+#include "../Random.h"
+
+class BatchSim {
+
+    public:
+
+        BatchSim(int games, int screenWidth, int screenHeight, int birdSize);
+
+        // Gives game i the seed baseSeed + i and starts every game over
+        void seed(uint32_t baseSeed);
+        uint32_t seedOf(int game) const;
+
+        void advancePillars();
+        void advanceBirds(const uint8_t *flaps); // One flag per game, at least paddedGames() of them
+        void botFlaps(uint8_t *flaps) const; // Same bot as "flappyhost headless"
+
+        // Getter methods
+        int games() const;
+        int paddedGames() const; // games() rounded up to a whole vector
+        int getBirdPosition(int game) const;
+        int getBirdDelay(int game) const;
+        int getPillarDelay(int game) const;
+        int getScore(int game) const;
+        int getBestScore(int game) const;
+        long getCrashes(int game) const;
+        long getTotalCrashes() const;
+        int getPillarCount(int game) const;
+        int getPillarX(int game, int pillar) const;
+
+        // Which instruction set the kernels were compiled for, and how many ints it handles at once
+        static const char *simdName();
+        static int simdLanes();
+
+    private:
+
+        static const int _MAX_PILLARS = MAX_AMOUNT_OF_PILLARS_ON_SCREEN;
+
+        // The same constants as Bird, Pillar and PillarManager. batch-verify fails if they drift apart
+        static const int _PILLAR_WIDTH = DefaultGameConfig::PILLAR_WIDTH;
+        static const int _BIRD_SPACE = DefaultGameConfig::BIRD_SPACE;
+        static const int _MIN_HEIGHT_OF_PILLARS = DefaultGameConfig::MIN_HEIGHT_OF_PILLARS;
+        static const int _MIN_PILLAR_BETWEEN_PILLAR_SPACE = DefaultGameConfig::MIN_PILLAR_BETWEEN_PILLAR_SPACE;
+
+        int _games;
+        int _stride; // _games rounded up to a whole vector
+        int _screenWidth;
+        int _screenHeight;
+        int _birdSize;
+        uint32_t _baseSeed;
+
+        // ======== One entry per game ========
+        // Bird
+        std::vector<int32_t> _birdPosition;
+        std::vector<int32_t> _birdDelay;
+        std::vector<double> _gravitationalDelay;
+        std::vector<double> _flapDelay;
+        // PillarManager
+        std::vector<int32_t> _pillarCount;
+        std::vector<int32_t> _score;
+        std::vector<int32_t> _levelUps;
+        std::vector<int32_t> _levelUpScore; // Difficulty::LEVEL_UPS[_levelUps], or more than any score once the table is done
+        std::vector<int32_t> _isGoneButHasntReachedYet;
+        std::vector<int32_t> _steps;
+        std::vector<int32_t> _delayIndex;
+        std::vector<int32_t> _nextDelayStep; // Where the next entry of Difficulty::DELAYS starts
+        std::vector<int32_t> _pillarDelay;
+        std::vector<uint32_t> _randomState; // The host's random(), for the seeds
+        std::vector<Pcg32> _random; // The heights
+        // Pillars, slot major: pillar s of game i is at [s * _stride + i]. Slot 0 is the leftmost
+        std::vector<int32_t> _pillarX;
+        std::vector<int32_t> _pillarHeight; // Height of the top pillar. The bottom one starts BIRD_SPACE below it
+        // Results
+        std::vector<int32_t> _crashed; // All ones for the games that crashed in the last step
+        std::vector<int32_t> _bestScore;
+        std::vector<long> _crashes;
+        long _totalCrashes;
+
+        // Scalar per-game work
+        void _resetGame(int game);
+        void _addPillarsIfNeeded(int game);
+        bool _lastPillarIsFarEnoughToAddNew(int game) const;
+        void _appendExtraPillar(int game);
+        void _recycleFirstPillar(int game);
+        void _nextDelay(int game); // Moves on to the next entry of Difficulty::DELAYS
+        int _generateRandomHeight(int game);
+        uint32_t _hostRandom(int game);
+};
+
+#endif
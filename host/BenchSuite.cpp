@@ -0,0 +1,617 @@
+/******************************************************************************
+BenchSuite.cpp
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+#include "BenchSuite.h"
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <time.h>
+#include <vector>
+
+#include "Arduino/Arduino.h"
+#include "HostPlatform.h"
+#include "SparkFunMicroOLED/SparkFunMicroOLED.h"
+#include "../FlappyGame.h"
+
+// ================== Counting allocations ============================
+
+// Every operator new in the program comes through here, so a benchmark can tell if the
+// code it runs allocates. new[] and the nothrow ones call this one
+static unsigned long long allocations = 0;
+
+void *operator new(size_t size) {
+    allocations++;
+    void *memory = malloc(size ? size : 1);
+    if (memory == NULL) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept {
+    free(memory);
+}
+
+unsigned long long getAllocationCount() {
+    return allocations;
+}
+
+// ================== Timing ============================
+
+static const double BATCH_SECONDS = 0.02; // A batch has to take this long to be worth timing
+static const int BATCHES = 5;
+static const int PASSES = 3; // The whole suite runs this many times, so a slow moment of the computer only hits one pass
+
+// The benchmarks add their results to this, so the compiler can't drop the calls
+static volatile int sink = 0;
+
+struct BenchResult {
+    std::string name;
+    const char *kind; // "micro" or "macro"
+    double nsPerOp;
+    double allocsPerOp;
+    double displayBytesPerOp;
+    long ops; // In each batch
+};
+
+typedef void (*BenchBody)(void *context, long ops);
+
+static double secondsNow() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static unsigned long displayBytes(MicroOLED *oled) {
+    return (oled == NULL) ? 0 : oled->getDataBytes() + oled->getCommandBytes();
+}
+
+// Doubles the ops until one batch takes long enough, then keeps the fastest of a few batches.
+// With fixedOps every batch is that many ops instead
+static BenchResult measure(const std::string &name, const char *kind, BenchBody body, void *context, MicroOLED *oled, long fixedOps = 0) {
+    long ops = (fixedOps > 0) ? fixedOps : 1;
+    while (fixedOps == 0) {
+        double start = secondsNow();
+        body(context, ops);
+        if (secondsNow() - start >= BATCH_SECONDS || ops >= (1L << 40)) {
+            break;
+        }
+        ops *= 2;
+    }
+
+    unsigned long long allocationsBefore = allocations;
+    unsigned long bytesBefore = displayBytes(oled);
+    double best = 1e300;
+    for (int batch = 0; batch < BATCHES; batch++) {
+        double start = secondsNow();
+        body(context, ops);
+        double seconds = secondsNow() - start;
+        best = (seconds < best) ? seconds : best;
+    }
+    unsigned long long allocationsMade = allocations - allocationsBefore; // Before the result's name is copied, which allocates
+    unsigned long bytesSent = displayBytes(oled) - bytesBefore;
+
+    BenchResult result;
+    result.name = name;
+    result.kind = kind;
+    result.nsPerOp = best * 1e9 / ops;
+    result.allocsPerOp = (double)allocationsMade / ((double)ops * BATCHES);
+    result.displayBytesPerOp = (double)bytesSent / ((double)ops * BATCHES);
+    result.ops = ops;
+    return result;
+}
+
+// ================== Micro benchmarks ============================
+
+// Three pairs of pillars spread over the screen, the most the 64x48 config has
+static PillarManager::State threePillars() {
+    PillarManager manager;
+    manager.seedRandom(1);
+    manager.reset();
+    PillarManager::State state = manager.getState();
+    const int xs[] = {4, 26, 48};
+    const int heights[] = {10, 14, 6};
+    state.pillarCount = 3;
+    for (int i = 0; i < 3; i++) {
+        state.pillarX[i] = (int16_t)xs[i];
+        state.pillarHeight[i] = (uint8_t)heights[i];
+    }
+    return state;
+}
+
+struct PillarBench {
+    PillarManager manager;
+    PillarManager::State state; // The one each step starts from, for the restored ones
+};
+
+static void benchPillarRects(void *context, long ops) {
+    const PillarRing &pillars = ((PillarBench *)context)->manager.getPillars();
+    int total = 0;
+    int i = 0;
+    for (long op = 0; op < ops; op++) {
+        PillarRects rects = pillars[i].getPillarRects();
+        total += rects.up.height + rects.down.y;
+        i = (i + 1 == pillars.size()) ? 0 : i + 1;
+    }
+    sink += total;
+}
+
+static void benchTimeToMove(void *context, long ops) {
+    PillarManager &manager = ((PillarBench *)context)->manager;
+    int total = 0;
+    for (long op = 0; op < ops; op++) {
+        total += manager.timeToMove().size();
+    }
+    sink += total;
+}
+
+static void benchRestoredStep(void *context, long ops) {
+    PillarBench *bench = (PillarBench *)context;
+    int total = 0;
+    for (long op = 0; op < ops; op++) {
+        bench->manager.setState(bench->state);
+        total += bench->manager.timeToMove().size();
+    }
+    sink += total;
+}
+
+// A state one step before the first pillar is recycled and a new one added, or one where
+// nothing is added at all
+static PillarManager::State stepState(bool isRecycling) {
+    PillarManager manager;
+    manager.seedRandom(2);
+    manager.reset();
+    while (true) {
+        PillarManager::State before = manager.getState();
+        manager.timeToMove();
+        PillarManager::State after = manager.getState();
+        bool isRecycled = before.pillarCount > 0 && before.pillarX[0] == 0;
+        bool isAppended = after.pillarCount >= before.pillarCount;
+        if (isRecycling ? (isRecycled && isAppended) : (before.pillarCount == 3 && before.pillarX[0] > 1)) {
+            return before;
+        }
+    }
+}
+
+struct BirdBench {
+    static const int POSITIONS = 40;
+    Bird birds[POSITIONS]; // The same bird at every height the screen has room for
+    PillarManager manager;
+};
+
+static void benchBirdCrashed(void *context, long ops) {
+    BirdBench *bench = (BirdBench *)context;
+    const PillarRing &pillars = bench->manager.getPillars();
+    int total = 0;
+    int i = 0;
+    for (long op = 0; op < ops; op++) {
+        total += bench->birds[i].birdCrashed(pillars);
+        i = (i + 1 == BirdBench::POSITIONS) ? 0 : i + 1;
+    }
+    sink += total;
+}
+
+static void benchUserInput(void *context, long ops) {
+    Bird &bird = ((BirdBench *)context)->birds[0];
+    int total = 0;
+    for (long op = 0; op < ops; op++) {
+        bird.userInput((op & 7) < 3); // 3 flaps, then 5 falls
+        if ((op & 63) == 63) {
+            bird.reset(); // So the delays don't run off
+        }
+        total += bird.getDelay();
+    }
+    sink += total;
+}
+
+struct DrawBench {
+    MicroOLED oled;
+    Raster raster;
+    CourseRenderer course;
+    SpriteAtlas atlas;
+    NumberText text;
+    DisplayFlusher flusher;
+    PillarManager manager;
+    uint8_t frames[2][LCDWIDTH * LCDPAGES]; // Two frames in a row of a game, for the flush
+
+    DrawBench() :
+        oled(MODE_SPI, D7, D6, A2),
+        raster(oled.getScreenBuffer(), LCDWIDTH, LCDHEIGHT),
+        course(raster),
+        atlas(oled),
+        flusher(oled) {
+    }
+};
+
+// x, y, width and height of some rects all over the screen, some of them cut off by its edges
+static void benchRect(int op, int &x, int &y, int &width, int &height) {
+    x = (op * 7) % (LCDWIDTH + 8) - 4;
+    y = (op * 5) % (LCDHEIGHT + 8) - 4;
+    width = 1 + (op * 3) % 20;
+    height = 1 + (op * 11) % 30;
+}
+
+static void benchFillRect(void *context, long ops) {
+    Raster &raster = ((DrawBench *)context)->raster;
+    for (long op = 0; op < ops; op++) {
+        int x, y, width, height;
+        benchRect((int)(op & 1023), x, y, width, height);
+        raster.fillRect(x, y, width, height, (op & 1) == 0);
+    }
+    sink += raster.getBuffer()[0];
+}
+
+static void benchOutline(void *context, long ops) {
+    Raster &raster = ((DrawBench *)context)->raster;
+    for (long op = 0; op < ops; op++) {
+        int x, y, width, height;
+        benchRect((int)(op & 1023), x, y, width, height);
+        raster.rect(x, y, width, height, (op & 1) == 0);
+    }
+    sink += raster.getBuffer()[0];
+}
+
+static void benchBlit(void *context, long ops) {
+    DrawBench *bench = (DrawBench *)context;
+    Sprite bird = bench->atlas.getBird();
+    for (long op = 0; op < ops; op++) {
+        bench->raster.blit(bird, (int)(op % 61) - 2, (int)(op % 45) - 2, (op & 1) == 0);
+    }
+    sink += bench->raster.getBuffer()[0];
+}
+
+static void benchClear(void *context, long ops) {
+    Raster &raster = ((DrawBench *)context)->raster;
+    for (long op = 0; op < ops; op++) {
+        raster.clear();
+    }
+    sink += raster.getBuffer()[0];
+}
+
+static void benchCourseDraw(void *context, long ops) {
+    DrawBench *bench = (DrawBench *)context;
+    Sprite bird = bench->atlas.getBird();
+    for (long op = 0; op < ops; op++) {
+        // A pillar step, with the bird on top like in the game, so its columns get put back too
+        const PillarRing &pillars = bench->manager.timeToMove();
+        bench->course.draw(pillars, bench->manager.getSteps());
+        bench->course.blit(bird, DefaultGameConfig::BIRD_X - FLAPPY_SIZE, 12 + (int)(op % 16), false);
+    }
+    sink += bench->raster.getBuffer()[0];
+}
+
+static void benchNumberText(void *context, long ops) {
+    DrawBench *bench = (DrawBench *)context;
+    for (long op = 0; op < ops; op++) {
+        bench->text.set(bench->atlas, (int)(op & 1023));
+    }
+    sink += bench->text.getSprite().width;
+}
+
+static void benchFlush(void *context, long ops) {
+    DrawBench *bench = (DrawBench *)context;
+    for (long op = 0; op < ops; op++) {
+        memcpy(bench->oled.getScreenBuffer(), bench->frames[op & 1], sizeof(bench->frames[0]));
+        bench->flusher.flush();
+    }
+}
+
+// ================== Macro benchmarks ============================
+
+struct GameBench {
+    MicroOLED oled;
+    FlappyGame game;
+    GameSnapshot level; // Every round starts from this
+    unsigned long rounds;
+
+    explicit GameBench(MotionMode mode) :
+        oled(MODE_SPI, D7, D6, A2),
+        game(oled, D0, mode) {
+        rounds = 0;
+    }
+};
+
+// Holds the button whenever the bird is below the middle of the gap it is heading for,
+// like the bot in main.cpp
+static bool benchBot(unsigned long now, void *context) {
+    (void)now;
+    FlappyGame *game = (FlappyGame *)context;
+    const PillarRing &pillars = game->getPillarManager().getPillars();
+    int target = DefaultGameConfig::SCREEN_HEIGHT / 2;
+    for (int i = 0; i < pillars.size(); i++) {
+        if (pillars[i].getXEnd() >= DefaultGameConfig::BIRD_X - DefaultGameConfig::BIRD_SIZE) {
+            target = (pillars[i].getGapTop() + pillars[i].getGapBottom()) / 2;
+            break;
+        }
+    }
+    return game->getBird().getBirdPosition() > target;
+}
+
+static void startLevelRound(GameBench *bench) {
+    // Every round gets other pillars, from the same spot in the difficulty table
+    GameSnapshot round = bench->level;
+    round.pillars.randomState += (uint64_t)bench->rounds * 0x9E3779B97F4A7C15ull;
+    bench->rounds++;
+    bench->game.restore(round);
+}
+
+// One op is one second of game. Every batch plays the same rounds, so they can be compared
+static void benchGame(void *context, long ops) {
+    GameBench *bench = (GameBench *)context;
+    bench->rounds = 0;
+    startLevelRound(bench);
+    unsigned long end = millis() + (unsigned long)ops * 1000;
+    while (millis() < end) {
+        if (bench->game.getState() != PLAYING) {
+            startLevelRound(bench); // Crashed. Straight into the next round, without the screens
+        }
+        unsigned long before = millis();
+        bench->game.loop();
+        if (millis() == before) {
+            HostPlatform::advanceMillis(1);
+        }
+    }
+}
+
+// Each batch plays this long, always the same rounds, so the bytes come out the same every time
+static const long GAME_SECONDS = 200;
+
+static void runGameBenches(std::vector<BenchResult> &results) {
+    typedef DefaultGameConfig::Difficulty Difficulty;
+    const char *flashPath = "flappy_bench_flash.bin";
+
+    // The start, the end, and two levels in between
+    int levels[4] = {0, Difficulty::DELAY_COUNT / 3, 2 * Difficulty::DELAY_COUNT / 3, Difficulty::DELAY_COUNT - 1};
+    for (int m = 0; m < 2; m++) {
+        MotionMode mode = (m == 0) ? PIXEL_STEPS : TIMED_PHYSICS;
+        for (int l = 0; l < 4; l++) {
+            if (l > 0 && levels[l] == levels[l - 1]) {
+                continue; // A short table
+            }
+            remove(flashPath);
+            Flashee::Devices::setHostFile(flashPath);
+            HostPlatform::setMillis(0);
+            HostPlatform::seedRandom(1);
+
+            GameBench *bench = new GameBench(mode); // On the heap, the autopilot's beams make the game big
+            HostPlatform::setButtonScript(benchBot, &bench->game);
+            bench->game.useDisplayDma(D6, A2); // Like the sketch
+            bench->game.begin();
+            bench->level = bench->game.snapshot();
+            bench->level.pillars.steps = Difficulty::DELAYS[levels[l]].fromStep;
+            bench->level.pillars.delayIndex = (uint8_t)levels[l];
+
+            char name[64];
+            snprintf(name, sizeof(name), "game.%s.delay_%dms", (mode == PIXEL_STEPS) ? "pixel" : "physics",
+                     Difficulty::DELAYS[levels[l]].delay);
+            results.push_back(measure(name, "macro", benchGame, bench, &bench->oled, GAME_SECONDS));
+
+            while (bench->game.getDisplayFlusher().isBusy()) {
+                HostPlatform::advanceMillis(1); // Nothing may call back into the game once it is gone
+            }
+            HostPlatform::setButtonScript(NULL, NULL);
+            delete bench;
+        }
+    }
+    remove(flashPath);
+    Flashee::Devices::setHostFile("flappy_flash.bin");
+}
+
+// ================== Results ============================
+
+// Without times, ns_per_op is 0 for every benchmark, and compare() only goes by the counts
+static bool writeJson(const char *path, const std::vector<BenchResult> &results, bool withTimes) {
+    FILE *out = fopen(path, "w");
+    if (out == NULL) {
+        return false;
+    }
+    // One benchmark per line, which is also how readBaseline() reads it back
+    fprintf(out, "{\n  \"suite\": \"flappyhost bench\",\n  \"config_hash\": \"%08lx\",\n  \"benchmarks\": [\n",
+            (unsigned long)DefaultGameConfig::hash());
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult &r = results[i];
+        fprintf(out, "    {\"name\": \"%s\", \"kind\": \"%s\", \"ns_per_op\": %.3f, \"allocs_per_op\": %.6f, "
+                     "\"display_bytes_per_op\": %.3f, \"ops_per_batch\": %ld}%s\n",
+                r.name.c_str(), r.kind, withTimes ? r.nsPerOp : 0.0, r.allocsPerOp, r.displayBytesPerOp, r.ops,
+                (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    fclose(out);
+    return true;
+}
+
+// The number after "key": on the line, or -1 when it isn't there
+static double jsonNumber(const char *line, const char *key) {
+    const char *at = strstr(line, key);
+    if (at == NULL) {
+        return -1;
+    }
+    at = strchr(at + strlen(key), ':');
+    return (at == NULL) ? -1 : strtod(at + 1, NULL);
+}
+
+// Reads a file writeJson() wrote. False if there is no such file
+static bool readBaseline(const char *path, std::vector<BenchResult> &baseline) {
+    FILE *in = fopen(path, "r");
+    if (in == NULL) {
+        return false;
+    }
+    char line[512];
+    while (fgets(line, sizeof(line), in) != NULL) {
+        const char *name = strstr(line, "\"name\": \"");
+        if (name == NULL) {
+            continue;
+        }
+        name += strlen("\"name\": \"");
+        const char *nameEnd = strchr(name, '"');
+        if (nameEnd == NULL) {
+            continue;
+        }
+        BenchResult r;
+        r.name.assign(name, nameEnd - name);
+        r.kind = "";
+        r.nsPerOp = jsonNumber(line, "\"ns_per_op\"");
+        r.allocsPerOp = jsonNumber(line, "\"allocs_per_op\"");
+        r.displayBytesPerOp = jsonNumber(line, "\"display_bytes_per_op\"");
+        r.ops = 0;
+        baseline.push_back(r);
+    }
+    fclose(in);
+    return true;
+}
+
+// Prints each benchmark next to its baseline. Returns how many regressed. Display bytes
+// don't depend on the computer, so any more than the baseline is a regression
+static int compare(const std::vector<BenchResult> &results, const std::vector<BenchResult> &baseline,
+                   const char *baselinePath, double thresholdPercent) {
+    printf("\n%-40s %12s %12s %9s  %s\n", baselinePath, "ns/op", "baseline", "change", "");
+    int regressions = 0;
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult &r = results[i];
+        const BenchResult *base = NULL;
+        for (size_t j = 0; j < baseline.size(); j++) {
+            if (baseline[j].name == r.name) {
+                base = &baseline[j];
+                break;
+            }
+        }
+        if (base == NULL) {
+            printf("%-40s %12.1f %12s %9s  new\n", r.name.c_str(), r.nsPerOp, "-", "-");
+            continue;
+        }
+        double limit = 1 + thresholdPercent / 100;
+        const char *verdict = "ok";
+        if (base->nsPerOp > 0 && r.nsPerOp > base->nsPerOp * limit) {
+            verdict = "SLOWER";
+        } else if (r.displayBytesPerOp > base->displayBytesPerOp + 0.01) {
+            verdict = "SENDS MORE";
+        }
+        if (strcmp(verdict, "ok") != 0) {
+            regressions++;
+        }
+        if (base->nsPerOp > 0) {
+            printf("%-40s %12.1f %12.1f %+8.1f%%  %s\n", r.name.c_str(), r.nsPerOp, base->nsPerOp,
+                   (r.nsPerOp / base->nsPerOp - 1) * 100, verdict);
+        } else {
+            printf("%-40s %12.1f %12s %9s  %s\n", r.name.c_str(), r.nsPerOp, "-", "-", verdict);
+        }
+    }
+    return regressions;
+}
+
+// ================================ Public Methods ================================
+
+// Every benchmark once, in the same order every time
+static void runPass(std::vector<BenchResult> &results) {
+    PillarBench pillars;
+    pillars.manager.setState(threePillars());
+    results.push_back(measure("pillar.getPillarRects", "micro", benchPillarRects, &pillars, NULL));
+    pillars.manager.seedRandom(1);
+    pillars.manager.reset();
+    results.push_back(measure("pillar_manager.timeToMove", "micro", benchTimeToMove, &pillars, NULL));
+    pillars.state = stepState(true);
+    results.push_back(measure("pillar_manager.step_recycling", "micro", benchRestoredStep, &pillars, NULL));
+    pillars.state = stepState(false);
+    results.push_back(measure("pillar_manager.step_restored", "micro", benchRestoredStep, &pillars, NULL));
+
+    BirdBench birds;
+    birds.manager.setState(threePillars());
+    for (int i = 0; i < BirdBench::POSITIONS; i++) {
+        Bird::State state = birds.birds[i].getState();
+        state.position = (int16_t)(4 + i);
+        birds.birds[i].setState(state);
+    }
+    results.push_back(measure("bird.birdCrashed", "micro", benchBirdCrashed, &birds, NULL));
+    results.push_back(measure("bird.userInput", "micro", benchUserInput, &birds, NULL));
+
+    DrawBench drawBench;
+    DrawBench *draw = &drawBench;
+    draw->oled.begin();
+    draw->atlas.build(FLAPPY_SIZE);
+    results.push_back(measure("raster.fillRect", "micro", benchFillRect, draw, NULL));
+    results.push_back(measure("raster.rect", "micro", benchOutline, draw, NULL));
+    results.push_back(measure("raster.blit", "micro", benchBlit, draw, NULL));
+    results.push_back(measure("raster.clear", "micro", benchClear, draw, NULL));
+    draw->manager.seedRandom(3);
+    draw->manager.reset();
+    draw->course.clear();
+    results.push_back(measure("course_renderer.draw", "micro", benchCourseDraw, draw, NULL));
+    results.push_back(measure("number_text.set", "micro", benchNumberText, draw, NULL));
+    // Two frames one pillar step apart, with the bird moved by a pixel
+    for (int f = 0; f < 2; f++) {
+        const PillarRing &ring = draw->manager.timeToMove();
+        draw->course.draw(ring, draw->manager.getSteps());
+        draw->course.blit(draw->atlas.getBird(), DefaultGameConfig::BIRD_X - FLAPPY_SIZE, 20 + f, false);
+        memcpy(draw->frames[f], draw->oled.getScreenBuffer(), sizeof(draw->frames[f]));
+    }
+    results.push_back(measure("display_flusher.flush", "micro", benchFlush, draw, &draw->oled));
+
+    runGameBenches(results);
+}
+
+int runBenchSuite(const char *outPath, bool withTimes, double thresholdPercent, int baselineCount, char **baselinePaths) {
+    // The fastest time of any pass, and the most allocations and bytes
+    std::vector<BenchResult> results;
+    for (int pass = 0; pass < PASSES; pass++) {
+        std::vector<BenchResult> passResults;
+        runPass(passResults);
+        for (size_t i = 0; i < passResults.size(); i++) {
+            if (pass == 0) {
+                results.push_back(passResults[i]);
+                continue;
+            }
+            BenchResult &r = results[i];
+            const BenchResult &p = passResults[i];
+            if (p.nsPerOp < r.nsPerOp) {
+                r.nsPerOp = p.nsPerOp;
+                r.ops = p.ops;
+            }
+            r.allocsPerOp = (p.allocsPerOp > r.allocsPerOp) ? p.allocsPerOp : r.allocsPerOp;
+            r.displayBytesPerOp = (p.displayBytesPerOp > r.displayBytesPerOp) ? p.displayBytesPerOp : r.displayBytesPerOp;
+        }
+    }
+
+    printf("%-40s %12s %10s %10s\n", "benchmark", "ns/op", "allocs/op", "bytes/op");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult &r = results[i];
+        printf("%-40s %12.1f %10.3f %10.1f\n", r.name.c_str(), r.nsPerOp, r.allocsPerOp, r.displayBytesPerOp);
+    }
+
+    // The game never allocates after begin(), so that needs no baseline
+    int allocating = 0;
+    for (size_t i = 0; i < results.size(); i++) {
+        if (results[i].allocsPerOp > 0) {
+            printf("%s allocates\n", results[i].name.c_str());
+            allocating++;
+        }
+    }
+
+    if (!writeJson(outPath, results, withTimes)) {
+        printf("can't write %s\n", outPath);
+        return 1;
+    }
+    printf("wrote %s\n", outPath);
+
+    int failed = allocating;
+    for (int b = 0; b < baselineCount; b++) {
+        std::vector<BenchResult> baseline;
+        if (!readBaseline(baselinePaths[b], baseline)) {
+            printf("no baseline at %s\n", baselinePaths[b]);
+            failed++;
+            continue;
+        }
+        int regressions = compare(results, baseline, baselinePaths[b], thresholdPercent);
+        if (regressions > 0) {
+            printf("%d of %d benchmarks regressed against %s\n", regressions, (int)results.size(), baselinePaths[b]);
+        } else {
+            printf("nothing regressed against %s\n", baselinePaths[b]);
+        }
+        failed += regressions;
+    }
+    return (failed > 0) ? 1 : 0;
+}
@@ -0,0 +1,53 @@
+/******************************************************************************
+BenchSuite.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * One benchmark for everything * *
+* The other modes of flappyhost each time one thing, print it, and are forgotten.
+* Nothing notices when a change makes a hot path slower. This suite times all the
+* hot paths the same way, writes the numbers to a JSON file, and compares them with
+* baseline files written the same way.
+*
+* Micro benchmarks run one call over and over:
+*   pillar.getPillarRects, pillar_manager.timeToMove, bird.birdCrashed,
+*   bird.userInput, the Raster calls, CourseRenderer::draw(), NumberText::set()
+*   and DisplayFlusher::flush() sending to the OLED stand-in.
+* _addPillarsIfNeeded() is private, so it is timed as a step that has to recycle
+* the first pillar and add a new one (pillar_manager.step_recycling), next to the
+* same restore and a step that doesn't (pillar_manager.step_restored). The
+* difference between the two is what adding the pillar costs.
+*
+* Macro benchmarks play the whole FlappyGame with a bot against the virtual clock,
+* starting every round at one level of the difficulty table (see Difficulty.h), in
+* both modes. One op is one second of game.
+*
+* For each one it reports:
+*   ns_per_op             the fastest of a few batches, each long enough to time
+*   allocs_per_op         calls to operator new. The game never allocates, so
+*                         anything above 0 is a regression on its own
+*   display_bytes_per_op  command and data bytes the OLED stand-in received
+*
+* Allocations and display bytes don't depend on the computer. Any allocation is a
+* regression without a baseline, and bench_counts.json in this folder has the
+* display bytes (and no times), so `make bench` always has something to fail on.
+* Against a baseline with times, a benchmark is also a regression when it is more
+* than thresholdPercent slower. Those only compare on the computer (and the build)
+* the baseline came from, so bench_baseline.json isn't kept in git.
+******************************/
+
+#ifndef BENCHSUITE_H
+#define BENCHSUITE_H
+
+// Runs everything and writes outPath, with the times or only the counts, then compares
+// against every baseline file. Returns 0, or 1 if anything allocated, regressed against
+// a baseline, or a baseline file isn't there
+int runBenchSuite(const char *outPath, bool withTimes, double thresholdPercent, int baselineCount, char **baselinePaths);
+
+// Calls to operator new anywhere in the program so far. The suite and `flappyhost alloc-verify`
+// both go by it
+unsigned long long getAllocationCount();
+
+#endif
@@ -0,0 +1,236 @@
+/******************************************************************************
+HostPlatform.cpp
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+#include "HostPlatform.h"
+#include "Arduino/Arduino.h"
+
+static unsigned long virtualMillis = 0;
+static uint32_t randomState = 2463534242u; // Any non-zero starting point works for xorshift
+static HostPlatform::ButtonScript buttonScript = 0;
+static void *buttonContext = 0;
+
+static void (*interruptHandler)() = 0;
+static bool interruptsOn = true;
+static bool interruptWaiting = false; // The pin changed while interrupts were off
+static bool lastLevel = false;
+
+static const int PIN_COUNT = 32;
+static uint8_t pinLevels[PIN_COUNT];
+
+// The SPI bus. Times are in ns since the clock started, so a transfer can end between two ms
+static HostPlatform::SpiDevice spiDevice = 0;
+static void *spiContext = 0;
+static uint16_t spiDcPin = 0;
+static unsigned long spiBitsPerSecond = 8000000;
+static bool spiBusy = false;
+static const uint8_t *spiBytes = 0;
+static size_t spiLength = 0;
+static bool spiIsData = false;
+static wiring_spi_dma_transfercomplete_callback_t spiCallback = 0;
+static unsigned long long spiDoneAt = 0; // When the transfer in flight ends, or the last one ended
+static unsigned long long spiBusyNanos = 0;
+static bool inSpiCallback = false;
+
+// Hands over every transfer that is done by now. A callback that starts the next one
+// starts it when the one before ended, like it would on the Photon
+static void finishSpiTransfers() {
+    while (spiBusy && spiDoneAt <= (unsigned long long)virtualMillis * 1000000) {
+        spiBusy = false;
+        if (spiDevice != 0) {
+            for (size_t i = 0; i < spiLength; i++) {
+                spiDevice(spiBytes[i], spiIsData, spiContext);
+            }
+        }
+        if (spiCallback != 0) {
+            inSpiCallback = true;
+            spiCallback();
+            inSpiCallback = false;
+        }
+    }
+}
+
+// Moves the clock 1 ms at a time while there is an interrupt or a transfer, and calls
+// the interrupt whenever the button changes
+static void moveClock(unsigned long ms) {
+    if (interruptHandler == 0 && !spiBusy) {
+        virtualMillis += ms;
+        return;
+    }
+    for (unsigned long i = 0; i < ms; i++) {
+        virtualMillis++;
+        finishSpiTransfers();
+        if (interruptHandler == 0) {
+            continue;
+        }
+        bool level = digitalRead(0);
+        if (level == lastLevel) {
+            continue;
+        }
+        lastLevel = level;
+        if (interruptsOn) {
+            interruptHandler();
+        } else {
+            interruptWaiting = true;
+        }
+    }
+}
+
+// ================================ HostPlatform ================================
+
+void HostPlatform::setMillis(unsigned long now) {
+    virtualMillis = now;
+    // A new clock is a new run, so a transfer left over from the last one never ends
+    spiBusy = false;
+    spiDoneAt = 0;
+}
+
+void HostPlatform::advanceMillis(unsigned long ms) {
+    moveClock(ms);
+}
+
+void HostPlatform::seedRandom(uint32_t seed) {
+    // Zero would get xorshift stuck at zero forever
+    randomState = (seed == 0) ? 2463534242u : seed;
+}
+
+void HostPlatform::setButtonScript(ButtonScript script, void *context) {
+    buttonScript = script;
+    buttonContext = context;
+    lastLevel = digitalRead(0); // Switching scripts is not an edge
+}
+
+bool HostPlatform::periodicPress(unsigned long now, void *context) {
+    PeriodicPress *press = (PeriodicPress *)context;
+    return (now % press->periodMs) < press->holdMs;
+}
+
+void HostPlatform::setSpiDevice(SpiDevice device, void *context, uint16_t dcPin) {
+    spiDevice = device;
+    spiContext = context;
+    spiDcPin = dcPin;
+}
+
+void HostPlatform::releaseSpiDevice(void *context) {
+    if (spiContext == context) {
+        spiDevice = 0;
+        spiContext = 0;
+    }
+}
+
+void HostPlatform::setSpiSpeed(unsigned long bitsPerSecond) {
+    spiBitsPerSecond = (bitsPerSecond == 0) ? 1 : bitsPerSecond;
+}
+
+bool HostPlatform::isSpiBusy() {
+    return spiBusy;
+}
+
+unsigned long long HostPlatform::getSpiBusyNanos() {
+    return spiBusyNanos;
+}
+
+// ============================ Arduino stand-ins ===============================
+
+unsigned long millis() {
+    return virtualMillis;
+}
+
+unsigned long micros() {
+    // A transfer's callback runs when the transfer ended, which can be between two ms
+    return inSpiCallback ? (unsigned long)(spiDoneAt / 1000) : virtualMillis * 1000;
+}
+
+void delay(unsigned long ms) {
+    // Nothing to wait for, just pretend the time went by
+    moveClock(ms);
+}
+
+static uint32_t nextRandom() {
+    // xorshift32
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+long random(long max) {
+    if (max <= 0) {
+        return 0;
+    }
+    return nextRandom() % max;
+}
+
+long random(long min, long max) {
+    // Same contract as the platform: min is included, max is not
+    if (min >= max) {
+        return min;
+    }
+    return min + random(max - min);
+}
+
+void randomSeed(unsigned int seed) {
+    HostPlatform::seedRandom(seed);
+}
+
+void pinMode(uint16_t pin, int mode) {
+    (void)pin;
+    (void)mode;
+}
+
+int32_t digitalRead(uint16_t pin) {
+    (void)pin;
+    if (buttonScript == 0) {
+        return LOW;
+    }
+    return buttonScript(virtualMillis, buttonContext) ? HIGH : LOW;
+}
+
+void digitalWrite(uint16_t pin, uint8_t value) {
+    if (pin < PIN_COUNT) {
+        pinLevels[pin] = value;
+    }
+}
+
+SPIClass SPI;
+
+void SPIClass::transfer(void *tx, void *rx, size_t length, wiring_spi_dma_transfercomplete_callback_t callback) {
+    (void)rx;
+    // The bus does one transfer at a time. From a callback, the next one starts when the last one ended
+    unsigned long long now = (unsigned long long)virtualMillis * 1000000;
+    unsigned long long start = (inSpiCallback || spiDoneAt > now) ? spiDoneAt : now;
+    unsigned long long duration = (unsigned long long)length * 8 * 1000000000ULL / spiBitsPerSecond;
+    spiBytes = (const uint8_t *)tx;
+    spiLength = length;
+    spiIsData = spiDcPin < PIN_COUNT && pinLevels[spiDcPin] == HIGH;
+    spiCallback = callback;
+    spiDoneAt = start + duration;
+    spiBusyNanos += duration;
+    spiBusy = true;
+}
+
+bool attachInterrupt(uint16_t pin, void (*handler)(), InterruptMode mode) {
+    (void)mode;
+    interruptHandler = handler;
+    lastLevel = digitalRead(pin);
+    return true;
+}
+
+void detachInterrupt(uint16_t pin) {
+    (void)pin;
+    interruptHandler = 0;
+}
+
+void noInterrupts() {
+    interruptsOn = false;
+}
+
+void interrupts() {
+    interruptsOn = true;
+    if (interruptWaiting && interruptHandler != 0) {
+        interruptWaiting = false;
+        interruptHandler();
+    }
+}
@@ -0,0 +1,55 @@
+/******************************************************************************
+HostPlatform.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+// Controls for the host stand-ins of millis(), random() and digitalRead(). The game
+// code never includes this, only the host drivers do
+
+#ifndef HOSTPLATFORM_H
+#define HOSTPLATFORM_H
+
+#include <stdint.h>
+
+namespace HostPlatform {
+
+    // ==================== Virtual clock ====================
+    // millis() returns this. It only moves when delay() is called or when the driver
+    // moves it, so a game runs as fast as the computer can go. With an interrupt
+    // attached it moves 1 ms at a time, so the interrupt sees every change of the script,
+    // and so does it while an SPI transfer is going. setMillis() drops that transfer
+    void setMillis(unsigned long now);
+    void advanceMillis(unsigned long ms);
+
+    // ==================== Seeded RNG =======================
+    // random() is a xorshift generator, so the same seed gives the same pillars
+    void seedRandom(uint32_t seed);
+
+    // ==================== Scripted input ===================
+    // digitalRead() of any pin calls the script with the current virtual time. With
+    // no script the button is never pressed
+    typedef bool (*ButtonScript)(unsigned long now, void *context);
+    void setButtonScript(ButtonScript script, void *context);
+
+    // A ready made script: the button is held for holdMs at the start of every periodMs
+    struct PeriodicPress {
+        unsigned long periodMs;
+        unsigned long holdMs;
+    };
+    bool periodicPress(unsigned long now, void *context); // context is a PeriodicPress*
+
+    // ==================== SPI bus ==========================
+    // The bytes of SPI.transfer() go to this device when the transfer is done, each
+    // with the level its DC pin had when the transfer started (HIGH is data). Only one
+    // device, like the one screen on the Photon's bus
+    typedef void (*SpiDevice)(uint8_t byte, bool isData, void *context);
+    void setSpiDevice(SpiDevice device, void *context, uint16_t dcPin);
+    void releaseSpiDevice(void *context); // Only if it is still the one set
+    // How fast the bytes go. 8 MHz unless it is set
+    void setSpiSpeed(unsigned long bitsPerSecond);
+    bool isSpiBusy();
+    unsigned long long getSpiBusyNanos(); // How long the bus has been sending, in total
+}
+
+#endif
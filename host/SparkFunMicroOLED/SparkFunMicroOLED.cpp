@@ -0,0 +1,404 @@
+/******************************************************************************
+SparkFunMicroOLED.cpp (host stand-in)
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+#include "SparkFunMicroOLED.h"
+#include "../HostPlatform.h"
+#include <stdlib.h>
+#include <string.h>
+
+// The panel sits in the middle of the SSD1306's 128 columns, which is why the real
+// library adds 0x02 to the high nibble of every column address
+#define COLUMN_OFFSET 32
+#define CONTROLLER_COLUMNS 128
+
+#define FONT_WIDTH 5
+#define FONT_HEIGHT 8
+#define FONT_FIRST_CHAR 32
+#define FONT_LAST_CHAR 126
+
+// 5x7 font, one byte per column, least significant bit at the top. Same glyphs as the
+// font5x7 the real library uses, for the printable ASCII characters
+static const uint8_t font5x7[][FONT_WIDTH] = {
+    {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00}, {0x14,0x7F,0x14,0x7F,0x14}, // ' ' ! " #
+    {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62}, {0x36,0x49,0x56,0x20,0x50}, {0x00,0x08,0x07,0x03,0x00}, // $ % & '
+    {0x00,0x1C,0x22,0x41,0x00}, {0x00,0x41,0x22,0x1C,0x00}, {0x2A,0x1C,0x7F,0x1C,0x2A}, {0x08,0x08,0x3E,0x08,0x08}, // ( ) * +
+    {0x00,0x80,0x70,0x30,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x00,0x60,0x60,0x00}, {0x20,0x10,0x08,0x04,0x02}, // , - . /
+    {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00}, {0x72,0x49,0x49,0x49,0x46}, {0x21,0x41,0x49,0x4D,0x33}, // 0 1 2 3
+    {0x18,0x14,0x12,0x7F,0x10}, {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x31}, {0x41,0x21,0x11,0x09,0x07}, // 4 5 6 7
+    {0x36,0x49,0x49,0x49,0x36}, {0x46,0x49,0x49,0x29,0x1E}, {0x00,0x00,0x14,0x00,0x00}, {0x00,0x40,0x34,0x00,0x00}, // 8 9 : ;
+    {0x00,0x08,0x14,0x22,0x41}, {0x14,0x14,0x14,0x14,0x14}, {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x59,0x09,0x06}, // < = > ?
+    {0x3E,0x41,0x5D,0x59,0x4E}, {0x7C,0x12,0x11,0x12,0x7C}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22}, // @ A B C
+    {0x7F,0x41,0x41,0x41,0x3E}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x09,0x01}, {0x3E,0x41,0x41,0x51,0x73}, // D E F G
+    {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00}, {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41}, // H I J K
+    {0x7F,0x40,0x40,0x40,0x40}, {0x7F,0x02,0x1C,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E}, // L M N O
+    {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46}, {0x26,0x49,0x49,0x49,0x32}, // P Q R S
+    {0x03,0x01,0x7F,0x01,0x03}, {0x3F,0x40,0x40,0x40,0x3F}, {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F}, // T U V W
+    {0x63,0x14,0x08,0x14,0x63}, {0x03,0x04,0x78,0x04,0x03}, {0x61,0x59,0x49,0x4D,0x43}, {0x00,0x7F,0x41,0x41,0x41}, // X Y Z [
+    {0x02,0x04,0x08,0x10,0x20}, {0x00,0x41,0x41,0x41,0x7F}, {0x04,0x02,0x01,0x02,0x04}, {0x40,0x40,0x40,0x40,0x40}, // \ ] ^ _
+    {0x00,0x03,0x07,0x08,0x00}, {0x20,0x54,0x54,0x78,0x40}, {0x7F,0x28,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x28}, // ` a b c
+    {0x38,0x44,0x44,0x28,0x7F}, {0x38,0x54,0x54,0x54,0x18}, {0x00,0x08,0x7E,0x09,0x02}, {0x18,0xA4,0xA4,0x9C,0x78}, // d e f g
+    {0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, {0x20,0x40,0x40,0x3D,0x00}, {0x7F,0x10,0x28,0x44,0x00}, // h i j k
+    {0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x78,0x04,0x78}, {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38}, // l m n o
+    {0xFC,0x18,0x24,0x24,0x18}, {0x18,0x24,0x24,0x18,0xFC}, {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x24}, // p q r s
+    {0x04,0x04,0x3F,0x44,0x24}, {0x3C,0x40,0x40,0x20,0x7C}, {0x1C,0x20,0x40,0x20,0x1C}, {0x3C,0x40,0x30,0x40,0x3C}, // t u v w
+    {0x44,0x28,0x10,0x28,0x44}, {0x4C,0x90,0x90,0x90,0x7C}, {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00}, // x y z {
+    {0x00,0x00,0x77,0x00,0x00}, {0x00,0x41,0x36,0x08,0x00}, {0x02,0x01,0x02,0x04,0x02}                               // | } ~
+};
+
+MicroOLED::MicroOLED(micro_oled_mode mode, uint8_t rst, uint8_t dc, uint8_t cs) :
+    _raster(_screenMemory, LCDWIDTH, LCDHEIGHT) {
+    (void)mode;
+    (void)rst;
+    (void)cs;
+    memset(_screenMemory, 0, sizeof(_screenMemory));
+    memset(_displayRam, 0, sizeof(_displayRam));
+    _foreColor = WHITE;
+    _drawMode = NORM;
+    _cursorX = 0;
+    _cursorY = 0;
+    _ramPage = 0;
+    _ramColumn = 0;
+    _commandBytes = 0;
+    _dataBytes = 0;
+    _dcPin = dc;
+}
+
+MicroOLED::~MicroOLED() {
+    HostPlatform::releaseSpiDevice(this);
+}
+
+void MicroOLED::begin() {
+    _foreColor = WHITE;
+    _drawMode = NORM;
+    _cursorX = 0;
+    _cursorY = 0;
+    // The screen that was begun last is the one on the bus
+    HostPlatform::setSpiDevice(_spiByte, this, _dcPin);
+}
+
+void MicroOLED::clear(uint8_t mode) {
+    if (mode == ALL) {
+        // Wipe the controller's RAM, like the real library does over the bus
+        for (int i = 0; i < 8; i++) {
+            setPageAddress(i);
+            setColumnAddress(0);
+            for (int j = 0; j < CONTROLLER_COLUMNS; j++) {
+                data(0);
+            }
+        }
+    } else {
+        _raster.clear();
+    }
+}
+
+void MicroOLED::clear(uint8_t mode, uint8_t c) {
+    if (mode == ALL) {
+        clear(ALL);
+    } else {
+        memset(_screenMemory, c, sizeof(_screenMemory));
+    }
+}
+
+void MicroOLED::display() {
+    // Send every page of the buffer, 64 bytes each
+    for (int i = 0; i < LCDPAGES; i++) {
+        setPageAddress(i);
+        setColumnAddress(0);
+        for (int j = 0; j < LCDWIDTH; j++) {
+            data(_screenMemory[i * LCDWIDTH + j]);
+        }
+    }
+}
+
+// ============================== Drawing ==============================
+
+void MicroOLED::setCursor(uint8_t x, uint8_t y) {
+    _cursorX = x;
+    _cursorY = y;
+}
+
+void MicroOLED::pixel(uint8_t x, uint8_t y) {
+    pixel(x, y, _foreColor, _drawMode);
+}
+
+void MicroOLED::pixel(uint8_t x, uint8_t y, uint8_t color, uint8_t mode) {
+    if (x >= LCDWIDTH || y >= LCDHEIGHT) {
+        return;
+    }
+    uint8_t bit = 1 << (y % 8);
+    uint8_t &cell = _screenMemory[x + (y / 8) * LCDWIDTH];
+    if (mode == XOR) {
+        if (color == WHITE) {
+            cell ^= bit;
+        }
+    } else if (color == WHITE) {
+        cell |= bit;
+    } else {
+        cell &= ~bit;
+    }
+}
+
+void MicroOLED::line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) {
+    line(x0, y0, x1, y1, _foreColor, _drawMode);
+}
+
+void MicroOLED::line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t color, uint8_t mode) {
+    // Bresenham, and like the real library the last point is not drawn
+    uint8_t temp;
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+        temp = x0; x0 = y0; y0 = temp;
+        temp = x1; x1 = y1; y1 = temp;
+    }
+    if (x0 > x1) {
+        temp = x0; x0 = x1; x1 = temp;
+        temp = y0; y0 = y1; y1 = temp;
+    }
+
+    uint8_t dx = x1 - x0;
+    uint8_t dy = abs(y1 - y0);
+    int8_t err = dx / 2;
+    int8_t ystep = (y0 < y1) ? 1 : -1;
+
+    for (; x0 < x1; x0++) {
+        if (steep) {
+            pixel(y0, x0, color, mode);
+        } else {
+            pixel(x0, y0, color, mode);
+        }
+        err -= dy;
+        if (err < 0) {
+            y0 += ystep;
+            err += dx;
+        }
+    }
+}
+
+void MicroOLED::lineH(uint8_t x, uint8_t y, uint8_t width) {
+    line(x, y, x + width, y, _foreColor, _drawMode);
+}
+
+void MicroOLED::lineV(uint8_t x, uint8_t y, uint8_t height) {
+    line(x, y, x, y + height, _foreColor, _drawMode);
+}
+
+void MicroOLED::rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height) {
+    rect(x, y, width, height, _foreColor, _drawMode);
+}
+
+void MicroOLED::rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t color, uint8_t mode) {
+    if (mode == NORM && width > 0 && height > 0 && x + width <= 255 && y + height <= 255) {
+        _raster.rect(x, y, width, height, color == WHITE);
+        return;
+    }
+
+    // XOR, empty rects and rects whose end wraps around in a uint8_t keep the line by line way
+    line(x, y, x + width, y, color, mode);
+    line(x, y + height - 1, x + width, y + height - 1, color, mode);
+
+    // Skip the sides when there is nothing between the two horizontal lines
+    uint8_t tempHeight = height - 2;
+    if (tempHeight < 1) {
+        return;
+    }
+    line(x, y + 1, x, y + 1 + tempHeight, color, mode);
+    line(x + width - 1, y + 1, x + width - 1, y + 1 + tempHeight, color, mode);
+}
+
+void MicroOLED::rectFill(uint8_t x, uint8_t y, uint8_t width, uint8_t height) {
+    if (_drawMode == NORM && x + width <= 256 && y + height <= 255) {
+        _raster.fillRect(x, y, width, height, _foreColor == WHITE);
+        return;
+    }
+    for (int i = x; i < x + width; i++) {
+        line(i, y, i, y + height, _foreColor, _drawMode);
+    }
+}
+
+void MicroOLED::circle(uint8_t x, uint8_t y, uint8_t radius) {
+    circle(x, y, radius, _foreColor, _drawMode);
+}
+
+void MicroOLED::circle(uint8_t x0, uint8_t y0, uint8_t radius, uint8_t color, uint8_t mode) {
+    // Midpoint circle, eight points at a time
+    int8_t f = 1 - radius;
+    int8_t ddFx = 1;
+    int8_t ddFy = -2 * radius;
+    int8_t x = 0;
+    int8_t y = radius;
+
+    pixel(x0, y0 + radius, color, mode);
+    pixel(x0, y0 - radius, color, mode);
+    pixel(x0 + radius, y0, color, mode);
+    pixel(x0 - radius, y0, color, mode);
+
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddFy += 2;
+            f += ddFy;
+        }
+        x++;
+        ddFx += 2;
+        f += ddFx;
+
+        pixel(x0 + x, y0 + y, color, mode);
+        pixel(x0 - x, y0 + y, color, mode);
+        pixel(x0 + x, y0 - y, color, mode);
+        pixel(x0 - x, y0 - y, color, mode);
+
+        pixel(x0 + y, y0 + x, color, mode);
+        pixel(x0 - y, y0 + x, color, mode);
+        pixel(x0 + y, y0 - x, color, mode);
+        pixel(x0 - y, y0 - x, color, mode);
+    }
+}
+
+void MicroOLED::drawChar(uint8_t x, uint8_t y, uint8_t c, uint8_t color, uint8_t mode) {
+    if (c < FONT_FIRST_CHAR || c > FONT_LAST_CHAR) {
+        return;
+    }
+    const uint8_t *glyph = font5x7[c - FONT_FIRST_CHAR];
+
+    // Five columns of glyph plus one blank column of margin, background pixels included
+    for (int i = 0; i < FONT_WIDTH + 1; i++) {
+        uint8_t column = (i == FONT_WIDTH) ? 0 : glyph[i];
+        for (int j = 0; j < 8; j++) {
+            pixel(x + i, y + j, (column & 0x1) ? color : !color, mode);
+            column >>= 1;
+        }
+    }
+}
+
+// ============================== Text ==============================
+
+size_t MicroOLED::write(uint8_t c) {
+    if (c == '\n') {
+        _cursorY += FONT_HEIGHT;
+        _cursorX = 0;
+    } else if (c != '\r') {
+        drawChar(_cursorX, _cursorY, c, _foreColor, _drawMode);
+        _cursorX += FONT_WIDTH + 1;
+        if (_cursorX > LCDWIDTH - FONT_WIDTH) {
+            _cursorY += FONT_HEIGHT;
+            _cursorX = 0;
+        }
+    }
+    return 1;
+}
+
+size_t MicroOLED::print(const char *text) {
+    size_t written = 0;
+    while (*text) {
+        written += write(*text++);
+    }
+    return written;
+}
+
+size_t MicroOLED::print(const String &text) {
+    return print(text.c_str());
+}
+
+size_t MicroOLED::print(int value) {
+    char digits[12];
+    snprintf(digits, sizeof(digits), "%d", value);
+    return print(digits);
+}
+
+// ============================== Getters ==============================
+
+uint8_t MicroOLED::getLCDWidth() {
+    return LCDWIDTH;
+}
+
+uint8_t MicroOLED::getLCDHeight() {
+    return LCDHEIGHT;
+}
+
+uint8_t MicroOLED::getFontWidth() {
+    return FONT_WIDTH;
+}
+
+uint8_t MicroOLED::getFontHeight() {
+    return FONT_HEIGHT;
+}
+
+void MicroOLED::setColor(uint8_t color) {
+    _foreColor = color;
+}
+
+void MicroOLED::setDrawMode(uint8_t mode) {
+    _drawMode = mode;
+}
+
+uint8_t *MicroOLED::getScreenBuffer() {
+    return _screenMemory;
+}
+
+// ========================= Controller emulation =========================
+
+void MicroOLED::command(uint8_t c) {
+    _commandBytes++;
+    // Only the page addressing mode commands the library uses are decoded
+    if ((c & 0xF8) == 0xB0) {
+        _ramPage = c & 0x07;
+    } else if ((c & 0xF0) == 0x10) {
+        _ramColumn = ((c & 0x0F) << 4) | (_ramColumn & 0x0F);
+    } else if ((c & 0xF0) == 0x00) {
+        _ramColumn = (_ramColumn & 0xF0) | (c & 0x0F);
+    }
+}
+
+void MicroOLED::data(uint8_t c) {
+    _dataBytes++;
+    // Bytes outside the 64x48 window go to controller RAM nobody can see
+    int column = _ramColumn - COLUMN_OFFSET;
+    if (_ramPage < LCDPAGES && column >= 0 && column < LCDWIDTH) {
+        _displayRam[_ramPage * LCDWIDTH + column] = c;
+    }
+    _ramColumn = (_ramColumn + 1) % CONTROLLER_COLUMNS;
+}
+
+void MicroOLED::_spiByte(uint8_t byte, bool isData, void *oled) {
+    if (isData) {
+        ((MicroOLED *)oled)->data(byte);
+    } else {
+        ((MicroOLED *)oled)->command(byte);
+    }
+}
+
+void MicroOLED::setColumnAddress(uint8_t add) {
+    command((0x10 | (add >> 4)) + 0x02);
+    command(0x0F & add);
+}
+
+void MicroOLED::setPageAddress(uint8_t add) {
+    command(0xB0 | add);
+}
+
+// ============================== Host only ==============================
+
+unsigned long MicroOLED::getCommandBytes() const {
+    return _commandBytes;
+}
+
+unsigned long MicroOLED::getDataBytes() const {
+    return _dataBytes;
+}
+
+const uint8_t *MicroOLED::getDisplayedBuffer() const {
+    return _displayRam;
+}
+
+void MicroOLED::printDisplayed(FILE *out) const {
+    for (int y = 0; y < LCDHEIGHT; y++) {
+        for (int x = 0; x < LCDWIDTH; x++) {
+            bool on = _displayRam[x + (y / 8) * LCDWIDTH] & (1 << (y % 8));
+            fputc(on ? '#' : '.', out);
+        }
+        fputc('\n', out);
+    }
+}
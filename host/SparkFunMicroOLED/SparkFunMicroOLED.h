@@ -0,0 +1,125 @@
+/******************************************************************************
+SparkFunMicroOLED.h (host stand-in)
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Host stand-in * *
+* This is NOT SparkFun's library. It keeps the same names and draws the same pixels
+* (same Bresenham lines, same midpoint circles, same 5x7 font), but instead of an
+* SPI bus it has an in-memory copy of the controller's display RAM. command() and
+* data() are decoded the way the SSD1306 would, so whatever the game "sends" ends up
+* in getDisplayedBuffer() and can be compared or printed.
+*
+* After begin() it is also the device on the host's SPI bus (see HostPlatform.h), so
+* bytes sent with SPI.transfer() reach it too, as commands or data by the DC pin.
+******************************/
+
+#ifndef HOST_SPARKFUNMICROOLED_H
+#define HOST_SPARKFUNMICROOLED_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "Arduino/Arduino.h"
+#include "../../Raster.h"
+
+#define BLACK 0
+#define WHITE 1
+
+#define LCDWIDTH 64
+#define LCDHEIGHT 48
+#define LCDPAGES (LCDHEIGHT / 8)
+
+#define NORM 0
+#define XOR 1
+
+#define PAGE 0
+#define ALL 1
+
+typedef enum {
+    MODE_SPI,
+    MODE_I2C,
+    MODE_PARALLEL
+} micro_oled_mode;
+
+class MicroOLED {
+
+    public:
+
+        MicroOLED(micro_oled_mode mode, uint8_t rst, uint8_t dc, uint8_t cs);
+        ~MicroOLED();
+
+        void begin();
+        void clear(uint8_t mode);
+        void clear(uint8_t mode, uint8_t c);
+        void display();
+
+        // Drawing, same signatures and same pixels as the real library
+        void setCursor(uint8_t x, uint8_t y);
+        void pixel(uint8_t x, uint8_t y);
+        void pixel(uint8_t x, uint8_t y, uint8_t color, uint8_t mode);
+        void line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1);
+        void line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t color, uint8_t mode);
+        void lineH(uint8_t x, uint8_t y, uint8_t width);
+        void lineV(uint8_t x, uint8_t y, uint8_t height);
+        void rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height);
+        void rect(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t color, uint8_t mode);
+        void rectFill(uint8_t x, uint8_t y, uint8_t width, uint8_t height);
+        void circle(uint8_t x, uint8_t y, uint8_t radius);
+        void circle(uint8_t x, uint8_t y, uint8_t radius, uint8_t color, uint8_t mode);
+        void drawChar(uint8_t x, uint8_t y, uint8_t c, uint8_t color, uint8_t mode);
+
+        // Text. The real class gets these from Print
+        size_t write(uint8_t c);
+        size_t print(const char *text);
+        size_t print(const String &text);
+        size_t print(int value);
+
+        uint8_t getLCDWidth();
+        uint8_t getLCDHeight();
+        uint8_t getFontWidth();
+        uint8_t getFontHeight();
+        void setColor(uint8_t color);
+        void setDrawMode(uint8_t mode);
+        uint8_t *getScreenBuffer();
+
+        // Low level controller access
+        void command(uint8_t c);
+        void data(uint8_t c);
+        void setColumnAddress(uint8_t add);
+        void setPageAddress(uint8_t add);
+
+        // ========== Host only ==========
+        // What the panel is showing, in the same page-major layout as getScreenBuffer()
+        const uint8_t *getDisplayedBuffer() const;
+        // Prints the panel as '#' and '.' so a frame can be looked at in a terminal
+        void printDisplayed(FILE *out) const;
+        // Bytes sent over the bus so far, the way SPI time is spent on the real thing
+        unsigned long getCommandBytes() const;
+        unsigned long getDataBytes() const;
+
+    private:
+
+        uint8_t _screenMemory[LCDWIDTH * LCDPAGES]; // What the game draws into
+        Raster _raster; // Rects and clears go through the game's own rasterizer, see Raster.h
+        uint8_t _displayRam[LCDWIDTH * LCDPAGES]; // What has been sent to the controller
+
+        uint8_t _foreColor;
+        uint8_t _drawMode;
+        uint8_t _cursorX;
+        uint8_t _cursorY;
+
+        // Controller address pointer, decoded from command()
+        uint8_t _ramPage;
+        uint8_t _ramColumn;
+
+        unsigned long _commandBytes;
+        unsigned long _dataBytes;
+        uint8_t _dcPin;
+
+        // A byte from the SPI bus
+        static void _spiByte(uint8_t byte, bool isData, void *oled);
+};
+
+#endif
@@ -0,0 +1,638 @@
+/******************************************************************************
+Sweep.cpp
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+#include "Sweep.h"
+#include "WorkStealingPool.h"
+#include "../Random.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+typedef DefaultGameConfig Config; // The screen, the bird and the pillars the tunings are played on
+
+static const int SPLIT_GAMES = 64; // A task with more games than this splits in two
+static const int SCORE_BINS = 1024; // The last one is that score or more
+static const uint64_t MISTAKE_SEED = 0x9E3779B97F4A7C15ull; // Keeps the bot's mistakes apart from the pillars
+static const uint32_t SAMPLE_SEED = 1; // Where a random sweep's tunings come from, so a sweep can be run again
+
+// ===== Tables =====
+
+SweepTables::SweepTables(const GameTuning &tuning) {
+    int64_t startNs = (int64_t)(tuning.pillarDelay * 1000000 + 0.5);
+    int64_t minNs = (int64_t)(tuning.minPillarDelay * 1000000 + 0.5);
+    int64_t rateNs = (int64_t)(tuning.pillarAccelerationRate * 1000000 + 0.5);
+    int64_t speedUps = linearSpeedUps(startNs, minNs, rateNs);
+    int slowest = (int)(startNs / 1000000);
+    int fastest = (int)((startNs - speedUps * rateNs) / 1000000);
+    delayCount = slowest - fastest + 1;
+    // Only a tuning without a problem() makes a real table. This keeps any other one in bounds
+    delayCount = (delayCount < 1) ? 1 : (delayCount > MAX_DELAYS) ? MAX_DELAYS : delayCount;
+    for (int i = 0; i < delayCount; i++) {
+        delays[i] = linearDelayAt(startNs, rateNs, i);
+    }
+    for (int i = 0; i < LEVEL_UP_COUNT; i++) {
+        int64_t score = linearLevelUpScore(tuning.levelUpStartingPoint, tuning.levelUpFactor, i);
+        levelUps[i] = (score > 0xFFFF) ? 0xFFFF : (uint16_t)score;
+    }
+}
+
+void SweepTables::finish(GameTuning &tuning) const {
+    tuning.derive();
+    tuning.delays = delays;
+    tuning.delayCount = delayCount;
+    tuning.levelUps = levelUps;
+    tuning.levelUpCount = LEVEL_UP_COUNT;
+}
+
+// ================================ Public Methods ================================
+
+SweepGame::SweepGame(const GameTuning &tuning) :
+    _tuning(tuning), _bird(Config::HITBOX_INSET, tuning), _pillarManager(PillarManager::State(), tuning) {
+    // Restoring an empty state never calls random(), which the threads would share
+    start(1);
+}
+
+void SweepGame::start(uint32_t seed) {
+    _bird.reset();
+    _pillarManager.seedRandom(seed);
+    _pillarManager.reset();
+
+    // Right where FlappyGame starts a round: the bird is due, the pillars a delay later
+    _game = GameSnapshot();
+    _game.nextPillars = (int16_t)_pillarManager.getDelay();
+}
+
+bool SweepGame::step(bool button) {
+    return Autopilot::step(_game, _bird, _pillarManager, button);
+}
+
+bool SweepGame::botButton() {
+    const PillarRing &pillars = _pillarManager.getPillars();
+    int target = Config::SCREEN_HEIGHT / 2;
+    for (int i = 0; i < pillars.size(); i++) {
+        if (pillars[i].getXEnd() >= Config::BIRD_X - Config::BIRD_SIZE) {
+            target = (pillars[i].getGapTop() + pillars[i].getGapBottom()) / 2;
+            break;
+        }
+    }
+    return _bird.getBirdPosition() > target;
+}
+
+// ============================ Getter methods =============================
+
+GameSnapshot SweepGame::getSnapshot() const {
+    GameSnapshot game = GameSnapshot(); // Zeroed, the padding too, like FlappyGame::snapshot()
+    game.bird = _bird.getState();
+    game.pillars = _pillarManager.getState();
+    game.roundTime = _game.roundTime;
+    game.nextBird = _game.nextBird;
+    game.nextPillars = _game.nextPillars;
+    game.flapUpTime = _game.flapUpTime;
+    game.previousFlap = _game.previousFlap;
+    return game;
+}
+
+uint32_t SweepGame::getRoundTime() const { return _game.roundTime; }
+int SweepGame::getScore() { return _pillarManager.getAmountOfPillarsUserPassed(); }
+int SweepGame::getDelayIndex() const { return _pillarManager.getState().delayIndex; }
+
+// ================================ The sweep ================================
+
+// The numbers a sweep can change, and the range a random sweep picks them from when it isn't given one
+struct SweepParameter {
+    const char *name;
+    double low;
+    double high;
+    bool isWhole;
+};
+
+static const SweepParameter PARAMETERS[] = {
+    {"BIRD_SPACE", 16, 34, true},
+    {"GRAVITATIONAL_DELAY", 35, 65, false},
+    {"FLAP_DELAY", 28, 50, false},
+    {"BIRD_ACCELERATION_RATE", 0.1, 0.5, false},
+    {"PILLAR_DELAY", 24, 40, false},
+    {"MIN_PILLAR_DELAY", 8, 16, false},
+    {"PILLAR_ACCELERATION_RATE", 0.002, 0.01, false},
+    {"MIN_PILLAR_BETWEEN_PILLAR_SPACE", 8, 30, true},
+    {"PILLARS_PASSED_TO_LEVEL_UP_STARTING_POINT", 3, 12, true},
+    {"PILLARS_PASSED_TO_LEVEL_UP_FACTOR", 1, 3, true},
+};
+static const int PARAMETER_COUNT = sizeof(PARAMETERS) / sizeof(PARAMETERS[0]);
+
+static double getParameter(const GameTuning &tuning, int parameter) {
+    switch (parameter) {
+        case 0: return tuning.birdSpace;
+        case 1: return (double)tuning.gravitationalDelay;
+        case 2: return (double)tuning.flapDelay;
+        case 3: return (double)tuning.birdAccelerationRate;
+        case 4: return tuning.pillarDelay;
+        case 5: return tuning.minPillarDelay;
+        case 6: return tuning.pillarAccelerationRate;
+        case 7: return tuning.minPillarBetweenPillarSpace;
+        case 8: return tuning.levelUpStartingPoint;
+        default: return tuning.levelUpFactor;
+    }
+}
+
+static void setParameter(GameTuning &tuning, int parameter, double value) {
+    int whole = (int)floor(value + 0.5);
+    switch (parameter) {
+        case 0: tuning.birdSpace = whole; break;
+        case 1: tuning.gravitationalDelay = BirdDelay(value); break;
+        case 2: tuning.flapDelay = BirdDelay(value); break;
+        case 3: tuning.birdAccelerationRate = BirdDelay(value); break;
+        case 4: tuning.pillarDelay = value; break;
+        case 5: tuning.minPillarDelay = value; break;
+        case 6: tuning.pillarAccelerationRate = value; break;
+        case 7: tuning.minPillarBetweenPillarSpace = whole; break;
+        case 8: tuning.levelUpStartingPoint = whole; break;
+        default: tuning.levelUpFactor = whole; break;
+    }
+}
+
+// Everything a sweep keeps about the games of one tuning. Only ever added up, so it doesn't matter which thread played what
+struct SweepStats {
+    long games;
+    long survived;
+    double scoreSum;
+    int bestScore;
+    long scores[SCORE_BINS];
+    long crashSeconds[MAX_SECONDS]; // Crashes in each second of a round
+    long reached[SweepTables::MAX_DELAYS]; // Games that got to each entry of the delay table
+    long crashedAt[SweepTables::MAX_DELAYS];
+
+    void add(SweepGame &game, bool crashed) {
+        games++;
+        scoreSum += game.getScore();
+        bestScore = (game.getScore() > bestScore) ? game.getScore() : bestScore;
+        scores[(game.getScore() < SCORE_BINS) ? game.getScore() : SCORE_BINS - 1]++;
+        // The table only goes one way, so a game went through every entry up to the one it ended at
+        for (int i = 0; i <= game.getDelayIndex(); i++) {
+            reached[i]++;
+        }
+        if (crashed) {
+            uint32_t second = game.getRoundTime() / 1000;
+            crashSeconds[(second < (uint32_t)MAX_SECONDS) ? second : MAX_SECONDS - 1]++;
+            crashedAt[game.getDelayIndex()]++;
+        } else {
+            survived++;
+        }
+    }
+
+    void merge(const SweepStats &other) {
+        games += other.games;
+        survived += other.survived;
+        scoreSum += other.scoreSum;
+        bestScore = (other.bestScore > bestScore) ? other.bestScore : bestScore;
+        for (int i = 0; i < SCORE_BINS; i++) {
+            scores[i] += other.scores[i];
+        }
+        for (int i = 0; i < MAX_SECONDS; i++) {
+            crashSeconds[i] += other.crashSeconds[i];
+        }
+        for (int i = 0; i < SweepTables::MAX_DELAYS; i++) {
+            reached[i] += other.reached[i];
+            crashedAt[i] += other.crashedAt[i];
+        }
+    }
+
+    // The lowest score at least that much of the games got no more than
+    int percentile(double fraction) const {
+        long needed = (long)ceil(fraction * games);
+        long count = 0;
+        for (int i = 0; i < SCORE_BINS; i++) {
+            count += scores[i];
+            if (count >= needed && count > 0) {
+                return i;
+            }
+        }
+        return SCORE_BINS - 1;
+    }
+
+    // Games still going after that many seconds
+    double alive(int seconds) const {
+        long crashes = 0;
+        for (int i = 0; i < seconds && i < MAX_SECONDS; i++) {
+            crashes += crashSeconds[i];
+        }
+        return (games > 0) ? 100.0 * (games - crashes) / games : 0;
+    }
+};
+
+struct SweepPoint {
+    GameTuning tuning;
+    SweepTables tables;
+    SweepStats stats;
+    std::mutex lock; // Around stats, for the threads adding their games
+
+    explicit SweepPoint(const GameTuning &numbers) : tuning(numbers), tables(numbers) {
+        tables.finish(tuning);
+        memset(&stats, 0, sizeof(stats));
+    }
+};
+
+struct SweepTask {
+    int point;
+    long first; // Of the point's games
+    long count;
+};
+
+struct Sweep {
+    std::vector<std::unique_ptr<SweepPoint> > points;
+    long gamesPerPoint;
+};
+
+// One game with the bot, up to a crash or MAX_SECONDS. Returns true if it crashed
+static bool playWithBot(SweepGame &game, uint32_t seed) {
+    game.start(seed);
+    Pcg32 mistakes(seed ^ MISTAKE_SEED);
+    const uint32_t mistakeBelow = (uint32_t)(BOT_MISTAKE_CHANCE * 4294967296.0);
+    while (game.getRoundTime() < (uint32_t)MAX_SECONDS * 1000) {
+        bool button = game.botButton() != (mistakes.next() < mistakeBelow);
+        if (!game.step(button)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t seedOf(const Sweep &sweep, int point, long game) {
+    return (uint32_t)(point * sweep.gamesPerPoint + game) + 1;
+}
+
+static void playTask(WorkStealingPool<SweepTask> &pool, const SweepTask &task, int thread, void *context) {
+    Sweep &sweep = *(Sweep *)context;
+
+    // Keep half, and leave the other half where an idle thread can take it
+    SweepTask mine = task;
+    while (mine.count > SPLIT_GAMES) {
+        long half = mine.count / 2;
+        SweepTask rest = {mine.point, mine.first + half, mine.count - half};
+        pool.push(thread, rest);
+        mine.count = half;
+    }
+
+    SweepPoint &point = *sweep.points[mine.point];
+    static thread_local SweepStats stats;
+    memset(&stats, 0, sizeof(stats));
+    SweepGame game(point.tuning);
+    for (long i = 0; i < mine.count; i++) {
+        bool crashed = playWithBot(game, seedOf(sweep, mine.point, mine.first + i));
+        stats.add(game, crashed);
+    }
+    std::lock_guard<std::mutex> hold(point.lock);
+    point.stats.merge(stats);
+}
+
+// NAME=low:high[:count]. Returns the parameter, or -1 if there is none by that name
+static int parseRange(const char *text, double &low, double &high, int &count) {
+    const char *equals = strchr(text, '=');
+    if (equals == 0) {
+        return -1;
+    }
+    for (int p = 0; p < PARAMETER_COUNT; p++) {
+        if (strlen(PARAMETERS[p].name) == (size_t)(equals - text) && strncmp(PARAMETERS[p].name, text, equals - text) == 0) {
+            count = 1;
+            int fields = sscanf(equals + 1, "%lf:%lf:%d", &low, &high, &count);
+            if (fields == 1) {
+                high = low;
+            }
+            return (fields >= 1 && count >= 1) ? p : -1;
+        }
+    }
+    return -1;
+}
+
+static void printPoint(const SweepPoint &point, int number, const std::vector<int> &varied) {
+    const SweepStats &stats = point.stats;
+    printf("tuning %d:", number);
+    for (size_t v = 0; v < varied.size(); v++) {
+        printf(" %s=%g", PARAMETERS[varied[v]].name, getParameter(point.tuning, varied[v]));
+    }
+    printf("\n");
+    printf("  score mean %.1f  p10 %d  p50 %d  p90 %d  best %d   alive after 10s %.0f%%  30s %.0f%%  60s %.0f%%  120s %.0f%%  %ds %.0f%%\n",
+           (stats.games > 0) ? stats.scoreSum / stats.games : 0, stats.percentile(0.1), stats.percentile(0.5), stats.percentile(0.9),
+           stats.bestScore, stats.alive(10), stats.alive(30), stats.alive(60), stats.alive(120), MAX_SECONDS, 100.0 * stats.survived / stats.games);
+    printf("  crashes at ms/px:");
+    for (int i = 0; i < point.tables.delayCount; i++) {
+        // Only the speeds enough games got to for the rate to mean something
+        if (stats.reached[i] * 100 >= stats.games && stats.reached[i] > 0) {
+            printf(" %d:%.0f%%", point.tables.delays[i].delay, 100.0 * stats.crashedAt[i] / stats.reached[i]);
+        }
+    }
+    printf("\n");
+}
+
+static double secondsNow() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static int allCores() {
+    int cores = (int)std::thread::hardware_concurrency();
+    return (cores > 0) ? cores : 1;
+}
+
+// Makes the tunings of a sweep, like runSweep() describes, into sweep and the numbers they
+// differ in into varied. Returns false if the arguments were wrong
+static bool makeSweep(Sweep &sweep, std::vector<int> &varied, long &unplayable,
+                      const char *gridOrRandom, long gamesPerPoint, int points, int rangeCount, char **ranges) {
+    bool isGrid = strcmp(gridOrRandom, "grid") == 0;
+    if (!isGrid && strcmp(gridOrRandom, "random") != 0) {
+        printf("sweep: grid or random, not %s\n", gridOrRandom);
+        return false;
+    }
+
+    // The ranges given. Without any, a grid goes over how fast the pillars get
+    char defaultRate[] = "PILLAR_ACCELERATION_RATE=0.0025:0.0075:3";
+    char defaultMin[] = "MIN_PILLAR_DELAY=10:14:3";
+    char *defaultGrid[] = {defaultRate, defaultMin};
+    if (isGrid && rangeCount == 0) {
+        ranges = defaultGrid;
+        rangeCount = 2;
+    }
+    double lows[PARAMETER_COUNT];
+    double highs[PARAMETER_COUNT];
+    int counts[PARAMETER_COUNT];
+    bool isGiven[PARAMETER_COUNT] = {};
+    for (int p = 0; p < PARAMETER_COUNT; p++) {
+        lows[p] = PARAMETERS[p].low;
+        highs[p] = PARAMETERS[p].high;
+        counts[p] = 1;
+    }
+    for (int r = 0; r < rangeCount; r++) {
+        double low;
+        double high;
+        int count;
+        int p = parseRange(ranges[r], low, high, count);
+        if (p < 0) {
+            printf("sweep: %s is not NAME=low:high%s. The names are:\n", ranges[r], isGrid ? ":count" : "");
+            for (int q = 0; q < PARAMETER_COUNT; q++) {
+                printf("  %s\n", PARAMETERS[q].name);
+            }
+            return false;
+        }
+        lows[p] = low;
+        highs[p] = high;
+        counts[p] = count;
+        isGiven[p] = true;
+    }
+
+    // The tunings. A grid changes the numbers it was given, a random sweep all of them
+    sweep.gamesPerPoint = gamesPerPoint;
+    for (int p = 0; p < PARAMETER_COUNT; p++) {
+        if (isGiven[p] || !isGrid) {
+            varied.push_back(p);
+        }
+    }
+    const GameTuning defaults = GameTuning::of<Config>();
+    unplayable = 0;
+    if (isGrid) {
+        long combinations = 1;
+        for (size_t v = 0; v < varied.size(); v++) {
+            combinations *= counts[varied[v]];
+        }
+        for (long c = 0; c < combinations; c++) {
+            GameTuning tuning = defaults;
+            long rest = c;
+            for (size_t v = 0; v < varied.size(); v++) {
+                int p = varied[v];
+                int i = (int)(rest % counts[p]);
+                rest /= counts[p];
+                setParameter(tuning, p, (counts[p] > 1) ? lows[p] + (highs[p] - lows[p]) * i / (counts[p] - 1) : lows[p]);
+            }
+            if (tuning.problem<Config>() != 0) {
+                unplayable++;
+                continue;
+            }
+            sweep.points.push_back(std::unique_ptr<SweepPoint>(new SweepPoint(tuning)));
+        }
+    } else {
+        Pcg32 random(SAMPLE_SEED);
+        for (int i = 0; i < points; i++) {
+            GameTuning tuning = defaults;
+            int tries = 0;
+            do {
+                for (size_t v = 0; v < varied.size(); v++) {
+                    int p = varied[v];
+                    setParameter(tuning, p, lows[p] + (highs[p] - lows[p]) * (random.next() / 4294967296.0));
+                }
+                tries++;
+            } while (tuning.problem<Config>() != 0 && tries < 1000);
+            if (tuning.problem<Config>() != 0) {
+                printf("sweep: no playable tuning in those ranges (%s)\n", tuning.problem<Config>());
+                return false;
+            }
+            sweep.points.push_back(std::unique_ptr<SweepPoint>(new SweepPoint(tuning)));
+        }
+    }
+    if (sweep.points.empty()) {
+        printf("sweep: none of the %ld tunings can be played\n", unplayable);
+        return false;
+    }
+    return true;
+}
+
+// Plays every game of the sweep on that many threads, from no stats. Returns how many seconds it took
+static double playSweep(Sweep &sweep, int threads, long &steals) {
+    std::vector<SweepTask> tasks;
+    for (size_t p = 0; p < sweep.points.size(); p++) {
+        memset(&sweep.points[p]->stats, 0, sizeof(SweepStats));
+        SweepTask task = {(int)p, 0, sweep.gamesPerPoint};
+        tasks.push_back(task);
+    }
+    WorkStealingPool<SweepTask> pool(threads);
+    double start = secondsNow();
+    pool.run(tasks, playTask, &sweep);
+    double seconds = secondsNow() - start;
+    steals = pool.getSteals();
+    return seconds;
+}
+
+int runSweep(const char *gridOrRandom, long gamesPerPoint, int threads, int points, int rangeCount, char **ranges) {
+    threads = (threads > 0) ? threads : allCores();
+    Sweep sweep;
+    std::vector<int> varied;
+    long unplayable;
+    if (!makeSweep(sweep, varied, unplayable, gridOrRandom, gamesPerPoint, points, rangeCount, ranges)) {
+        return 1;
+    }
+    long steals;
+    double seconds = playSweep(sweep, threads, steals);
+
+    long games = 0;
+    for (size_t p = 0; p < sweep.points.size(); p++) {
+        printPoint(*sweep.points[p], (int)p, varied);
+        games += sweep.points[p]->stats.games;
+    }
+    if (unplayable > 0) {
+        printf("%ld tunings of the grid can't be played and were left out\n", unplayable);
+    }
+    printf("%d tunings, %ld games, bot mistakes %.0f%%: %.2f s on %d thread%s, %.0f games/s, %.0f per thread, %ld steals\n",
+           (int)sweep.points.size(), games, BOT_MISTAKE_CHANCE * 100, seconds, threads, (threads == 1) ? "" : "s",
+           games / seconds, games / seconds / threads, steals);
+    return 0;
+}
+
+int runSweepScaling(long gamesPerPoint, int maxThreads) {
+    maxThreads = (maxThreads > 0) ? maxThreads : allCores();
+    Sweep sweep;
+    std::vector<int> varied;
+    long unplayable;
+    if (!makeSweep(sweep, varied, unplayable, "grid", gamesPerPoint, 0, 0, NULL)) {
+        return 1;
+    }
+    long games = (long)sweep.points.size() * gamesPerPoint;
+    printf("the default grid, %d tunings, %ld games, on 1 to %d threads. This machine has %d core%s\n",
+           (int)sweep.points.size(), games, maxThreads, allCores(), (allCores() == 1) ? "" : "s");
+    printf("threads  seconds    games/s   speedup   of linear   steals\n");
+
+    // What 1 thread made, for the others to come out the same as
+    std::vector<SweepStats> oneThread(sweep.points.size());
+    double oneThreadSeconds = 0;
+    for (int threads = 1; threads <= maxThreads; threads++) {
+        long steals;
+        double seconds = playSweep(sweep, threads, steals);
+        for (size_t p = 0; p < sweep.points.size(); p++) {
+            if (threads == 1) {
+                oneThread[p] = sweep.points[p]->stats;
+            } else if (memcmp(&oneThread[p], &sweep.points[p]->stats, sizeof(SweepStats)) != 0) {
+                printf("sweep-scaling: tuning %d came out different on %d threads than on 1\n", (int)p, threads);
+                return 1;
+            }
+        }
+        oneThreadSeconds = (threads == 1) ? seconds : oneThreadSeconds;
+        double speedup = oneThreadSeconds / seconds;
+        printf("%7d  %7.2f  %9.0f  %7.2fx  %9.0f%%  %7ld\n", threads, seconds, games / seconds, speedup, 100 * speedup / threads, steals);
+    }
+    if (maxThreads > allCores()) {
+        printf("past %d thread%s the threads share the cores, so the speedup can't keep up\n", allCores(), (allCores() == 1) ? "" : "s");
+    }
+    printf("every thread count came out the same as 1 thread\n");
+    return 0;
+}
+
+// ================================ Checking it ================================
+
+// Configs with other numbers compiled in. sweep-verify only needs their tunings, so the
+// classes aren't built for them
+struct RoomyConfig : DefaultGameConfig {
+    static constexpr int BIRD_SPACE = 30;
+    static constexpr double GRAVITATIONAL_DELAY = 58.5;
+    static constexpr double FLAP_DELAY = 44;
+    static constexpr double BIRD_ACCELERATION_RATE = 0.22;
+    static constexpr double PILLAR_DELAY = 34;
+    static constexpr int PILLARS_PASSED_TO_LEVEL_UP_STARTING_POINT = 9;
+    typedef LinearDifficulty<RoomyConfig> Difficulty;
+};
+
+struct HurriedConfig : DefaultGameConfig {
+    static constexpr int BIRD_SPACE = 20;
+    static constexpr double BIRD_ACCELERATION_RATE = 0.45;
+    static constexpr double PILLAR_DELAY = 26.5;
+    static constexpr double MIN_PILLAR_DELAY = 9.25;
+    static constexpr double PILLAR_ACCELERATION_RATE = 0.0075;
+    static constexpr int MIN_PILLAR_BETWEEN_PILLAR_SPACE = 10;
+    static constexpr int PILLARS_PASSED_TO_LEVEL_UP_STARTING_POINT = 4;
+    static constexpr int PILLARS_PASSED_TO_LEVEL_UP_FACTOR = 3;
+    typedef LinearDifficulty<HurriedConfig> Difficulty;
+};
+
+// Makes the tuning for Checked's numbers like a grid does, from the config's with every
+// number set, and checks it against the one the compiler made. Then plays that many games
+// with each and checks they come out the same. Returns false if anything is different
+template <class Checked>
+static bool verifyTuning(const char *name, long games, uint32_t seed, long &steps, long &crashes) {
+    const GameTuning &compiled = DefaultTuning<Checked>::TUNING;
+    GameTuning swept = GameTuning::of<Config>();
+    for (int p = 0; p < PARAMETER_COUNT; p++) {
+        setParameter(swept, p, getParameter(compiled, p));
+    }
+    if (swept.problem<Config>() != 0) {
+        printf("sweep-verify: %s can't be played (%s)\n", name, swept.problem<Config>());
+        return false;
+    }
+    const SweepTables tables(swept);
+    tables.finish(swept);
+
+    bool isSame = swept.fallSpeed == compiled.fallSpeed && swept.flapSpeed == compiled.flapSpeed
+               && swept.fallAcceleration == compiled.fallAcceleration && swept.flapAcceleration == compiled.flapAcceleration;
+    if (!isSame) {
+        printf("sweep-verify: %s: the physics speeds worked out while running are not the compiled ones\n", name);
+        return false;
+    }
+    isSame = swept.delayCount == compiled.delayCount && swept.levelUpCount == compiled.levelUpCount;
+    for (int i = 0; isSame && i < swept.delayCount; i++) {
+        isSame = swept.delays[i].fromStep == compiled.delays[i].fromStep && swept.delays[i].delay == compiled.delays[i].delay;
+    }
+    for (int i = 0; isSame && i < swept.levelUpCount; i++) {
+        isSame = swept.levelUps[i] == compiled.levelUps[i];
+    }
+    if (!isSame) {
+        printf("sweep-verify: %s: the tables made from the tuning are not the LinearDifficulty ones\n", name);
+        return false;
+    }
+
+    SweepGame sweptGame(swept);
+    SweepGame compiledGame(compiled);
+    for (long g = 0; g < games; g++) {
+        uint32_t gameSeed = seed + (uint32_t)g;
+        sweptGame.start(gameSeed);
+        compiledGame.start(gameSeed);
+
+        // The same bot as the sweep, mistakes and all
+        Pcg32 mistakes(gameSeed ^ MISTAKE_SEED);
+        const uint32_t mistakeBelow = (uint32_t)(BOT_MISTAKE_CHANCE * 4294967296.0);
+        bool isAlive = true;
+        while (isAlive && sweptGame.getRoundTime() < (uint32_t)MAX_SECONDS * 1000) {
+            bool button = sweptGame.botButton() != (mistakes.next() < mistakeBelow);
+            isAlive = sweptGame.step(button);
+            bool isCompiledAlive = compiledGame.step(button);
+            steps++;
+            GameSnapshot sweptSnapshot = sweptGame.getSnapshot();
+            GameSnapshot compiledSnapshot = compiledGame.getSnapshot();
+            if (isAlive != isCompiledAlive || memcmp(&sweptSnapshot, &compiledSnapshot, sizeof(GameSnapshot)) != 0) {
+                printf("sweep-verify: %s: game %ld (seed %lu) is different at %lu ms\n",
+                       name, g, (unsigned long)gameSeed, (unsigned long)compiledGame.getRoundTime());
+                return false;
+            }
+        }
+        crashes += isAlive ? 0 : 1;
+    }
+    printf("%s: the sweep's tuning is the compiled one, and %ld games came out the same\n", name, games);
+    return true;
+}
+
+int runSweepVerify(long games, uint32_t seed) {
+    long steps = 0;
+    long crashes = 0;
+    int tunings = 0;
+    // The config's own tables only come from the numbers with the LinearDifficulty profile
+    if (std::is_same<Config::Difficulty, LinearDifficulty<Config> >::value) {
+        if (!verifyTuning<Config>("the config", games, seed, steps, crashes)) {
+            return 1;
+        }
+        tunings++;
+    } else {
+        printf("the config plays another difficulty profile than LinearDifficulty, so only the others are checked\n");
+    }
+    if (!verifyTuning<RoomyConfig>("a roomier one", games, seed, steps, crashes)
+            || !verifyTuning<HurriedConfig>("a hurried one", games, seed, steps, crashes)) {
+        return 1;
+    }
+    tunings += 2;
+    printf("%d tunings, %ld games, %ld bird steps and %ld crashes, the same as the tunings compiled in\n",
+           tunings, games * tunings, steps, crashes);
+    return 0;
+}
@@ -0,0 +1,124 @@
+/******************************************************************************
+Sweep.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Trying out tunings * *
+* How fast the pillars speed up, how wide the gap is, when the extra pillars come
+* and how the bird falls used to be tuned by building, flashing and playing.
+*
+* Bird and PillarManager play by a GameTuning (see GameConfig.h), which is the
+* config's own unless they are given another. SweepGame plays them with
+* Autopilot::step() in the PIXEL_STEPS mode, with the numbers of the tuning being
+* tried, so a sweep plays the real game and not a copy of its rules. The screen, the
+* bird's size, the pillar width and the most pillars on screen stay the ones of
+* DefaultGameConfig. The delay and level up tables are made from the numbers the way
+* LinearDifficulty makes them (see Difficulty.h), so a sweep starts from the default
+* LinearDifficulty profile and not from a table written down by hand.
+* `flappyhost sweep-verify` checks that a tuning made that way is the one the
+* compiler makes for a config with the same numbers, for the config and for a few
+* others, and that their games come out the same step for step.
+*
+* A sweep plays gamesPerPoint games with each tuning:
+*   grid:   every combination of the values given for each number,
+*           NAME=low:high:count spreads count values from low to high
+*   random: that many tunings with each number picked between low and high,
+*           NAME=low:high. Numbers not given vary over a default range
+* The numbers not in a grid keep the config's value. Tunings the game can't be
+* played with (see GameTuning::problem()) are left out of a grid and picked again
+* in a random sweep.
+*
+* The player is the bot from `flappyhost headless`, aiming for the middle of the
+* next gap, but it presses the wrong way on BOT_MISTAKE_CHANCE of its steps, so
+* it crashes sometimes like a person does, and more often when the game is harder.
+* A game that lasts MAX_SECONDS counts as survived.
+*
+* The games are spread over the threads with the WorkStealingPool. Every game has
+* its own seed, and the results are only ever added up, so a sweep comes out the
+* same with any number of threads. It reports for each tuning:
+*   - the scores: mean, 10th, 50th and 90th percentile, and the best
+*   - the survival curve: how many games were still going after 10, 30, 60, 120
+*     and MAX_SECONDS seconds
+*   - the crash rate at each level of the delay table: of the games that got to
+*     that speed, how many crashed before the next one
+* and at the end how many games per second that was, in total and per thread.
+*
+* The games don't share anything but the stats they are added to at the end of a
+* task, so a sweep should go about as many times faster as there are cores. `flappyhost
+* sweep-scaling` plays the same sweep on 1 thread, then 2, and so on, and prints how
+* much faster each was than 1, to check that on the machine at hand.
+******************************/
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdint.h>
+#include "../Autopilot.h"
+
+// The delay and level up tables of one tuning, made like LinearDifficulty makes them
+struct SweepTables {
+    static const int MAX_DELAYS = 256;
+    static const int LEVEL_UP_COUNT = 8;
+
+    DelayStep delays[MAX_DELAYS];
+    int delayCount;
+    uint16_t levelUps[LEVEL_UP_COUNT];
+
+    explicit SweepTables(const GameTuning &tuning);
+
+    // Points the tuning at these tables and works out its physics speeds, so it plays its
+    // own numbers. The tables have to outlive it
+    void finish(GameTuning &tuning) const;
+};
+
+// One game with a tuning that isn't compiled in, on the real classes
+class SweepGame {
+
+    public:
+
+        explicit SweepGame(const GameTuning &tuning); // Finished by SweepTables::finish(), and kept while the game is
+
+        // A new round, with the pillars of PillarManager::seedRandom(seed) and a new bird
+        void start(uint32_t seed);
+
+        // Autopilot::step() on the bird and the pillars. Returns false if the bird crashed
+        bool step(bool button);
+
+        // The headless bot: down is below the middle of the next gap
+        bool botButton();
+
+        // Getter methods
+        GameSnapshot getSnapshot() const; // The whole game, as Autopilot::step() would have it
+        uint32_t getRoundTime() const;
+        int getScore();
+        int getDelayIndex() const; // The entry of the delay table the pillars are at
+
+    private:
+
+        const GameTuning &_tuning;
+        Bird _bird;
+        PillarManager _pillarManager;
+        GameSnapshot _game; // Only the timing. The bird and the pillars are the ones above
+};
+
+static const double BOT_MISTAKE_CHANCE = 0.04; // Of the bot's steps pressed the wrong way
+static const int MAX_SECONDS = 300; // A game this long counts as survived
+
+// gridOrRandom is "grid" or "random". points is how many tunings a random sweep tries.
+// ranges are NAME=low:high:count for a grid and NAME=low:high for a random sweep.
+// threads 0 uses every core. Returns 0, or 1 if the arguments were wrong
+int runSweep(const char *gridOrRandom, long gamesPerPoint, int threads, int points, int rangeCount, char **ranges);
+
+// Plays the default grid with gamesPerPoint games on 1 thread, then 2, up to maxThreads (0 is
+// every core), and prints the time and the speedup over 1 thread for each. Fails if the
+// results are ever different from 1 thread's
+int runSweepScaling(long gamesPerPoint, int maxThreads);
+
+// For the config and a few others with other numbers compiled in, makes the tuning the
+// way a sweep does and fails if it isn't the compiler's, or if that many games with each
+// come out different at any step
+int runSweepVerify(long games, uint32_t seed);
+
+#endif
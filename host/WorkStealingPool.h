@@ -0,0 +1,131 @@
+/******************************************************************************
+WorkStealingPool.h
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Sharing work between threads * *
+* Handing every thread the same share of the work only works if every piece takes
+* as long as the others, and games don't: a hard tuning ends its games in a few
+* seconds, an easy one plays them all the way to the time limit. The threads with
+* the easy ones would still be busy long after the others are done.
+*
+* So every thread has its own deque of tasks. It takes from the back of its own,
+* and a thread with nothing left takes from the front of someone else's. That is
+* called work stealing. A task can push more tasks while it runs: a big one splits
+* itself in half and keeps going with one half, so the other half sits at the back
+* of its deque for it, or at the front for a thread with nothing to do. The tasks at
+* the front are the older, bigger halves, so a steal takes a lot of work at once and
+* threads rarely have to steal.
+*
+* Each deque has its own lock, which is only ever contended by a steal.
+* Host only, it needs std::thread.
+******************************/
+
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+template <class Task>
+class WorkStealingPool {
+
+    public:
+
+        // Called for every task, with the thread's number (0 to threads - 1)
+        typedef void (*Work)(WorkStealingPool &pool, const Task &task, int thread, void *context);
+
+        explicit WorkStealingPool(int threads) {
+            _threads = (threads > 0) ? threads : 1;
+            for (int i = 0; i < _threads; i++) {
+                _queues.push_back(std::unique_ptr<_Queue>(new _Queue()));
+            }
+            _pending = 0;
+            _steals = 0;
+        }
+
+        // Runs the tasks and every task they push, and returns once all of them are done.
+        // The first thread is the one calling this
+        void run(const std::vector<Task> &tasks, Work work, void *context) {
+            _steals = 0;
+            for (size_t i = 0; i < tasks.size(); i++) {
+                push((int)(i % _threads), tasks[i]);
+            }
+            std::vector<std::thread> threads;
+            for (int thread = 1; thread < _threads; thread++) {
+                threads.push_back(std::thread(&WorkStealingPool::_work, this, thread, work, context));
+            }
+            _work(0, work, context);
+            for (size_t i = 0; i < threads.size(); i++) {
+                threads[i].join();
+            }
+        }
+
+        // One more task for this thread. Tasks call this with the thread they were given
+        void push(int thread, const Task &task) {
+            _pending++; // Before it can be taken, so no thread thinks the work is done in between
+            std::lock_guard<std::mutex> hold(_queues[thread]->lock);
+            _queues[thread]->tasks.push_back(task);
+        }
+
+        // Getter methods
+        int getThreads() const { return _threads; }
+        long getSteals() const { return _steals; }
+
+    private:
+
+        struct _Queue {
+            std::mutex lock;
+            std::deque<Task> tasks;
+        };
+
+        int _threads;
+        std::vector<std::unique_ptr<_Queue> > _queues;
+        std::atomic<long> _pending; // Pushed and not finished yet
+        std::atomic<long> _steals;
+
+        void _work(int thread, Work work, void *context) {
+            Task task;
+            while (_pending > 0) {
+                if (_takeOwn(thread, task) || _steal(thread, task)) {
+                    work(*this, task, thread, context);
+                    _pending--;
+                } else {
+                    std::this_thread::yield(); // The last tasks are still running, and may push more
+                }
+            }
+        }
+
+        bool _takeOwn(int thread, Task &task) {
+            _Queue &queue = *_queues[thread];
+            std::lock_guard<std::mutex> hold(queue.lock);
+            if (queue.tasks.empty()) {
+                return false;
+            }
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+            return true;
+        }
+
+        bool _steal(int thread, Task &task) {
+            for (int i = 1; i < _threads; i++) {
+                _Queue &queue = *_queues[(thread + i) % _threads];
+                std::lock_guard<std::mutex> hold(queue.lock);
+                if (!queue.tasks.empty()) {
+                    task = queue.tasks.front();
+                    queue.tasks.pop_front();
+                    _steals++;
+                    return true;
+                }
+            }
+            return false;
+        }
+};
+
+#endif
@@ -0,0 +1,264 @@
+/******************************************************************************
+flashee-eeprom.cpp (host stand-in)
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+#include "flashee-eeprom.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+using namespace Flashee;
+
+#define HOST_FLASH_PAGE_SIZE 4096
+#define HOST_FLASH_PAGE_COUNT 384 // 1.5MB, the user part of the external flash Flashee was written for
+
+// ============================== The file ==============================
+
+// The whole chip, kept in memory and written through to the file on every change
+class HostFlashFile {
+
+    public:
+
+        static HostFlashFile &instance() {
+            static HostFlashFile file;
+            return file;
+        }
+
+        void setPath(const char *path) {
+            _path = path;
+            _load();
+        }
+
+        uint8_t *bytes() {
+            _loadOnce();
+            return &_image[0];
+        }
+
+        void countErase(flash_addr_t address) {
+            _erases[address / HOST_FLASH_PAGE_SIZE]++;
+        }
+
+        unsigned long getErases(flash_addr_t address) {
+            return (address < HOST_FLASH_PAGE_SIZE * HOST_FLASH_PAGE_COUNT) ? _erases[address / HOST_FLASH_PAGE_SIZE] : 0;
+        }
+
+        void flush(flash_addr_t address, flash_addr_t length) {
+            FILE *file = fopen(_path, "r+b");
+            if (file == NULL) {
+                file = fopen(_path, "w+b");
+            }
+            if (file == NULL) {
+                return; // The game keeps working, it just won't remember anything
+            }
+            if (_fileSize(file) != _image.size()) {
+                // A new or truncated file gets the whole chip so the offsets line up
+                address = 0;
+                length = _image.size();
+            }
+            fseek(file, address, SEEK_SET);
+            fwrite(&_image[address], 1, length, file);
+            fclose(file);
+        }
+
+    private:
+
+        const char *_path;
+        std::vector<uint8_t> _image;
+        bool _loaded;
+        unsigned long _erases[HOST_FLASH_PAGE_COUNT];
+
+        HostFlashFile() : _path("flappy_flash.bin"), _loaded(false) {
+            memset(_erases, 0, sizeof(_erases));
+        }
+
+        void _loadOnce() {
+            if (!_loaded) {
+                _load();
+            }
+        }
+
+        void _load() {
+            // A missing file is a brand new chip, which is all erased
+            _image.assign(HOST_FLASH_PAGE_SIZE * HOST_FLASH_PAGE_COUNT, 0xFF);
+            FILE *file = fopen(_path, "rb");
+            if (file != NULL) {
+                size_t got = fread(&_image[0], 1, _image.size(), file);
+                (void)got;
+                fclose(file);
+            }
+            _loaded = true;
+        }
+
+        static size_t _fileSize(FILE *file) {
+            fseek(file, 0, SEEK_END);
+            long size = ftell(file);
+            return (size < 0) ? 0 : (size_t)size;
+        }
+};
+
+// ============================== FlashDevice ==============================
+
+bool FlashDevice::write(const void *data, flash_addr_t address, flash_addr_t length) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    while (length > 0) {
+        // Never let one writePage cross into the next page
+        flash_addr_t offset = address % pageSize();
+        flash_addr_t chunk = pageSize() - offset;
+        if (chunk > length) {
+            chunk = length;
+        }
+        if (!writePage(bytes, address, chunk)) {
+            return false;
+        }
+        bytes += chunk;
+        address += chunk;
+        length -= chunk;
+    }
+    return true;
+}
+
+bool FlashDevice::read(void *data, flash_addr_t address, flash_addr_t length) const {
+    uint8_t *bytes = (uint8_t *)data;
+    while (length > 0) {
+        flash_addr_t offset = address % pageSize();
+        flash_addr_t chunk = pageSize() - offset;
+        if (chunk > length) {
+            chunk = length;
+        }
+        if (!readPage(bytes, address, chunk)) {
+            return false;
+        }
+        bytes += chunk;
+        address += chunk;
+        length -= chunk;
+    }
+    return true;
+}
+
+// ============================== Raw region ==============================
+
+class HostFlashRegion : public FlashDevice {
+
+    public:
+
+        HostFlashRegion(flash_addr_t startAddress, flash_addr_t endAddress) {
+            _start = startAddress;
+            _pageCount = (endAddress - startAddress) / HOST_FLASH_PAGE_SIZE;
+        }
+
+        page_size_t pageSize() const { return HOST_FLASH_PAGE_SIZE; }
+        page_count_t pageCount() const { return _pageCount; }
+
+        bool erasePage(flash_addr_t address) {
+            if (address >= length()) {
+                return false;
+            }
+            flash_addr_t page = _start + address - (address % HOST_FLASH_PAGE_SIZE);
+            memset(HostFlashFile::instance().bytes() + page, 0xFF, HOST_FLASH_PAGE_SIZE);
+            HostFlashFile::instance().flush(page, HOST_FLASH_PAGE_SIZE);
+            HostFlashFile::instance().countErase(page);
+            return true;
+        }
+
+        bool writePage(const void *data, flash_addr_t address, page_size_t length) {
+            if (address + length > this->length()) {
+                return false;
+            }
+            // NOR flash can only clear bits
+            uint8_t *flash = HostFlashFile::instance().bytes() + _start + address;
+            const uint8_t *bytes = (const uint8_t *)data;
+            for (int i = 0; i < length; i++) {
+                flash[i] &= bytes[i];
+            }
+            HostFlashFile::instance().flush(_start + address, length);
+            return true;
+        }
+
+        bool readPage(void *data, flash_addr_t address, page_size_t length) const {
+            if (address + length > this->length()) {
+                return false;
+            }
+            memcpy(data, HostFlashFile::instance().bytes() + _start + address, length);
+            return true;
+        }
+
+    private:
+
+        flash_addr_t _start;
+        page_count_t _pageCount;
+};
+
+// ============================== Erase anywhere ==============================
+
+class HostAddressErase : public FlashDevice {
+
+    public:
+
+        HostAddressErase(FlashDevice *flash) {
+            _flash = flash;
+        }
+
+        page_size_t pageSize() const { return _flash->pageSize(); }
+        page_count_t pageCount() const { return _flash->pageCount(); }
+
+        bool erasePage(flash_addr_t address) {
+            return _flash->erasePage(address);
+        }
+
+        bool writePage(const void *data, flash_addr_t address, page_size_t length) {
+            // If the new bytes only clear bits they can go straight in, otherwise the
+            // page has to be read, erased and written back with the new bytes merged in
+            uint8_t page[HOST_FLASH_PAGE_SIZE];
+            flash_addr_t pageStart = address - (address % pageSize());
+            if (!_flash->readPage(page, pageStart, pageSize())) {
+                return false;
+            }
+            uint8_t *target = page + (address - pageStart);
+            const uint8_t *bytes = (const uint8_t *)data;
+            bool needsErase = false;
+            for (int i = 0; i < length; i++) {
+                needsErase |= (target[i] & bytes[i]) != bytes[i];
+            }
+            if (!needsErase) {
+                return _flash->writePage(data, address, length);
+            }
+            memcpy(target, data, length);
+            return _flash->erasePage(pageStart) && _flash->writePage(page, pageStart, pageSize());
+        }
+
+        bool readPage(void *data, flash_addr_t address, page_size_t length) const {
+            return _flash->readPage(data, address, length);
+        }
+
+    private:
+
+        FlashDevice *_flash;
+};
+
+// ============================== Devices ==============================
+
+FlashDevice *Devices::createUserFlashRegion(flash_addr_t startAddress, flash_addr_t endAddress) {
+    if (startAddress >= endAddress || endAddress > HOST_FLASH_PAGE_SIZE * HOST_FLASH_PAGE_COUNT) {
+        return NULL;
+    }
+    return new HostFlashRegion(startAddress, endAddress);
+}
+
+FlashDevice *Devices::createAddressErase(flash_addr_t startAddress, flash_addr_t endAddress) {
+    FlashDevice *region = createUserFlashRegion(startAddress, endAddress);
+    return (region == NULL) ? NULL : new HostAddressErase(region);
+}
+
+FlashDevice *Devices::createDefaultStore() {
+    return createAddressErase();
+}
+
+void Devices::setHostFile(const char *path) {
+    HostFlashFile::instance().setPath(path);
+}
+
+unsigned long Devices::getEraseCount(flash_addr_t address) {
+    return HostFlashFile::instance().getErases(address);
+}
@@ -0,0 +1,76 @@
+/******************************************************************************
+flashee-eeprom.h (host stand-in)
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Host stand-in * *
+* This is NOT the Flashee library, only the part of its interface the game uses.
+* The flash is a file on disk. It behaves like NOR flash: an erased page reads as
+* 0xFF, and writing can only turn 1 bits into 0 bits until the page is erased again.
+* createDefaultStore() hides that, like the real one, by erasing and rewriting the
+* whole page whenever a write needs it.
+*
+* Every erase is counted per page, since that is what wears real flash out.
+******************************/
+
+#ifndef HOST_FLASHEE_EEPROM_H
+#define HOST_FLASHEE_EEPROM_H
+
+#include <stdint.h>
+
+namespace Flashee {
+
+    typedef uint32_t flash_addr_t;
+    typedef uint16_t page_size_t;
+    typedef uint16_t page_count_t;
+
+    class FlashDevice {
+
+        public:
+
+            virtual ~FlashDevice() {}
+
+            virtual page_size_t pageSize() const = 0;
+            virtual page_count_t pageCount() const = 0;
+            flash_addr_t length() const { return pageAddress(pageCount()); }
+            flash_addr_t pageAddress(page_count_t page) const { return flash_addr_t(page) * pageSize(); }
+
+            virtual bool erasePage(flash_addr_t address) = 0;
+            virtual bool writePage(const void *data, flash_addr_t address, page_size_t length) = 0;
+            virtual bool readPage(void *data, flash_addr_t address, page_size_t length) const = 0;
+
+            // Writes and reads that may cross page boundaries
+            virtual bool write(const void *data, flash_addr_t address, flash_addr_t length);
+            virtual bool read(void *data, flash_addr_t address, flash_addr_t length) const;
+
+            template <typename T> bool write(const T &t, flash_addr_t address) {
+                return write(&t, address, sizeof(t));
+            }
+
+            template <typename T> bool read(T &t, flash_addr_t address) const {
+                return read(&t, address, sizeof(t));
+            }
+    };
+
+    class Devices {
+
+        public:
+
+            // Raw flash, writes only clear bits until the page is erased
+            static FlashDevice *createUserFlashRegion(flash_addr_t startAddress, flash_addr_t endAddress);
+            // Flash that can be rewritten anywhere like an EEPROM, over the pages from and to
+            static FlashDevice *createAddressErase(flash_addr_t startAddress = 0, flash_addr_t endAddress = 4096 * 256);
+            // The same over the first 256 pages, like the real library
+            static FlashDevice *createDefaultStore();
+
+            // ========== Host only ==========
+            // The file the flash lives in. Call before creating any device
+            static void setHostFile(const char *path);
+            // How many times the page holding this chip address was erased since the program started
+            static unsigned long getEraseCount(flash_addr_t address);
+    };
+}
+
+#endif
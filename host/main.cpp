@@ -0,0 +1,2154 @@
+/******************************************************************************
+main.cpp (host driver)
+Particle Photon Flappy Bird Project
+Ryan Jin @ iD Tech Electric Engineering with the Arduino Platform
+*****************************************************************************/
+
+/*******************************
+* * Host driver * *
+* Runs the game on a computer instead of the Photon.
+*
+*   flappyhost headless [ticks] [seed] [large]
+*       Steps Bird and PillarManager directly, with no screen and no clock, as fast
+*       as possible. A simple bot holds the button whenever the bird is below the
+*       middle of the next gap. Prints how many ticks per second that ran at.
+*       "large" runs the 128x64 LargePanelConfig instead of the 64x48 one.
+*
+*   flappyhost game [milliseconds] [seed] [periodMs] [holdMs] [physics]
+*       Runs the real FlappyGame, the same code as the sketch, against the virtual
+*       clock with the button pressed for holdMs every periodMs. Prints the last
+*       frame the OLED stand-in received, how many bytes went over the bus per
+*       frame, how long frames took to get to the panel, and how late each
+*       scheduled task ran. "physics" runs it in the TIMED_PHYSICS mode instead of
+*       1 px steps.
+*
+*   flappyhost physics [milliseconds] [frameMs] [seed]
+*       The headless bot again, but with Bird::advance and PillarManager::advance
+*       moving everything frameMs at a time. Prints how many seconds of game that
+*       is per real second, and how long skipping the pillars ahead an hour takes.
+*       Fails if the hour skipped in one go, or in random bits, ends up anywhere
+*       else than doing every step.
+*
+*   flappyhost batch [games] [ticks] [seed]
+*       Runs many headless games at once with BatchSim and the same bot. Prints
+*       game ticks per second and finished games per second.
+*
+*   flappyhost batch-verify [games] [ticks] [seed]
+*       Runs the same games with BatchSim and with the scalar classes, one game at
+*       a time, and fails if any of them end up different.
+*
+*   flappyhost alloc-verify [ticks] [seed]
+*       Runs the real FlappyGame, in both modes, with the bot crashing it every few
+*       seconds, and counts the calls to operator new after begin(). Fails if that
+*       many passes of loop() made any.
+*
+*   flappyhost delay-bench [steps]
+*       Steps the bird's and the pillars' delays, checks how far the bird's are from
+*       the doubles the game always used and the pillars' table from the old float
+*       curve, and prints the cycles per step.
+*       Build with `make FIXED=16` to see the fixed point numbers instead.
+*
+*   flappyhost record [milliseconds] [seed] [periodMs] [holdMs] [physics]
+*       Runs the game like `game` does, but in the deterministic mode (see Replay.h),
+*       and writes the last game that ended to flappy_replay.bin. A periodMs of 0
+*       lets the headless bot press the button instead, for longer games.
+*
+*   flappyhost replay [file] [times]
+*       Plays a recorded game back that many times, as fast as it goes, and fails if
+*       any of them crash at a different time or with a different score. A replay
+*       read off a Photon's flash plays back the same way.
+*
+*   flappyhost profile [milliseconds] [seed] [physics|autopilot]
+*       Only with `make PROFILE=1`. Runs the game like `game` does, with the stage
+*       timers from Profiler.h dumping into flappy_profile.bin, then reads the last
+*       dump back and prints the time each stage took and each task's deadline misses.
+*       "autopilot" lets the attract mode play, which shows up as the plan stage.
+*       Any other build only prints how to get the timers.
+*
+*   flappyhost collision-bench [checks]
+*       Times the old check against every pillar and the broadphase in Collision.h,
+*       in nanoseconds per check, with 3, 32 and 256 pillars in a row.
+*
+*   flappyhost store-bench [games] [players]
+*       Sends that many random scores to a ScoreStore on flappy_store_bench.bin and
+*       lets it write them. Prints how many times each of its sectors was erased, the
+*       longest work() step, and how long reading it back at startup takes. Fails if
+*       the leaderboard read back is not the one in memory, or if a power cut in the
+*       middle of moving to a new sector loses the scores that were already saved.
+*       A region of 20 sectors has to read back the same after the log went round
+*       it twice. Then saves games/20 random replays to a ReplayStore the same way, and fails if
+*       a game over ever erases, if a power cut halfway through one loses the one
+*       before, or if the last one doesn't read back.
+*
+*   flappyhost input-bench [presses] [seed]
+*       Plays the game with a button that bounces for a few ms on every press and
+*       release, once reading the pin when the bird is due like the game always did,
+*       and once with the interrupt in ButtonInput.h. Prints how long it took from
+*       each press to the flap starting, and how many presses were missed or flapped
+*       twice.
+*
+*   flappyhost autopilot [milliseconds] [seed]
+*       First checks Autopilot::step() against the real game: the bot from `record`
+*       plays a round, and step() is given the same button at every step. It is done
+*       with the hitbox and again with the pixel collision (see Occupancy.h). Then the
+*       game plays itself in attract mode (see Autopilot.h) for that long, in the
+*       deterministic mode. Prints the snapshot size, the crashes and scores, and how
+*       many planner nodes per second decide() gets through with either crash. Fails if step() ends up
+*       somewhere else than the game, or if restore(snapshot()) changes anything.
+*
+*   flappyhost raster-verify [update]
+*       Draws random rects, outlines and sprites with Raster and with the old pixel
+*       by pixel way and fails if any pixel is different. Then plays 3 recorded games
+*       in each mode and fails if the frames the panel showed are not the ones in
+*       golden_frames.txt. "update" writes the file again from this build instead.
+*       The file is from the default build: FIXED=16 times the bird differently.
+*
+*   flappyhost raster-bench [shapes]
+*       Fills, outlines and blits that many shapes the old way and with Raster, and
+*       prints how many pixels per microsecond each one draws.
+*
+*   flappyhost course-bench [steps]
+*       Moves courses of pillars on the 64x48, 128x64 and 320x240 configs, with up to
+*       12 pairs on screen, and draws every step by clearing and drawing every rect
+*       and with the scrolling in CourseRenderer.h. Prints the ns per step of each
+*       and how many columns the scrolling had to work out. Fails if any step comes
+*       out different.
+*
+*   flappyhost display-bench [milliseconds] [MHz]
+*       Plays the game with the bot in both modes, with the frames going out by DMA
+*       (see DisplayFlusher.h) over an SPI bus of that speed, or 8, 2 and 0.5 MHz.
+*       Prints how busy the bus was, how long a frame took from flush() to the
+*       panel, and how many frames were merged into a newer one because the bus
+*       was still busy. That bus time is what flush() used to wait for. Fails if
+*       the panel is ever not the last frame once the bus is free.
+*
+*   flappyhost bench [out.json] [thresholdPercent] [baseline.json ...]
+*   flappyhost bench-counts [out.json]
+*       The benchmark suite in BenchSuite.h: the hot paths one call at a time, and
+*       whole games at several levels of the difficulty table. Prints ns, allocations
+*       and display bytes per op and writes them to out.json (bench_results.json).
+*       Fails if anything allocates, a baseline is missing, anything sends more
+*       display bytes than a baseline, or is more than thresholdPercent (25) slower
+*       than a baseline with times. bench-counts writes the file without the times,
+*       which is how bench_counts.json is made. `make bench`, `make bench-baseline`
+*       and `make bench-counts` run it.
+*
+*   flappyhost sweep grid [gamesPerPoint] [threads] [NAME=low:high:count ...]
+*   flappyhost sweep random [gamesPerPoint] [threads] [tunings] [NAME=low:high ...]
+*       Plays gamesPerPoint (2000) games with a bot for every tuning of the numbers
+*       in GameConfig (see Sweep.h), on that many threads or every core, and prints
+*       the scores, how many games were still going after so long, and the crash
+*       rate at each speed. A grid without any NAME goes over the pillars' speed up,
+*       a random sweep tries 32 tunings.
+*
+*   flappyhost sweep-scaling [gamesPerPoint] [maxThreads]
+*       Plays the default grid of a sweep with gamesPerPoint (1000) games on 1 thread,
+*       then 2, and so on up to maxThreads or every core, and prints the time and the
+*       speedup over 1 thread of each. Fails if any comes out different from 1 thread.
+*
+*   flappyhost sweep-verify [games] [seed]
+*       Makes the tuning of the config, and of two others with other numbers
+*       compiled in, the way a sweep does (see Sweep.h). Fails if it isn't the one
+*       the compiler made, or if any step of that many games with each is different.
+*
+*   flappyhost collision-verify [steps] [seed]
+*       Moves the pillars with the occupancy of the pixel collision kept (see
+*       Occupancy.h) and fails if it is ever not the pillars drawn on the screen, or
+*       if the bird at any height crashes when its pixels don't touch a pillar's, or
+*       the other way around. Prints how often the hitbox says something else, the ns
+*       per check of both, and what keeping the occupancy costs a pillar step.
+******************************/
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "Arduino/Arduino.h"
+#include "HostPlatform.h"
+#include "SparkFunMicroOLED/SparkFunMicroOLED.h"
+#include "../FlappyGame.h"
+#include "BatchSim.h"
+#include "BenchSuite.h"
+#include "Sweep.h"
+#include "../Profiler.h"
+
+static double secondsNow() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Hold the button whenever the bird is below the middle of the gap it is heading for
+template <class Config>
+static bool botWantsToFlap(BasicBird<Config> &bird, const typename BasicPillar<Config>::Ring &pillars) {
+    int birdX = Config::BIRD_X;
+    int target = Config::SCREEN_HEIGHT / 2;
+    for (int i = 0; i < pillars.size(); i++) {
+        if (pillars[i].getXEnd() >= birdX - Config::BIRD_SIZE) {
+            PillarRects rects = pillars[i].getPillarRects();
+            target = (rects.up.height + rects.down.y) / 2;
+            break;
+        }
+    }
+    return bird.getBirdPosition() > target;
+}
+
+// The bot hardly ever crashes, so batch-verify makes it hold the button for a while
+// now and then, to make sure resets get compared too. Only depends on the tick and the
+// game, never on the game's state
+static bool mistake(long tick, int game) {
+    return (tick + game * 97) % 1000 < 20;
+}
+
+// One headless tick after another, starting over after every crash. Returns the crashes.
+// With a game number the bot makes the same mistakes batch-verify gives that game
+template <class Config>
+static long playHeadless(BasicBird<Config> &bird, BasicPillarManager<Config> &pillarManager, long ticks, int &bestScore, int game = -1) {
+    long crashes = 0;
+    for (long tick = 0; tick < ticks; tick++) {
+        const typename BasicPillar<Config>::Ring &pillars = pillarManager.timeToMove();
+        bool flap = botWantsToFlap(bird, pillars);
+        if (game >= 0 && mistake(tick, game)) {
+            flap = true;
+        }
+        bird.userInput(flap);
+        if (bird.birdCrashed(pillars)) {
+            if (pillarManager.getAmountOfPillarsUserPassed() > bestScore) {
+                bestScore = pillarManager.getAmountOfPillarsUserPassed();
+            }
+            bird.reset();
+            pillarManager.reset();
+            crashes++;
+        }
+    }
+    if (pillarManager.getAmountOfPillarsUserPassed() > bestScore) {
+        bestScore = pillarManager.getAmountOfPillarsUserPassed();
+    }
+    return crashes;
+}
+
+// Runs on any GameConfig, because nothing here needs a screen
+template <class Config>
+static int runHeadless(long ticks, uint32_t seed) {
+    HostPlatform::seedRandom(seed);
+
+    BasicBird<Config> bird;
+    BasicPillarManager<Config> pillarManager;
+
+    int bestScore = 0;
+    double start = secondsNow();
+    long games = 1 + playHeadless(bird, pillarManager, ticks, bestScore);
+    double seconds = secondsNow() - start;
+
+    printf("screen: %dx%d\n", Config::SCREEN_WIDTH, Config::SCREEN_HEIGHT);
+    printf("ticks: %ld\n", ticks);
+    printf("games: %ld\n", games);
+    printf("best score: %d\n", bestScore);
+    printf("seconds: %.3f\n", seconds);
+    printf("ticks per second: %.0f\n", ticks / seconds);
+    return 0;
+}
+
+static int runPhysics(unsigned long milliseconds, unsigned long frameMs, uint32_t seed) {
+    HostPlatform::seedRandom(seed);
+
+    Bird bird;
+    PillarManager pillarManager;
+
+    long games = 1;
+    int bestScore = 0;
+    bool previousFlap = false;
+    double start = secondsNow();
+    for (unsigned long time = 0; time < milliseconds; time += frameMs) {
+        const PillarRing &pillars = pillarManager.advance(frameMs);
+        bool flap = botWantsToFlap(bird, pillars);
+        if (flap && !previousFlap) {
+            bird.jump(3);
+        }
+        previousFlap = flap;
+        bird.advance(frameMs, flap);
+        if (bird.birdCrashed(pillars)) {
+            if (pillarManager.getAmountOfPillarsUserPassed() > bestScore) {
+                bestScore = pillarManager.getAmountOfPillarsUserPassed();
+            }
+            bird.reset();
+            pillarManager.reset();
+            previousFlap = false;
+            games++;
+        }
+    }
+    double seconds = secondsNow() - start;
+    if (pillarManager.getAmountOfPillarsUserPassed() > bestScore) {
+        bestScore = pillarManager.getAmountOfPillarsUserPassed();
+    }
+
+    printf("game time: %.1f s in %lu ms frames\n", milliseconds / 1000.0, frameMs);
+    printf("games: %ld\n", games);
+    printf("best score: %d\n", bestScore);
+    printf("seconds: %.3f\n", seconds);
+    printf("game seconds per second: %.0f\n", milliseconds / 1000.0 / seconds);
+
+    // The pillars on their own, an hour ahead in one call
+    PillarManager skipping;
+    PillarManager chunks(skipping.getState());
+    PillarManager stepping(skipping.getState());
+    Occupancy chunksOccupancy;
+    Occupancy steppingOccupancy;
+    chunks.trackOccupancy(&chunksOccupancy);
+    stepping.trackOccupancy(&steppingOccupancy);
+    start = secondsNow();
+    skipping.advance(3600000UL);
+    seconds = secondsNow() - start;
+    printf("skipping the pillars an hour ahead: %.3f ms, %d pillars passed, delay now %d ms\n",
+           seconds * 1000, skipping.getAmountOfPillarsUserPassed(), skipping.getDelay());
+
+    // The same hour in random bits, and one step at a time, have to end up in the same place.
+    // Those two keep the occupancy too, which has to come out the same
+    for (unsigned long time = 0; time < 3600000UL;) {
+        unsigned long bit = std::min((unsigned long)random(1, 5000), 3600000UL - time);
+        chunks.advance(bit);
+        time += bit;
+    }
+    for (uint32_t i = 0; i < skipping.getSteps(); i++) {
+        stepping.timeToMove();
+    }
+    PillarManager::State skipped = skipping.getState();
+    PillarManager::State inBits = chunks.getState();
+    PillarManager::State stepped = stepping.getState();
+    stepped.timeSinceLastStep = skipped.timeSinceLastStep; // timeToMove() doesn't keep time
+    bool same = memcmp(&skipped, &stepped, sizeof(skipped)) == 0 && memcmp(&inBits, &stepped, sizeof(stepped)) == 0;
+    for (int x = 0; same && x < LCDWIDTH; x++) {
+        same = memcmp(chunksOccupancy.getColumn(x), steppingOccupancy.getColumn(x), Occupancy::WORDS * sizeof(uint64_t)) == 0;
+    }
+    printf("the hour skipped, in random bits and one step at a time: %s\n", same ? "the same" : "DIFFERENT");
+    return same ? 0 : 1;
+}
+
+// Calls loop() until the virtual clock has gone that far. Returns the longest pass of
+// loop() in ms, which is the longest the Photon couldn't do anything else
+static unsigned long loopGame(FlappyGame &game, unsigned long milliseconds) {
+    unsigned long end = millis() + milliseconds;
+    unsigned long longest = 0;
+    while (millis() < end) {
+        unsigned long before = millis();
+        game.loop();
+        longest = (millis() - before > longest) ? millis() - before : longest;
+        // A pass of loop() on the Photon takes a little time even when nothing is due
+        if (millis() == before) {
+            HostPlatform::advanceMillis(1);
+        }
+    }
+    return longest;
+}
+
+static int runGame(unsigned long milliseconds, uint32_t seed, unsigned long periodMs, unsigned long holdMs, MotionMode mode) {
+    HostPlatform::seedRandom(seed);
+    HostPlatform::PeriodicPress press = { periodMs, holdMs };
+    HostPlatform::setButtonScript(HostPlatform::periodicPress, &press);
+
+    MicroOLED oled(MODE_SPI, D7, D6, A2);
+    FlappyGame game(oled, D0, mode);
+    game.useDisplayDma(D6, A2); // Like the sketch
+
+    game.begin();
+    unsigned long longestLoop = loopGame(game, milliseconds);
+    DisplayFlusher &screen = game.getDisplayFlusher();
+    while (screen.isBusy()) {
+        HostPlatform::advanceMillis(1); // The last frame is still on its way
+    }
+
+    oled.printDisplayed(stdout);
+    printf("score: %d\n", game.getPillarManager().getAmountOfPillarsUserPassed());
+    printf("high score: %d\n", game.getHighScore());
+
+    // What went over the bus. A full display() is 384 data bytes and 18 command bytes
+    unsigned long frames = screen.getFramesSent();
+    bool matches = memcmp(oled.getDisplayedBuffer(), oled.getScreenBuffer(), LCDWIDTH * LCDPAGES) == 0;
+    printf("frames sent: %lu (%lu flushed, %lu merged into a newer one)\n", frames, screen.getFlushes(), screen.getFramesMerged());
+    printf("bus bytes: %lu data, %lu command\n", oled.getDataBytes(), oled.getCommandBytes());
+    printf("data bytes per frame: %.1f (full frame %d)\n", frames ? (double)screen.getDataBytesSent() / frames : 0.0, LCDWIDTH * LCDPAGES);
+    printf("flush to panel: mean %.1f us, max %lu us\n", frames ? (double)screen.getLatencyMicros() / frames : 0.0,
+           screen.getMaxLatencyMicros());
+    printf("panel matches buffer: %s\n", matches ? "yes" : "no");
+    printf("longest loop() pass: %lu ms\n", longestLoop);
+
+    // How late each task ran against its deadline. The clock is virtual, so the same
+    // arguments always give the same numbers
+    Scheduler &scheduler = game.getScheduler();
+    for (int task = 0; task < scheduler.getTaskCount(); task++) {
+        unsigned long runs = scheduler.getRuns(task);
+        printf("task %s: %lu runs, mean lateness %.3f ms, max lateness %lu ms\n", scheduler.getTaskName(task), runs,
+               runs ? (double)scheduler.getTotalLateness(task) / runs : 0.0, scheduler.getMaxLateness(task));
+    }
+    return 0;
+}
+
+#ifdef FLAPPY_PROFILE
+// Reads the dumps Profiler wrote, the way a computer on the other end of the Photon's
+// serial port would. The layout is at the bottom of Profiler.cpp
+static uint32_t get32(const uint8_t *in) {
+    return in[0] | (in[1] << 8) | (in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+// The upper edge of the bucket that the given share of the times falls in
+static double bucketPercentile(const uint8_t *buckets, int bucketCount, uint32_t count, double share) {
+    uint64_t seen = 0;
+    for (int b = 0; b < bucketCount; b++) {
+        seen += get32(buckets + 4 * b);
+        if (count > 0 && seen >= share * count) {
+            return (b == 0) ? 0.0 : (double)((uint64_t)1 << b);
+        }
+    }
+    return 0.0;
+}
+
+static int printProfileDump(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        printf("no profile dump in %s\n", path);
+        return 1;
+    }
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[4096];
+    size_t got;
+    while ((got = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + got);
+    }
+    fclose(file);
+
+    // Find the last whole dump
+    const uint8_t *last = NULL;
+    int dumps = 0;
+    size_t at = 0;
+    while (at + 20 <= bytes.size()) {
+        const uint8_t *dump = &bytes[at];
+        uint32_t length = get32(dump + 16);
+        if (memcmp(dump, "FPRF", 4) != 0 || length < 20 || at + length > bytes.size()) {
+            break;
+        }
+        last = dump;
+        dumps++;
+        at += length;
+    }
+    if (last == NULL) {
+        printf("no whole profile dump in %s\n", path);
+        return 1;
+    }
+
+    int stages = last[5];
+    int tasks = last[6];
+    int bucketCount = last[7];
+    double ticksPerMicrosecond = get32(last + 8) / 1e6;
+    printf("dumps: %d, last one at %lu ms\n", dumps, (unsigned long)get32(last + 12));
+    printf("%-9s %9s %10s %10s %10s %10s\n", "stage", "count", "mean us", "p50 us <", "p99 us <", "max us");
+    const uint8_t *in = last + 20;
+    for (int stage = 0; stage < stages; stage++) {
+        char name[9] = { 0 };
+        memcpy(name, in, 8);
+        uint32_t count = get32(in + 8);
+        uint32_t maxTicks = get32(in + 12);
+        uint64_t totalTicks = get32(in + 16) | ((uint64_t)get32(in + 20) << 32);
+        const uint8_t *buckets = in + 24;
+        printf("%-9s %9lu %10.3f %10.3f %10.3f %10.3f\n", name, (unsigned long)count,
+               count ? totalTicks / ticksPerMicrosecond / count : 0.0,
+               bucketPercentile(buckets, bucketCount, count, 0.50) / ticksPerMicrosecond,
+               bucketPercentile(buckets, bucketCount, count, 0.99) / ticksPerMicrosecond,
+               maxTicks / ticksPerMicrosecond);
+        in += 24 + 4 * bucketCount;
+    }
+    printf("%-9s %9s %10s %10s\n", "task", "runs", "misses", "max late ms");
+    for (int task = 0; task < tasks; task++) {
+        char name[9] = { 0 };
+        memcpy(name, in, 8);
+        if (name[0] != 0) {
+            printf("%-9s %9lu %10lu %10lu\n", name, (unsigned long)get32(in + 8), (unsigned long)get32(in + 12), (unsigned long)get32(in + 16));
+        }
+        in += 20 + 4 * bucketCount;
+    }
+    return 0;
+}
+
+#endif
+
+// Never pressed, so only the autopilot plays
+static bool neverPressed(unsigned long now, void *context) {
+    (void)now;
+    (void)context;
+    return false;
+}
+
+static int runProfile(unsigned long milliseconds, uint32_t seed, MotionMode mode, bool isAutopilot) {
+#ifdef FLAPPY_PROFILE
+    HostPlatform::seedRandom(seed);
+    HostPlatform::PeriodicPress press = { 400, 120 };
+    if (isAutopilot) {
+        HostPlatform::setButtonScript(neverPressed, NULL);
+    } else {
+        HostPlatform::setButtonScript(HostPlatform::periodicPress, &press);
+    }
+
+    const char *path = "flappy_profile.bin";
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        printf("can't write %s\n", path);
+        return 1;
+    }
+    // 64 bytes a loop, about what the Photon's USB serial buffer takes without waiting
+    Profiler::setDumpFile(file, 64);
+
+    MicroOLED oled(MODE_SPI, D7, D6, A2);
+    FlappyGame game(oled, D0, mode);
+    game.setAutopilot(isAutopilot);
+    game.begin();
+    loopGame(game, milliseconds);
+
+    Profiler::setDumpFile(NULL, 0);
+    fclose(file);
+    printf("dumps sent: %lu\n", Profiler::getDumpsSent());
+    return printProfileDump(path);
+#else
+    (void)milliseconds;
+    (void)seed;
+    (void)mode;
+    (void)isAutopilot;
+    printf("the timers are compiled out in this build, nothing to profile. Build with `make PROFILE=1`\n");
+    return 0; // Not a failure, the build just doesn't have them
+#endif
+}
+
+// The headless bot, pressing the real button of a running game. Every 30 seconds it holds
+// the button for a whole second, which usually ends the game, so there is something to record
+static bool botPress(unsigned long now, void *context) {
+    FlappyGame *game = (FlappyGame *)context;
+    if (now % 30000 >= 29000) {
+        return true;
+    }
+    return botWantsToFlap(game->getBird(), game->getPillarManager().getPillars());
+}
+
+static int runRecord(unsigned long milliseconds, uint32_t seed, unsigned long periodMs, unsigned long holdMs, MotionMode mode, const char *path) {
+    MicroOLED oled(MODE_SPI, D7, D6, A2);
+    FlappyGame game(oled, D0, mode);
+
+    // A period of 0 lets the bot play
+    HostPlatform::PeriodicPress press = { periodMs, holdMs };
+    if (periodMs == 0) {
+        HostPlatform::setButtonScript(botPress, &game);
+    } else {
+        HostPlatform::setButtonScript(HostPlatform::periodicPress, &press);
+    }
+    game.record(seed);
+    game.begin();
+    loopGame(game, milliseconds);
+
+    // The last game that ended, the same way it would be read back on the Photon
+    static uint8_t bytes[Replay::MAX_BYTES];
+    int length = game.readLastReplay(bytes, sizeof(bytes));
+    ReplayPlayer player;
+    if (length == 0 || !player.open(bytes, length)) {
+        printf("no game ended in %lu ms\n", milliseconds);
+        return 1;
+    }
+    FILE *file = fopen(path, "wb");
+    if (file == NULL || fwrite(bytes, 1, length, file) != (size_t)length) {
+        printf("can't write %s\n", path);
+        return 1;
+    }
+    fclose(file);
+    printf("wrote %s: %d bytes, seed %lu, %d edges, crashed at %lu ms with score %d%s\n", path, length,
+           (unsigned long)player.getSeed(), player.getEdgeCount(), player.getCrashTime(), player.getScore(),
+           player.isTruncated() ? " (ran out of room)" : "");
+    return 0;
+}
+
+static int runReplay(const char *path, int times) {
+    static uint8_t bytes[Replay::MAX_BYTES];
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        printf("can't read %s\n", path);
+        return 1;
+    }
+    int length = fread(bytes, 1, sizeof(bytes), file);
+    fclose(file);
+    ReplayPlayer player;
+    if (!player.open(bytes, length)) {
+        printf("%s is not a whole replay\n", path);
+        return 1;
+    }
+    MotionMode mode = (MotionMode)player.getMode();
+    printf("replay: seed %lu, %d edges, %s, crashed at %lu ms with score %d\n", (unsigned long)player.getSeed(),
+           player.getEdgeCount(), mode == TIMED_PHYSICS ? "physics" : "pixel steps", player.getCrashTime(), player.getScore());
+
+    bool allMatch = true;
+    double seconds = 0;
+    for (int i = 0; i < times; i++) {
+        MicroOLED oled(MODE_SPI, D7, D6, A2);
+        FlappyGame game(oled, D0, mode);
+        if (!game.replay(bytes, length)) {
+            printf("recorded with another config (hash %08lx, this build is %08lx)\n",
+                   (unsigned long)player.getConfigHash(), (unsigned long)game.getConfigHash());
+            return 1;
+        }
+
+        double start = secondsNow();
+        game.begin();
+        // Twice as long as the game took is plenty. Not crashing by then is a mismatch too
+        unsigned long end = millis() + 2 * player.getCrashTime() + 10000;
+        while (!game.isReplayDone() && millis() < end) {
+            unsigned long before = millis();
+            game.loop();
+            if (millis() == before) {
+                HostPlatform::advanceMillis(1);
+            }
+        }
+        seconds += secondsNow() - start;
+
+        bool match = game.isReplayDone() && game.getReplayCrashTime() == player.getCrashTime() && game.getReplayScore() == player.getScore();
+        if (!match) {
+            printf("run %d: crashed at %lu ms with score %d, NOT the same\n", i, game.getReplayCrashTime(), game.getReplayScore());
+            allMatch = false;
+        }
+    }
+    printf("%d of %d runs ended the same\n", allMatch ? times : 0, times);
+    printf("seconds per run: %.6f\n", seconds / times);
+    printf("times faster than real time: %.0f\n", player.getCrashTime() / 1000.0 / (seconds / times));
+    return allMatch ? 0 : 1;
+}
+
+static int runBatch(int games, long ticks, uint32_t seed) {
+    BatchSim batch(games, LCDWIDTH, LCDHEIGHT, FLAPPY_SIZE);
+    batch.seed(seed);
+    std::vector<uint8_t> flaps(batch.paddedGames());
+
+    double start = secondsNow();
+    for (long tick = 0; tick < ticks; tick++) {
+        batch.advancePillars();
+        batch.botFlaps(&flaps[0]);
+        batch.advanceBirds(&flaps[0]);
+    }
+    double seconds = secondsNow() - start;
+
+    int bestScore = 0;
+    for (int i = 0; i < games; i++) {
+        if (batch.getBestScore(i) > bestScore) {
+            bestScore = batch.getBestScore(i);
+        }
+    }
+    printf("simd: %s (%d lanes)\n", BatchSim::simdName(), BatchSim::simdLanes());
+    printf("games in batch: %d\n", games);
+    printf("ticks: %ld\n", ticks);
+    printf("crashes: %ld\n", batch.getTotalCrashes());
+    printf("best score: %d\n", bestScore);
+    printf("seconds: %.3f\n", seconds);
+    printf("game ticks per second: %.0f\n", (double)games * ticks / seconds);
+    printf("finished games per second: %.0f\n", batch.getTotalCrashes() / seconds);
+    return 0;
+}
+
+static int runBatchVerify(int games, long ticks, uint32_t seed) {
+    BatchSim batch(games, LCDWIDTH, LCDHEIGHT, FLAPPY_SIZE);
+    batch.seed(seed);
+    std::vector<uint8_t> flaps(batch.paddedGames());
+    for (long tick = 0; tick < ticks; tick++) {
+        batch.advancePillars();
+        batch.botFlaps(&flaps[0]);
+        for (int i = 0; i < games; i++) {
+            flaps[i] |= mistake(tick, i);
+        }
+        batch.advanceBirds(&flaps[0]);
+    }
+
+    int mismatches = 0;
+    for (int i = 0; i < games; i++) {
+        HostPlatform::seedRandom(batch.seedOf(i));
+        Bird bird;
+        PillarManager pillarManager;
+        int bestScore = 0;
+        long crashes = playHeadless(bird, pillarManager, ticks, bestScore, i);
+
+        // BatchSim keeps the bird's delays in doubles. Fixed point ones can only be as close as
+        // FixedPoint.h says, and the positions don't depend on them. The pillars' delay is whole
+        // ms from the difficulty table in both
+#ifdef FLAPPY_FIXED_POINT_BITS
+        bool sameDelays = abs(bird.getDelay() - batch.getBirdDelay(i)) <= 1
+                       && pillarManager.getDelay() == batch.getPillarDelay(i);
+#else
+        bool sameDelays = bird.getDelay() == batch.getBirdDelay(i) && pillarManager.getDelay() == batch.getPillarDelay(i);
+#endif
+
+        const PillarRing &pillars = pillarManager.getPillars();
+        bool same = bird.getBirdPosition() == batch.getBirdPosition(i)
+                 && sameDelays
+                 && pillarManager.getAmountOfPillarsUserPassed() == batch.getScore(i)
+                 && bestScore == batch.getBestScore(i)
+                 && crashes == batch.getCrashes(i)
+                 && pillars.size() == batch.getPillarCount(i);
+        for (int p = 0; same && p < pillars.size(); p++) {
+            same = pillars[p].getX() == batch.getPillarX(i, p);
+        }
+        if (!same) {
+            mismatches++;
+            printf("game %d differs: scalar bird %d score %d crashes %ld, batch bird %d score %d crashes %ld\n",
+                   i, bird.getBirdPosition(), pillarManager.getAmountOfPillarsUserPassed(), crashes,
+                   batch.getBirdPosition(i), batch.getScore(i), batch.getCrashes(i));
+        }
+    }
+
+    printf("simd: %s (%d lanes)\n", BatchSim::simdName(), BatchSim::simdLanes());
+    printf("%d of %d games identical after %ld ticks and %ld crashes\n", games - mismatches, games, ticks, batch.getTotalCrashes());
+    return mismatches == 0 ? 0 : 1;
+}
+
+// The bot again, but holding the button for the last second of every 4, so a short game
+// still goes through crashes, the screens after them and new rounds
+static bool crashingBotPress(unsigned long now, void *context) {
+    if (now % 4000 >= 3000) {
+        return true;
+    }
+    return botPress(now, context);
+}
+
+// begin() may allocate what it needs once. After it, that many passes of loop() (1 ms
+// apart) must not call operator new at all. Fails if they do, in either mode
+static int runAllocVerify(long ticks, uint32_t seed) {
+    bool isOk = true;
+    for (int m = 0; m < 2; m++) {
+        MotionMode mode = (m == 0) ? PIXEL_STEPS : TIMED_PHYSICS;
+        HostPlatform::setMillis(0);
+        HostPlatform::seedRandom(seed);
+        MicroOLED oled(MODE_SPI, D7, D6, A2);
+        FlappyGame game(oled, D0, mode);
+        HostPlatform::setButtonScript(crashingBotPress, &game);
+        game.useDisplayDma(D6, A2); // Like the sketch
+        game.begin();
+
+        unsigned long long before = getAllocationCount();
+        long rounds = 1;
+        uint32_t steps = 0;
+        for (long tick = 0; tick < ticks; tick++) {
+            game.loop();
+            HostPlatform::advanceMillis(1);
+            uint32_t stepsNow = game.getPillarManager().getSteps();
+            rounds += stepsNow < steps;
+            steps = stepsNow;
+        }
+        unsigned long long allocations = getAllocationCount() - before;
+        HostPlatform::setButtonScript(NULL, NULL);
+
+        printf("%-8s %ld ticks, %ld rounds: %llu allocations after begin()\n", (m == 0) ? "pixel" : "physics",
+               ticks, rounds, allocations);
+        isOk = isOk && allocations == 0;
+    }
+    return isOk ? 0 : 1;
+}
+
+// The way Bird::birdCrashed used to do it: every pillar, with an early return
+template <class Pillars>
+static bool linearHitsAnyPillar(const Pillars &pillars, const Hitbox &box) {
+    for (int i = 0; i < pillars.size(); i++) {
+        PillarRects rects = pillars[i].getPillarRects();
+        if (box.bottom <= rects.up.height || box.top >= rects.down.y) {
+            if (box.left <= rects.up.x + rects.up.width && box.right >= rects.up.x) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static int runCollisionBench(long checks) {
+    static const int MAX_PILLARS = 256;
+    static const int SPACING = 20; // From one pillar's left edge to the next one's
+    static const int BOXES = 4096;
+    const int counts[] = { 3, 32, MAX_PILLARS };
+
+    printf("%8s %14s %14s %10s\n", "pillars", "linear ns", "broadphase ns", "hits");
+    for (int c = 0; c < 3; c++) {
+        int count = counts[c];
+        HostPlatform::seedRandom(count);
+
+        // Pillars from left to right with random gaps, like a long PillarRing
+        RingBuffer<Pillar, MAX_PILLARS> pillars;
+        for (int i = 0; i < count; i++) {
+            Pillar pillar(random(4, LCDHEIGHT - DefaultGameConfig::BIRD_SPACE - 4));
+            pillar.changePillars(LCDWIDTH - i * SPACING);
+            pillars.pushBack(pillar);
+        }
+
+        // Birds anywhere along the pillars, worked out ahead so the timing is only the checks
+        std::vector<Hitbox> boxes(BOXES);
+        for (int i = 0; i < BOXES; i++) {
+            boxes[i] = Collision::birdHitbox(random(0, count * SPACING), random(0, LCDHEIGHT), FLAPPY_SIZE, DefaultGameConfig::HITBOX_INSET);
+        }
+
+        long linearHits = 0;
+        double start = secondsNow();
+        for (long i = 0; i < checks; i++) {
+            linearHits += linearHitsAnyPillar(pillars, boxes[i % BOXES]);
+        }
+        double linearSeconds = secondsNow() - start;
+
+        long broadphaseHits = 0;
+        start = secondsNow();
+        for (long i = 0; i < checks; i++) {
+            broadphaseHits += Collision::hitsAnyPillar(pillars, boxes[i % BOXES]);
+        }
+        double broadphaseSeconds = secondsNow() - start;
+
+        printf("%8d %14.2f %14.2f %10ld\n", count, linearSeconds * 1e9 / checks, broadphaseSeconds * 1e9 / checks, broadphaseHits);
+        if (linearHits != broadphaseHits) {
+            printf("the two ways disagree: %ld hits against %ld\n", linearHits, broadphaseHits);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Cycles on x86, where the time stamp counter is there to read, and nanoseconds anywhere else
+static uint64_t cyclesNow() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)(secondsNow() * 1e9);
+#endif
+}
+
+static int runDelayBench(long steps) {
+#ifdef FLAPPY_FIXED_POINT_BITS
+    printf("delays: fixed point with %d fraction bits\n", FLAPPY_FIXED_POINT_BITS);
+#else
+    printf("delays: double for the bird\n");
+#endif
+
+    // Runs of flapping and falling of random lengths, worked out ahead
+    HostPlatform::seedRandom(1);
+    std::vector<uint8_t> flaps(steps);
+    for (long i = 0; i < steps; ) {
+        bool flap = random(2);
+        for (long run = random(1, 60); run > 0 && i < steps; run--) {
+            flaps[i++] = flap;
+        }
+    }
+
+    // How far off the delays are from the way the game always worked them out
+    Bird bird;
+    double gravitationalDelay = 50, flapDelay = 40;
+    int birdMismatches = 0, birdMaxError = 0;
+    for (long i = 0; i < steps; i++) {
+        bird.userInput(flaps[i]);
+        int expected;
+        if (flaps[i]) {
+            expected = flapDelay;
+            flapDelay -= 0.3;
+            gravitationalDelay = 50;
+        } else {
+            expected = gravitationalDelay;
+            gravitationalDelay -= 0.3;
+            flapDelay = 40;
+        }
+        int error = abs(bird.getDelay() - expected);
+        birdMismatches += (error != 0);
+        birdMaxError = (error > birdMaxError) ? error : birdMaxError;
+    }
+
+    // The pillars go by the difficulty table now. With LinearDifficulty it waits the same
+    // whole ms as the old float that lost 0.005 ms a step, until that float drifted to just
+    // under 12 and waited 11 ms from then on. The table stops at 12, like the config says
+    PillarManager pillarManager;
+    float pillarDelay = 30;
+    int pillarMismatches = 0, pillarMaxError = 0;
+    for (long i = 0; i < 10000; i++) {
+        pillarManager.timeToMove();
+        if (pillarDelay > 12.0f) {
+            pillarDelay -= 0.005f;
+        }
+        int error = abs(pillarManager.getDelay() - (int)pillarDelay);
+        pillarMismatches += (error != 0);
+        pillarMaxError = (error > pillarMaxError) ? error : pillarMaxError;
+    }
+    printf("bird delay: %d of %ld steps off, by at most %d ms\n", birdMismatches, steps, birdMaxError);
+    printf("pillar delay: %d of 10000 steps off from the old float curve, by at most %d ms\n", pillarMismatches, pillarMaxError);
+
+    // The time it takes. The pillars' step is all of timeToMove(), the delay is only part of it
+    long sink = 0;
+    uint64_t start = cyclesNow();
+    for (long i = 0; i < steps; i++) {
+        bird.userInput(flaps[i]);
+        sink += bird.getDelay();
+    }
+    uint64_t birdCycles = cyclesNow() - start;
+
+    start = cyclesNow();
+    for (long i = 0; i < steps; i++) {
+        pillarManager.timeToMove();
+        sink += pillarManager.getDelay();
+    }
+    uint64_t pillarCycles = cyclesNow() - start;
+
+    printf("bird step: %.2f cycles\n", (double)birdCycles / steps);
+    printf("pillar step: %.2f cycles\n", (double)pillarCycles / steps);
+    return sink == 42 ? 2 : 0; // Uses sink so the loops can't be thrown away
+}
+
+// A button that bounces. The pin flips at each of these times, starting from up
+struct BouncyButton {
+    std::vector<unsigned long> flips;
+};
+
+static bool bouncyButton(unsigned long now, void *context) {
+    const std::vector<unsigned long> &flips = ((BouncyButton *)context)->flips;
+    return (std::upper_bound(flips.begin(), flips.end(), now) - flips.begin()) & 1;
+}
+
+// Flips the pin an odd number of times, 1 ms apart, so it ends up the other way
+static unsigned long addBounces(BouncyButton &button, unsigned long time) {
+    int flips = 1 + 2 * random(0, 4);
+    for (int i = 0; i < flips; i++) {
+        button.flips.push_back(time + i);
+    }
+    return time + flips - 1;
+}
+
+static void printLatencies(const char *name, std::vector<unsigned long> &latencies, int presses, int missed, int doubled) {
+    std::sort(latencies.begin(), latencies.end());
+    size_t n = latencies.size();
+    if (n == 0) {
+        printf("%-10s no presses measured\n", name);
+        return;
+    }
+    unsigned long total = 0;
+    for (size_t i = 0; i < n; i++) {
+        total += latencies[i];
+    }
+    printf("%-10s %7d %7d %7d %8.1f %6lu %6lu %6lu %6lu\n", name, presses, missed, doubled, (double)total / n,
+        latencies[n / 2], latencies[n * 9 / 10], latencies[n * 99 / 100], latencies[n - 1]);
+}
+
+static int runInputBench(int presses, uint32_t seed) {
+    // The same presses for both ways: 150-700 ms apart, held 2-150 ms, so some taps are
+    // over before the bird's next step, and every edge bounces for up to 7 ms
+    HostPlatform::seedRandom(seed);
+    BouncyButton button;
+    std::vector<unsigned long> pressTimes;
+    unsigned long time = 1000;
+    for (int i = 0; i < presses; i++) {
+        time += random(150, 700);
+        pressTimes.push_back(time);
+        time = addBounces(button, time);
+        time = addBounces(button, time + random(2, 150));
+    }
+    unsigned long end = time + 1000;
+
+    printf("%-10s %7s %7s %7s %8s %6s %6s %6s %6s\n", "input", "presses", "missed", "doubled", "mean ms", "p50", "p90", "p99", "max");
+    for (int way = 0; way < 2; way++) {
+        HostPlatform::setMillis(0);
+        HostPlatform::seedRandom(seed);
+        HostPlatform::setButtonScript(bouncyButton, &button);
+        MicroOLED oled(MODE_SPI, D7, D6, A2);
+        FlappyGame game(oled, D0);
+        game.setButtonInterrupt(way == 1);
+        game.begin();
+
+        // Every flap, and when the game was playing
+        std::vector<unsigned long> flapTimes;
+        std::vector<std::pair<unsigned long, GameState> > states;
+        states.push_back(std::make_pair(0UL, game.getState()));
+        while (millis() < end) {
+            unsigned long before = millis();
+            unsigned long flaps = game.getFlaps();
+            game.loop();
+            if (game.getFlaps() != flaps) {
+                flapTimes.push_back(game.getLastFlapTime());
+            }
+            if (game.getState() != states.back().second) {
+                states.push_back(std::make_pair(millis(), game.getState()));
+            }
+            if (millis() == before) {
+                HostPlatform::advanceMillis(1);
+            }
+        }
+
+        // Each press gets the first flap after it, if it is before the next press. Presses
+        // near a crash or on the screens in between don't count
+        std::vector<unsigned long> latencies;
+        int measured = 0, missed = 0, doubled = 0;
+        for (int i = 0; i < presses; i++) {
+            unsigned long press = pressTimes[i];
+            unsigned long next = (i + 1 < presses) ? pressTimes[i + 1] : end;
+            bool playing = true;
+            for (size_t s = 0; s < states.size(); s++) {
+                bool during = states[s].first <= press + 100 && (s + 1 == states.size() || states[s + 1].first > press);
+                playing &= !during || states[s].second == PLAYING;
+            }
+            if (!playing) {
+                continue;
+            }
+            measured++;
+            std::vector<unsigned long>::iterator flap = std::lower_bound(flapTimes.begin(), flapTimes.end(), press);
+            int flapsInWindow = 0;
+            for (std::vector<unsigned long>::iterator f = flap; f != flapTimes.end() && *f < next; ++f) {
+                flapsInWindow++;
+            }
+            if (flapsInWindow == 0) {
+                missed++;
+                continue;
+            }
+            doubled += (flapsInWindow > 1);
+            latencies.push_back(*flap - press);
+        }
+        printLatencies((way == 1) ? "interrupt" : "polled", latencies, measured, missed, doubled);
+        if (way == 1) {
+            ButtonInput &input = game.getButtonInput();
+            printf("interrupt: %lu edges taken, %lu bounces ignored, %lu dropped\n", input.getEdges(), input.getBounces(), input.getDropped());
+        }
+        detachInterrupt(D0);
+    }
+    return 0;
+}
+
+static bool sameLeaderboard(ScoreStore &a, ScoreStore &b) {
+    if (a.getEntryCount() != b.getEntryCount()) {
+        return false;
+    }
+    for (int i = 0; i < a.getEntryCount(); i++) {
+        if (a.getEntry(i).player != b.getEntry(i).player || a.getEntry(i).score != b.getEntry(i).score) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The same for the replays: random ones saved one after the other, each written in the
+// idle time after its game. Now and then the power goes out halfway through one
+static bool runReplayStoreBench(int games) {
+    const Flashee::flash_addr_t start = 260 * 4096, end = 264 * 4096; // Where FlappyGame keeps them
+    const int sectors = (end - start) / 4096;
+    ReplayStore store;
+    store.begin(Flashee::Devices::createUserFlashRegion(start, end));
+
+    static uint8_t saved[Replay::MAX_BYTES]; // The last one that was all written
+    static uint8_t replay[Replay::MAX_BYTES];
+    static uint8_t readBack[Replay::MAX_BYTES];
+    int savedLength = 0;
+    long steps = 0;
+    int cuts = 0;
+    for (int game = 0; game < games; game++) {
+        bool isCut = game % 50 == 49;
+        // One that is cut off is a long one, so it is still being written when the power goes
+        int length = isCut ? Replay::MAX_BYTES : random(Replay::HEADER_SIZE, Replay::MAX_BYTES + 1);
+        for (int i = 0; i < length; i++) {
+            replay[i] = (uint8_t)random(0, 256);
+        }
+        unsigned long erases = store.getErases();
+        store.submit(replay, length);
+        if (store.getErases() != erases) {
+            printf("replays: the game over erased a sector\n");
+            return false;
+        }
+        if (isCut) {
+            // Cut off after a few chunks. The one before has to come back
+            for (int i = 0; i < 3; i++) {
+                store.work(1000);
+            }
+            ReplayStore recovered;
+            recovered.begin(Flashee::Devices::createUserFlashRegion(start, end));
+            int recoveredLength = recovered.read(readBack, sizeof(readBack));
+            if (recoveredLength != savedLength || memcmp(readBack, saved, savedLength) != 0) {
+                printf("replays: a power cut halfway through a replay lost the one before\n");
+                return false;
+            }
+            cuts++;
+        }
+        while (store.work(1000)) {
+            steps++;
+        }
+        memcpy(saved, replay, length);
+        savedLength = length;
+    }
+
+    ReplayStore recovered;
+    recovered.begin(Flashee::Devices::createUserFlashRegion(start, end));
+    int recoveredLength = recovered.read(readBack, sizeof(readBack));
+    printf("%d replays in %ld steps, %d power cuts halfway through one\n", games, steps, cuts);
+    for (int sector = 0; sector < sectors; sector++) {
+        printf("replay sector %d: %lu erases%s\n", sector, Flashee::Devices::getEraseCount(start + sector * 4096),
+            (sector == store.getNewestSector()) ? " (newest)" : "");
+    }
+    if (games > 0 && (recoveredLength != savedLength || memcmp(readBack, saved, savedLength) != 0)) {
+        printf("the replay read back is different\n");
+        return false;
+    }
+    return true;
+}
+
+static int runStoreBench(int games, int players) {
+    // Its own file, started from a brand new (all erased) chip every time
+    const char *path = "flappy_store_bench.bin";
+    remove(path);
+    Flashee::Devices::setHostFile(path);
+    const Flashee::flash_addr_t start = 256 * 4096, end = 260 * 4096; // Where FlappyGame keeps it
+    const int sectors = (end - start) / 4096;
+
+    ScoreStore store;
+    store.begin(Flashee::Devices::createUserFlashRegion(start, end));
+    HostPlatform::seedRandom(1);
+
+    long steps = 0;
+    double longestStep = 0;
+    long highScores = 0; // Each one was a write to address 10 the old way
+    bool cutTested = false;
+    for (int game = 0; game < games; game++) {
+        // Scores slowly get better, like players do
+        uint32_t best = store.getBestScore();
+        store.submit(random(0, players), random(0, 10 + game / 50));
+        highScores += (store.getBestScore() > best);
+
+        // What is on the flash before this game's score goes in
+        ScoreStore saved;
+        if (!cutTested) {
+            saved.begin(Flashee::Devices::createUserFlashRegion(start, end));
+        }
+        unsigned long erases = store.getErases();
+
+        // The game over screen is the idle time. Everything is written before the next game
+        while (true) {
+            double stepStart = secondsNow();
+            if (!store.work(1000)) {
+                break;
+            }
+            double stepTime = secondsNow() - stepStart;
+            longestStep = (stepTime > longestStep) ? stepTime : longestStep;
+            steps++;
+
+            if (!cutTested && erases > 0 && store.getErases() > erases) {
+                // The power goes out right after an erase that isn't the first, and one more
+                // step. The sector before is still whole, so nothing that was saved is lost
+                cutTested = true;
+                store.work(1000);
+                ScoreStore recovered;
+                recovered.begin(Flashee::Devices::createUserFlashRegion(start, end));
+                if (!sameLeaderboard(saved, recovered)) {
+                    printf("a power cut while moving to a new sector lost saved scores\n");
+                    return 1;
+                }
+                printf("power cut while moving to a new sector: recovered sector %d, %d lines\n", recovered.getActiveSector(), recovered.getEntryCount());
+            }
+        }
+    }
+
+    printf("%d games, %d players: %lu records written in %ld steps, longest step %.1f us\n",
+        games, players, store.getRecordsWritten(), steps, longestStep * 1e6);
+    for (int sector = 0; sector < sectors; sector++) {
+        printf("sector %d: %lu erases%s\n", sector, Flashee::Devices::getEraseCount(start + sector * 4096),
+            (sector == store.getActiveSector()) ? " (active)" : "");
+    }
+    printf("the old way: %ld erases of the sector with address 10\n", highScores);
+
+    // What startup does, timed
+    const int RECOVERIES = 1000;
+    ScoreStore recovered;
+    Flashee::FlashDevice *flash = Flashee::Devices::createUserFlashRegion(start, end);
+    double recoveryStart = secondsNow();
+    for (int i = 0; i < RECOVERIES; i++) {
+        recovered.begin(flash);
+    }
+    printf("startup recovery: %.1f us\n", (secondsNow() - recoveryStart) * 1e6 / RECOVERIES);
+
+    for (int i = 0; i < recovered.getEntryCount(); i++) {
+        printf("  %d. player %u: %lu\n", i + 1, recovered.getEntry(i).player, (unsigned long)recovered.getEntry(i).score);
+    }
+    if (!sameLeaderboard(store, recovered)) {
+        printf("the leaderboard read back is different\n");
+        return 1;
+    }
+
+    // A region bigger than ScoreStore uses. The log has to stay where begin() finds it,
+    // however many times it goes round
+    const Flashee::flash_addr_t bigStart = 300 * 4096, bigEnd = 320 * 4096;
+    ScoreStore big;
+    big.begin(Flashee::Devices::createUserFlashRegion(bigStart, bigEnd));
+    int rounds = 0;
+    for (uint32_t score = 1; rounds < 40; score++) {
+        unsigned long erases = big.getErases();
+        big.submit(score % players, score);
+        while (big.work(1000)) {
+        }
+        rounds += big.getErases() != erases;
+    }
+    ScoreStore bigRecovered;
+    bigRecovered.begin(Flashee::Devices::createUserFlashRegion(bigStart, bigEnd));
+    if (!sameLeaderboard(big, bigRecovered)) {
+        printf("a 20 sector region: the leaderboard read back after %d sectors is different\n", rounds);
+        return 1;
+    }
+    printf("a 20 sector region: read back the same after %d sectors\n", rounds);
+    return runReplayStoreBench(games / 20) ? 0 : 1;
+}
+
+// Plays a round with the bot from `record`, and then the same round again with nothing
+// but Autopilot::step(), pressing the button wherever the replay of it does. The step()s
+// crash the way the autopilot of the game was told to
+static bool stepMatchesGame(uint32_t seed, bool isPixelCollision) {
+    HostPlatform::setMillis(0); // The bot holds the button for the last second of every 30
+    MicroOLED oled(MODE_SPI, D7, D6, A2);
+    FlappyGame game(oled, D0);
+    HostPlatform::setButtonScript(botPress, &game);
+    game.record(seed);
+    game.setPixelCollision(isPixelCollision);
+    game.begin();
+    const CollisionMask *birdShape = game.getAutopilot().getBirdShape();
+    GameSnapshot simulated = game.snapshot(); // Right where the first loop() starts from
+    while (game.getState() == PLAYING) {
+        unsigned long before = millis();
+        game.loop();
+        if (millis() == before) {
+            HostPlatform::advanceMillis(1);
+        }
+    }
+
+    static uint8_t bytes[Replay::MAX_BYTES];
+    ReplayPlayer player;
+    int length = game.readLastReplay(bytes, sizeof(bytes));
+    if (length == 0 || !player.open(bytes, length)) {
+        printf("step(): the round wasn't recorded\n");
+        return false;
+    }
+    // The bird's next step is always nextBird from now, so the button for it is known up front
+    bool isAlive = true;
+    while (isAlive && simulated.roundTime <= player.getCrashTime()) {
+        unsigned long stepTime = simulated.roundTime + (simulated.nextBird > 0 ? simulated.nextBird : 0);
+        isAlive = Autopilot::step(simulated, player.buttonAt(stepTime), birdShape);
+    }
+    bool match = !isAlive && simulated.roundTime == player.getCrashTime() && (int)simulated.pillars.pillarsPassed == player.getScore();
+    printf("step(), %s: crashed at %lu ms with score %lu, the game at %lu ms with %d, %s\n", isPixelCollision ? "pixels" : "hitbox", (unsigned long)simulated.roundTime,
+           (unsigned long)simulated.pillars.pillarsPassed, player.getCrashTime(), player.getScore(), match ? "the same" : "NOT the same");
+    return match;
+}
+
+static int runAutopilot(unsigned long milliseconds, uint32_t seed) {
+    printf("snapshot: %d bytes (bird %d, pillars %d)\n", (int)sizeof(GameSnapshot), (int)sizeof(Bird::State), (int)sizeof(PillarManager::State));
+    bool isOk = stepMatchesGame(seed, false);
+    isOk = stepMatchesGame(seed, true) && isOk;
+
+    MicroOLED oled(MODE_SPI, D7, D6, A2);
+    FlappyGame game(oled, D0);
+    HostPlatform::setButtonScript(neverPressed, NULL);
+    game.record(seed);
+    game.setAutopilot(true);
+    game.begin();
+
+    // Some of the games it saw, to time decide() on its own afterwards
+    std::vector<GameSnapshot> samples;
+    unsigned long crashes = 0;
+    int bestScore = 0;
+    bool isRestoreChecked = false;
+    GameState lastState = game.getState();
+    unsigned long end = millis() + milliseconds;
+    while (millis() < end) {
+        unsigned long before = millis();
+        game.loop();
+        if (millis() == before) {
+            HostPlatform::advanceMillis(1);
+        }
+
+        GameState state = game.getState();
+        int score = game.getPillarManager().getAmountOfPillarsUserPassed();
+        if (lastState == PLAYING && state != PLAYING) {
+            crashes++;
+            printf("crashed at %lu ms with score %d\n", millis(), score);
+        }
+        lastState = state;
+        if (state != PLAYING) {
+            continue;
+        }
+        bestScore = (score > bestScore) ? score : bestScore;
+        if (samples.size() < 4096 && game.getAutopilot().getDecisions() % 16 == 0) {
+            samples.push_back(game.snapshot());
+        }
+
+        // Halfway through, putting the game back where it already is must change nothing
+        if (!isRestoreChecked && end - millis() < milliseconds / 2) {
+            isRestoreChecked = true;
+            GameSnapshot before = game.snapshot();
+            game.restore(before);
+            GameSnapshot after = game.snapshot();
+            bool same = memcmp(&before, &after, sizeof(GameSnapshot)) == 0;
+            printf("restore(snapshot()): %s\n", same ? "the same" : "NOT the same");
+            isOk = isOk && same;
+        }
+    }
+
+    Autopilot &autopilot = game.getAutopilot();
+    printf("played %.1f s: %lu crashes, best score %d, score now %d\n", milliseconds / 1000.0, crashes, bestScore,
+           game.getPillarManager().getAmountOfPillarsUserPassed());
+    printf("decisions: %lu, nodes per decision: %.1f (beam %d, %d ms ahead)\n", autopilot.getDecisions(),
+           autopilot.getDecisions() ? (double)autopilot.getNodes() / autopilot.getDecisions() : 0.0, Autopilot::BEAM_WIDTH, (int)Autopilot::HORIZON);
+
+    // decide() on its own, over the games it saw, until it has run for a while. Then again
+    // with the pixel collision
+    SpriteAtlas atlas(oled);
+    atlas.build(FLAPPY_SIZE);
+    CollisionMask birdShape = CollisionMask::filled(atlas.getBird());
+    for (int pixels = 0; pixels < 2; pixels++) {
+        Autopilot timed;
+        timed.setPixelCollision(pixels ? &birdShape : NULL);
+        double start = secondsNow();
+        double seconds = 0;
+        while (!samples.empty() && seconds < 0.5) {
+            for (size_t i = 0; i < samples.size(); i++) {
+                timed.decide(samples[i]);
+            }
+            seconds = secondsNow() - start;
+        }
+        if (seconds > 0) {
+            printf("planner, %s: %.0f nodes per second, %.1f us per decision\n", pixels ? "pixels" : "hitbox",
+                   timed.getNodes() / seconds, seconds * 1e6 / timed.getDecisions());
+        }
+    }
+    return isOk ? 0 : 1;
+}
+
+// ================== Rasterizer ============================
+
+// The frames the panel showed in a recorded game, folded into one number. A frame is
+// counted whenever what the panel shows changes
+struct FrameHash {
+    unsigned long frames;
+    uint32_t hash;
+};
+
+static FrameHash hashGameFrames(uint32_t seed, MotionMode mode, unsigned long milliseconds) {
+    // A brand new flash chip and clock, so the high scores and the bot's presses come out the same every time
+    const char *flashPath = "flappy_golden_flash.bin";
+    remove(flashPath);
+    Flashee::Devices::setHostFile(flashPath);
+    HostPlatform::setMillis(0);
+    HostPlatform::seedRandom(seed);
+
+    MicroOLED oled(MODE_SPI, D7, D6, A2);
+    FlappyGame game(oled, D0, mode);
+    HostPlatform::setButtonScript(botPress, &game);
+    game.record(seed);
+    game.useDisplayDma(D6, A2); // Like the sketch, so the frames reach the panel when they would on the Photon
+    game.begin();
+
+    FrameHash result = { 0, 2166136261u }; // FNV-1a
+    uint8_t last[LCDWIDTH * LCDPAGES];
+    memset(last, 0, sizeof(last));
+    unsigned long end = millis() + milliseconds;
+    while (millis() < end) {
+        loopGame(game, 1);
+        if (memcmp(last, oled.getDisplayedBuffer(), sizeof(last)) != 0) {
+            memcpy(last, oled.getDisplayedBuffer(), sizeof(last));
+            result.frames++;
+            for (unsigned int i = 0; i < sizeof(last); i++) {
+                result.hash ^= last[i];
+                result.hash *= 16777619u;
+            }
+        }
+    }
+    while (game.getDisplayFlusher().isBusy()) {
+        HostPlatform::advanceMillis(1); // Nothing may call back into the game once it is gone
+    }
+    HostPlatform::setButtonScript(NULL, NULL);
+    remove(flashPath);
+    Flashee::Devices::setHostFile("flappy_flash.bin");
+    return result;
+}
+
+// The games golden_frames.txt has the frames of
+static const uint32_t GOLDEN_SEEDS[] = {1, 7, 42};
+static const unsigned long GOLDEN_MILLISECONDS = 90000;
+
+// The way the library draws a rect: 4 lines, each one pixel() at a time
+static void lineRect(MicroOLED &oled, int x, int y, int width, int height, uint8_t color) {
+    oled.line(x, y, x + width, y, color, NORM);
+    oled.line(x, y + height - 1, x + width, y + height - 1, color, NORM);
+    uint8_t tempHeight = height - 2;
+    if (tempHeight < 1) {
+        return;
+    }
+    oled.line(x, y + 1, x, y + 1 + tempHeight, color, NORM);
+    oled.line(x + width - 1, y + 1, x + width - 1, y + 1 + tempHeight, color, NORM);
+}
+
+static void lineFillRect(MicroOLED &oled, int x, int y, int width, int height, uint8_t color) {
+    for (int i = x; i < x + width; i++) {
+        oled.line(i, y, i, y + height, color, NORM);
+    }
+}
+
+// The way SpriteAtlas blitted before Raster: one column at a time, a page at a time
+static void columnBlit(uint8_t *buffer, int screenWidth, int pages, const Sprite &sprite, int x, int y, bool opaque) {
+    if (y <= -sprite.height || y >= pages * 8) {
+        return;
+    }
+    uint32_t mask = opaque ? ((1u << sprite.height) - 1) : 0;
+    int page = (y < 0) ? 0 : y / 8;
+    int shift = (y < 0) ? 0 : y % 8;
+    for (int i = 0; i < sprite.width; i++) {
+        int column = x + i;
+        if (column < 0 || column >= screenWidth) {
+            continue;
+        }
+        uint32_t bits = sprite.columns[i];
+        uint32_t columnMask = mask;
+        if (y < 0) {
+            bits >>= -y;
+            columnMask >>= -y;
+        }
+        bits <<= shift;
+        columnMask <<= shift;
+        for (int p = page; p < pages && (bits | columnMask) != 0; p++) {
+            uint8_t &screenByte = buffer[p * screenWidth + column];
+            screenByte = (screenByte & ~(uint8_t)columnMask) | (uint8_t)bits;
+            bits >>= 8;
+            columnMask >>= 8;
+        }
+    }
+}
+
+// A sprite with random pixels, up to 8 tall like the atlas makes
+static Sprite randomSprite(uint8_t *columns, int maxWidth) {
+    Sprite sprite;
+    sprite.columns = columns;
+    sprite.width = (uint8_t)random(1, maxWidth + 1);
+    sprite.height = (uint8_t)random(1, 9);
+    for (int i = 0; i < sprite.width; i++) {
+        columns[i] = (uint8_t)(random(256) & (0xFF >> (8 - sprite.height)));
+    }
+    return sprite;
+}
+
+// Random rects, outlines and sprites, each drawn with Raster and with the old way, and
+// compared after every one. clearDrawn() has to leave nothing behind
+static bool checkRasterShapes(long shapes) {
+    HostPlatform::seedRandom(19);
+    MicroOLED reference(MODE_SPI, D7, D6, A2);
+    uint8_t buffer[LCDWIDTH * LCDPAGES];
+    Raster raster(buffer, LCDWIDTH, LCDHEIGHT);
+    uint8_t columns[32];
+    raster.clear();
+    memset(reference.getScreenBuffer(), 0, sizeof(buffer));
+
+    long clears = 0;
+    for (long i = 0; i < shapes; i++) {
+        int kind = random(8);
+        if (kind == 0) {
+            raster.clearDrawn();
+            clears++;
+            for (unsigned int b = 0; b < sizeof(buffer); b++) {
+                if (buffer[b] != 0) {
+                    printf("clearDrawn() left byte %u lit after shape %ld\n", b, i);
+                    return false;
+                }
+            }
+            memset(reference.getScreenBuffer(), 0, sizeof(buffer));
+            continue;
+        }
+        if (kind <= 4) {
+            // The library takes uint8_t, so the old way only has rects that start on screen
+            int x = random(0, LCDWIDTH + 8);
+            int y = random(0, LCDHEIGHT + 8);
+            int width = random(1, 48);
+            int height = random(1, 48);
+            bool white = random(4) != 0;
+            if (kind <= 2) {
+                raster.rect(x, y, width, height, white);
+                lineRect(reference, x, y, width, height, white ? WHITE : BLACK);
+            } else {
+                raster.fillRect(x, y, width, height, white);
+                lineFillRect(reference, x, y, width, height, white ? WHITE : BLACK);
+            }
+        } else {
+            Sprite sprite = randomSprite(columns, sizeof(columns));
+            int x = random(-sprite.width, LCDWIDTH + 4);
+            int y = random(-10, LCDHEIGHT + 4);
+            bool opaque = random(2) == 0;
+            raster.blit(sprite, x, y, opaque);
+            columnBlit(reference.getScreenBuffer(), LCDWIDTH, LCDPAGES, sprite, x, y, opaque);
+        }
+        if (memcmp(buffer, reference.getScreenBuffer(), sizeof(buffer)) != 0) {
+            printf("shape %ld (kind %d) came out different from the old way\n", i, kind);
+            return false;
+        }
+    }
+    printf("%ld shapes and %ld clearDrawn() calls, the same pixels as the old way\n", shapes, clears);
+    return true;
+}
+
+static int runRasterVerify(bool update) {
+    const char *goldenPath = "golden_frames.txt";
+    FILE *golden = fopen(goldenPath, update ? "w" : "r");
+    if (golden == NULL) {
+        printf("can't open %s\n", goldenPath);
+        return 1;
+    }
+    bool isOk = update || checkRasterShapes(200000);
+    for (int m = 0; m < 2; m++) {
+        MotionMode mode = (m == 0) ? PIXEL_STEPS : TIMED_PHYSICS;
+        const char *modeName = (m == 0) ? "pixel" : "physics";
+        for (unsigned int s = 0; s < sizeof(GOLDEN_SEEDS) / sizeof(GOLDEN_SEEDS[0]); s++) {
+            FrameHash frames = hashGameFrames(GOLDEN_SEEDS[s], mode, GOLDEN_MILLISECONDS);
+            if (update) {
+                fprintf(golden, "%s %lu %lu %08lx\n", modeName, (unsigned long)GOLDEN_SEEDS[s], frames.frames, (unsigned long)frames.hash);
+                continue;
+            }
+            char expectedMode[16];
+            unsigned long expectedSeed, expectedFrames, expectedHash;
+            bool same = fscanf(golden, "%15s %lu %lu %lx", expectedMode, &expectedSeed, &expectedFrames, &expectedHash) == 4
+                     && strcmp(expectedMode, modeName) == 0 && expectedSeed == GOLDEN_SEEDS[s]
+                     && expectedFrames == frames.frames && expectedHash == frames.hash;
+            printf("%s game, seed %lu: %lu frames, %s\n", modeName, (unsigned long)GOLDEN_SEEDS[s], frames.frames,
+                   same ? "the same as golden_frames.txt" : "DIFFERENT from golden_frames.txt");
+            isOk = isOk && same;
+        }
+    }
+    fclose(golden);
+    if (update) {
+        printf("wrote %s\n", goldenPath);
+    }
+    return isOk ? 0 : 1;
+}
+
+// Pixels per microsecond for each way of drawing, over the same random shapes
+static int runRasterBench(long shapes) {
+    static const int SHAPES = 1024;
+    MicroOLED oled(MODE_SPI, D7, D6, A2);
+    uint8_t buffer[LCDWIDTH * LCDPAGES];
+    Raster raster(buffer, LCDWIDTH, LCDHEIGHT);
+
+    // On screen and worked out ahead, so the timing is only the drawing
+    HostPlatform::seedRandom(19);
+    struct Shape { int x, y, width, height; Sprite sprite; };
+    std::vector<Shape> list(SHAPES);
+    std::vector<uint8_t> columns(SHAPES * 32);
+    long fillPixels = 0, outlinePixels = 0, spritePixels = 0;
+    for (int i = 0; i < SHAPES; i++) {
+        Shape &shape = list[i];
+        shape.width = random(4, 33);
+        shape.height = random(4, 33);
+        shape.x = random(0, LCDWIDTH - shape.width + 1);
+        shape.y = random(0, LCDHEIGHT - shape.height + 1);
+        shape.sprite = randomSprite(&columns[i * 32], 32);
+        shape.sprite.height = 8;
+        fillPixels += shape.width * shape.height;
+        outlinePixels += 2 * shape.width + 2 * (shape.height - 2);
+        spritePixels += shape.sprite.width * 8;
+    }
+    double perShape = (double)shapes / SHAPES; // Every shape is drawn this many times
+
+    printf("%10s %16s %16s %8s\n", "", "old px/us", "Raster px/us", "faster");
+    for (int kind = 0; kind < 3; kind++) {
+        double oldSeconds, rasterSeconds;
+        double start = secondsNow();
+        for (long i = 0; i < shapes; i++) {
+            const Shape &shape = list[i % SHAPES];
+            if (kind == 0) {
+                lineFillRect(oled, shape.x, shape.y, shape.width, shape.height, WHITE);
+            } else if (kind == 1) {
+                lineRect(oled, shape.x, shape.y, shape.width, shape.height, WHITE);
+            } else {
+                columnBlit(oled.getScreenBuffer(), LCDWIDTH, LCDPAGES, shape.sprite, shape.x, shape.y, true);
+            }
+        }
+        oldSeconds = secondsNow() - start;
+
+        start = secondsNow();
+        for (long i = 0; i < shapes; i++) {
+            const Shape &shape = list[i % SHAPES];
+            if (kind == 0) {
+                raster.fillRect(shape.x, shape.y, shape.width, shape.height);
+            } else if (kind == 1) {
+                raster.rect(shape.x, shape.y, shape.width, shape.height);
+            } else {
+                raster.blit(shape.sprite, shape.x, shape.y, true);
+            }
+        }
+        rasterSeconds = secondsNow() - start;
+
+        long pixels = (kind == 0) ? fillPixels : ((kind == 1) ? outlinePixels : spritePixels);
+        double total = pixels * perShape;
+        const char *names[] = { "fill", "outline", "sprite" };
+        printf("%10s %16.1f %16.1f %7.1fx\n", names[kind], total / (oldSeconds * 1e6), total / (rasterSeconds * 1e6), oldSeconds / rasterSeconds);
+    }
+
+    // One pillar a frame, cleared with the whole buffer and with only what it drew
+    double clearSeconds[2];
+    for (int way = 0; way < 2; way++) {
+        double start = secondsNow();
+        for (long i = 0; i < shapes; i++) {
+            const Shape &shape = list[i % SHAPES];
+            raster.rect(shape.x, 0, DefaultGameConfig::PILLAR_WIDTH, shape.y);
+            if (way == 0) {
+                raster.clear();
+            } else {
+                raster.clearDrawn();
+            }
+        }
+        clearSeconds[way] = secondsNow() - start;
+    }
+    printf("a pillar and a clear: %.1f ns with clear(), %.1f ns with clearDrawn()\n",
+           clearSeconds[0] * 1e9 / shapes, clearSeconds[1] * 1e9 / shapes);
+    return 0;
+}
+
+// ================== Scrolling course ============================
+
+// Runs a course of that many pairs of pillars for that many steps, drawn both by
+// clearing and drawing every rect and by BasicCourseRenderer, with the bird and a score
+// on top. Fails if a single step comes out different
+template <class Config>
+static bool runCourseBenchFor(const char *name, int pairs, long steps, uint32_t seed) {
+    typedef typename BasicPillarManager<Config>::PillarRing Ring;
+    const int width = Config::SCREEN_WIDTH;
+    const int height = Config::SCREEN_HEIGHT;
+
+    // As many pairs as asked for, as close together as new ones come, all on screen already
+    HostPlatform::seedRandom(seed);
+    BasicPillarManager<Config> manager;
+    manager.seedRandom(seed);
+    manager.reset();
+    typename BasicPillarManager<Config>::State state = manager.getState();
+    const int spacing = Config::PILLAR_WIDTH + Config::MIN_PILLAR_BETWEEN_PILLAR_SPACE + 1;
+    int count = std::min(std::min(pairs, Config::MAX_PILLARS), (width - 1) / spacing);
+    state.pillarCount = (uint8_t)count;
+    for (int i = 0; i < count; i++) {
+        state.pillarX[i] = (int16_t)(width - (count - i) * spacing);
+        state.pillarHeight[i] = (uint8_t)random(Config::MIN_HEIGHT_OF_PILLARS, height - Config::MIN_HEIGHT_OF_PILLARS - Config::BIRD_SPACE);
+    }
+    manager.setState(state);
+
+    // The steps are worked out ahead, so the timing is only the drawing
+    std::vector<Ring> rings(steps);
+    long pillarsSeen = 0;
+    for (long i = 0; i < steps; i++) {
+        rings[i] = manager.timeToMove();
+        pillarsSeen += rings[i].size();
+    }
+
+    static const uint8_t birdColumns[] = { 0x1C, 0x22, 0x41, 0x41, 0x41, 0x22, 0x1C }; // A circle of radius 3
+    static const uint8_t scoreColumns[] = { 0x3E, 0x51, 0x49, 0x45, 0x3E, 0x00 }; // A 0
+    const Sprite bird = { birdColumns, sizeof(birdColumns), sizeof(birdColumns) };
+    const Sprite score = { scoreColumns, sizeof(scoreColumns), 8 };
+    std::vector<int> birdY(steps);
+    for (long i = 0; i < steps; i++) {
+        int bounce = (int)(i % (2 * (height - 8)));
+        birdY[i] = (bounce < height - 8) ? bounce : 2 * (height - 8) - bounce;
+    }
+
+    std::vector<uint8_t> wholeBuffer(width * height / 8);
+    std::vector<uint8_t> scrollBuffer(width * height / 8);
+    Raster whole(&wholeBuffer[0], width, height);
+    Raster scrolled(&scrollBuffer[0], width, height);
+    BasicCourseRenderer<Config> course(scrolled);
+
+    double seconds[2];
+    for (int way = 0; way < 3; way++) {
+        // Way 2 goes over it again, comparing every step, and isn't timed
+        whole.clear();
+        course.clear();
+        double start = secondsNow();
+        for (long i = 0; i < steps; i++) {
+            if (way != 1) {
+                whole.clearDrawn();
+                for (int p = 0; p < rings[i].size(); p++) {
+                    PillarRects rects = rings[i][p].getPillarRects();
+                    whole.rect(rects.up.x, rects.up.y, rects.up.width, rects.up.height);
+                    whole.rect(rects.down.x, rects.down.y, rects.down.width, rects.down.height);
+                }
+                whole.blit(bird, Config::BIRD_X - 3, birdY[i], false);
+                whole.blit(score, 1, 1, true);
+            }
+            if (way != 0) {
+                course.draw(rings[i], (uint32_t)(i + 1));
+                course.blit(bird, Config::BIRD_X - 3, birdY[i], false);
+                course.blit(score, 1, 1, true);
+            }
+            if (way == 2 && wholeBuffer != scrollBuffer) {
+                printf("%s: step %ld came out different from drawing every rect\n", name, i);
+                return false;
+            }
+        }
+        if (way < 2) {
+            seconds[way] = secondsNow() - start;
+        }
+    }
+
+    unsigned long columns = course.getColumnsDrawn();
+    printf("%-8s %4dx%-4d %6.1f %14.1f %14.1f %8.1fx %10.1f\n", name, width, height, (double)pillarsSeen / steps,
+           seconds[0] * 1e9 / steps, seconds[1] * 1e9 / steps, seconds[0] / seconds[1],
+           (double)columns / (2 * steps)); // Way 1 and way 2 both drew with it
+    return true;
+}
+
+static int runCourseBench(long steps) {
+    printf("%-8s %9s %6s %14s %14s %9s %10s\n", "panel", "size", "pairs", "every rect ns", "scrolled ns", "faster", "columns");
+    bool isOk = runCourseBenchFor<MicroOledConfig>("micro", 3, steps, 1)
+             && runCourseBenchFor<LargePanelConfig>("large", 5, steps, 2)
+             && runCourseBenchFor<WidePanelConfig>("wide", 2, steps, 3)
+             && runCourseBenchFor<WidePanelConfig>("wide", 6, steps, 4)
+             && runCourseBenchFor<WidePanelConfig>("wide", 12, steps, 5);
+    if (isOk) {
+        printf("every step of every course the same both ways\n");
+    }
+    return isOk ? 0 : 1;
+}
+
+// ================== Pixel collision ============================
+
+static bool isLit(const uint8_t *buffer, int x, int y) {
+    return (buffer[(y / 8) * LCDWIDTH + x] >> (y % 8)) & 1;
+}
+
+static bool isOccupied(const Occupancy &occupancy, int x, int y) {
+    return (occupancy.getColumn(x)[y / 64] >> (y % 64)) & 1;
+}
+
+// The pillars filled in and drawn as the game draws them, and the occupancy has to be
+// exactly the filled ones, with every pixel of the outlines in it
+static bool checkOccupancyPixels(const Occupancy &occupancy, const PillarManager::PillarRing &pillars,
+                                 uint8_t *filled, uint8_t *outlines, long step) {
+    Raster filledRaster(filled, LCDWIDTH, LCDHEIGHT);
+    Raster outlineRaster(outlines, LCDWIDTH, LCDHEIGHT);
+    filledRaster.clear();
+    outlineRaster.clear();
+    for (int i = 0; i < pillars.size(); i++) {
+        PillarRects rects = pillars[i].getPillarRects();
+        filledRaster.fillRect(rects.up.x, rects.up.y, rects.up.width, rects.up.height);
+        filledRaster.fillRect(rects.down.x, rects.down.y, rects.down.width, rects.down.height);
+        outlineRaster.rect(rects.up.x, rects.up.y, rects.up.width, rects.up.height);
+        outlineRaster.rect(rects.down.x, rects.down.y, rects.down.width, rects.down.height);
+    }
+    for (int x = 0; x < LCDWIDTH; x++) {
+        for (int y = 0; y < LCDHEIGHT; y++) {
+            bool occupied = isOccupied(occupancy, x, y);
+            if (occupied != isLit(filled, x, y) || (isLit(outlines, x, y) && !occupied)) {
+                printf("step %ld: pixel %d, %d is %s in the occupancy and %s on the screen\n", step, x, y,
+                       occupied ? "set" : "not set", isLit(filled, x, y) ? "lit" : "not lit");
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// The bird drawn at x and y, filled in column by column, on top of the filled pillars
+static bool birdPixelsHit(const Sprite &bird, const uint8_t *filled, int x, int y) {
+    uint8_t drawn[LCDWIDTH * LCDPAGES];
+    Raster raster(drawn, LCDWIDTH, LCDHEIGHT);
+    raster.clear();
+    raster.blit(bird, x, y, false);
+    for (int column = 0; column < LCDWIDTH; column++) {
+        int top = -1;
+        int bottom = -1;
+        for (int row = 0; row < LCDHEIGHT; row++) {
+            if (isLit(drawn, column, row)) {
+                top = (top < 0) ? row : top;
+                bottom = row;
+            }
+        }
+        for (int row = top; row >= 0 && row <= bottom; row++) {
+            if (isLit(filled, column, row)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Steps the pillars with the occupancy kept, going back to an older state and starting
+// over now and then, and checks it against the screen after every step. Then every bird
+// from the top of the screen to the bottom against the pillars drawn pixel by pixel
+static int runCollisionVerify(long steps, uint32_t seed) {
+    static const int REPEATS = 16; // Checks are timed this many at a time, for the clock to not matter
+    MicroOLED oled(MODE_SPI, D7, D6, A2);
+    oled.begin();
+    SpriteAtlas atlas(oled);
+    atlas.build(FLAPPY_SIZE);
+    Sprite birdSprite = atlas.getBird();
+    CollisionMask shape = CollisionMask::filled(birdSprite);
+
+    HostPlatform::seedRandom(seed);
+    PillarManager manager;
+    manager.seedRandom(seed);
+    manager.reset();
+    Occupancy occupancy;
+    manager.trackOccupancy(&occupancy);
+    PillarManager::State saved = manager.getState();
+    Bird bird;
+
+    uint8_t filled[LCDWIDTH * LCDPAGES];
+    uint8_t outlines[LCDWIDTH * LCDPAGES];
+    long checks = 0;
+    long hitboxOnly = 0; // The hitbox crashed and the pixels didn't
+    long pixelsOnly = 0;
+    const char *ways[] = { "per pillar", "broadphase", "occupancy" };
+    double seconds[3] = { 0, 0, 0 };
+    long crashes[3] = { 0, 0, 0 }; // Of the timed checks
+    Hitbox boxes[LCDHEIGHT];
+    for (int position = 0; position < LCDHEIGHT; position++) {
+        boxes[position] = Collision::birdHitbox(LCDWIDTH / 2, position, FLAPPY_SIZE, DefaultGameConfig::HITBOX_INSET);
+    }
+    for (long step = 0; step < steps; step++) {
+        if (step % 5000 == 4999) {
+            manager.setState(saved); // Back to where it was 2000 steps ago
+        } else if (step % 7919 == 7918) {
+            manager.reset();
+        }
+        if (step % 5000 == 2999) {
+            saved = manager.getState();
+        }
+        const PillarManager::PillarRing &pillars = manager.timeToMove();
+        if (!checkOccupancyPixels(occupancy, pillars, filled, outlines, step)) {
+            return 1;
+        }
+
+        // The mask anywhere, even partly off the screen
+        int x = random(-shape.width, LCDWIDTH + 1);
+        int y = random(-shape.height, LCDHEIGHT + 1);
+        if (occupancy.hits(shape, x, y) != birdPixelsHit(birdSprite, filled, x, y)) {
+            printf("step %ld: the mask at %d, %d came out different from the pixels\n", step, x, y);
+            return 1;
+        }
+        // The same with only the mask's columns worked out, like the autopilot does
+        uint64_t columns[CollisionMask::MAX_WIDTH][Occupancy::WORDS + 1];
+        for (int i = 0; i < shape.width; i++) {
+            if (x + i >= 0 && x + i < LCDWIDTH) {
+                Occupancy::column(pillars, x + i, columns[i]);
+            }
+        }
+        if (Occupancy::hitsColumns(columns[0], shape, x, y) != occupancy.hits(shape, x, y)) {
+            printf("step %ld: the mask at %d, %d came out different on its own columns\n", step, x, y);
+            return 1;
+        }
+
+        // And the bird where it flies, at every height
+        Bird::State state = bird.getState();
+        for (int position = 0; position < LCDHEIGHT; position++) {
+            state.position = (int16_t)position;
+            bird.setState(state);
+            bool crashed = bird.birdCrashed(occupancy, shape);
+            bool expected = birdPixelsHit(birdSprite, filled, LCDWIDTH / 2 - FLAPPY_SIZE, position - FLAPPY_SIZE)
+                         || position >= LCDHEIGHT - FLAPPY_SIZE || position <= FLAPPY_SIZE;
+            if (crashed != expected) {
+                printf("step %ld: the bird at %d %s, and its pixels say it %s\n", step, position,
+                       crashed ? "crashed" : "didn't crash", expected ? "did" : "didn't");
+                return 1;
+            }
+            bool boxCrashed = bird.birdCrashed(pillars);
+            hitboxOnly += boxCrashed && !crashed;
+            pixelsOnly += crashed && !boxCrashed;
+            checks++;
+        }
+
+        // The pillar part of each check timed on the same birds: the boxes and the mask
+        // are worked out ahead, so it is only the checks
+        double start = secondsNow();
+        for (int r = 0; r < REPEATS; r++) {
+            for (int position = 0; position < LCDHEIGHT; position++) {
+                crashes[0] += linearHitsAnyPillar(pillars, boxes[position]);
+            }
+        }
+        double linearEnd = secondsNow();
+        for (int r = 0; r < REPEATS; r++) {
+            for (int position = 0; position < LCDHEIGHT; position++) {
+                crashes[1] += Collision::hitsAnyPillar(pillars, boxes[position]);
+            }
+        }
+        double broadphaseEnd = secondsNow();
+        for (int r = 0; r < REPEATS; r++) {
+            for (int position = 0; position < LCDHEIGHT; position++) {
+                crashes[2] += occupancy.hits(shape, LCDWIDTH / 2 - FLAPPY_SIZE, position - FLAPPY_SIZE);
+            }
+        }
+        seconds[0] += linearEnd - start;
+        seconds[1] += broadphaseEnd - linearEnd;
+        seconds[2] += secondsNow() - broadphaseEnd;
+    }
+    long timed = checks * REPEATS;
+    printf("%ld steps: the occupancy was the pillars on the screen every time\n", steps);
+    printf("%ld birds: the pixel collision crashed exactly when the bird's pixels touched a pillar\n", checks);
+    printf("hitbox crashed and pixels didn't: %ld (%.1f%%), pixels crashed and hitbox didn't: %ld (%.1f%%)\n",
+           hitboxOnly, 100.0 * hitboxOnly / checks, pixelsOnly, 100.0 * pixelsOnly / checks);
+    printf("%-12s %10s %10s\n", "pillars", "ns", "hits");
+    for (int way = 0; way < 3; way++) {
+        printf("%-12s %10.2f %10ld\n", ways[way], seconds[way] * 1e9 / timed, crashes[way]);
+    }
+
+    // What keeping the occupancy costs the pillars, on the same course
+    for (int tracking = 0; tracking < 2; tracking++) {
+        PillarManager timedManager;
+        timedManager.seedRandom(seed);
+        timedManager.reset();
+        Occupancy timedOccupancy;
+        timedManager.trackOccupancy((tracking == 1) ? &timedOccupancy : NULL);
+        long pillarsSeen = 0;
+        double start = secondsNow();
+        for (long step = 0; step < steps; step++) {
+            pillarsSeen += timedManager.timeToMove().size();
+        }
+        printf("%-12s %10.2f ns per pillar step (%.1f pillars)\n", tracking ? "tracked" : "untracked",
+               (secondsNow() - start) * 1e9 / steps, (double)pillarsSeen / steps);
+    }
+    return 0;
+}
+
+// ================== Display ============================
+
+// One game with the frames going out by DMA, checked every ms
+static bool runDisplayBenchFor(MotionMode mode, double megahertz, unsigned long milliseconds, uint32_t seed) {
+    const char *flashPath = "flappy_display_flash.bin";
+    remove(flashPath);
+    Flashee::Devices::setHostFile(flashPath);
+    HostPlatform::setMillis(0);
+    HostPlatform::seedRandom(seed);
+    HostPlatform::setSpiSpeed((unsigned long)(megahertz * 1000000));
+    unsigned long long busyBefore = HostPlatform::getSpiBusyNanos();
+
+    MicroOLED oled(MODE_SPI, D7, D6, A2);
+    FlappyGame game(oled, D0, mode);
+    HostPlatform::setButtonScript(botPress, &game);
+    game.useDisplayDma(D6, A2);
+    game.begin();
+    DisplayFlusher &screen = game.getDisplayFlusher();
+
+    // Whenever the bus is free, the panel has to show the last frame that was flushed.
+    // Every frame is drawn and flushed in the same pass of loop(), so that is the buffer
+    unsigned long checks = 0;
+    unsigned long wrong = 0;
+    unsigned long end = millis() + milliseconds;
+    while (millis() < end) {
+        loopGame(game, 1);
+        if (!screen.isBusy()) {
+            checks++;
+            if (memcmp(oled.getDisplayedBuffer(), oled.getScreenBuffer(), LCDWIDTH * LCDPAGES) != 0) {
+                wrong++;
+            }
+        }
+    }
+    while (screen.isBusy()) {
+        HostPlatform::advanceMillis(1);
+    }
+    if (memcmp(oled.getDisplayedBuffer(), oled.getScreenBuffer(), LCDWIDTH * LCDPAGES) != 0) {
+        wrong++;
+    }
+
+    unsigned long frames = screen.getFramesSent();
+    double busyMs = (double)(HostPlatform::getSpiBusyNanos() - busyBefore) / 1e6;
+    printf("%-8s %6.2f %8lu %8lu %8.1f %10.1f %10lu %12.1f %8lu\n", (mode == PIXEL_STEPS) ? "pixel" : "physics",
+           megahertz, frames, screen.getFramesMerged(), 100.0 * busyMs / millis(),
+           frames ? (double)screen.getLatencyMicros() / frames : 0.0, screen.getMaxLatencyMicros(), busyMs, wrong);
+
+    HostPlatform::setButtonScript(NULL, NULL);
+    HostPlatform::setSpiSpeed(8000000);
+    remove(flashPath);
+    Flashee::Devices::setHostFile("flappy_flash.bin");
+    if (wrong > 0) {
+        printf("the panel was not the last frame %lu times out of %lu\n", wrong, checks + 1);
+    }
+    return wrong == 0;
+}
+
+static int runDisplayBench(unsigned long milliseconds, double megahertz) {
+    static const double SPEEDS[] = {8, 2, 0.5};
+    printf("%-8s %6s %8s %8s %8s %10s %10s %12s %8s\n", "mode", "MHz", "frames", "merged", "busy %",
+           "mean us", "max us", "bus ms", "wrong");
+    bool isOk = true;
+    for (int m = 0; m < 2; m++) {
+        MotionMode mode = (m == 0) ? PIXEL_STEPS : TIMED_PHYSICS;
+        for (unsigned int i = 0; i < sizeof(SPEEDS) / sizeof(SPEEDS[0]); i++) {
+            if (megahertz > 0 && i > 0) {
+                break;
+            }
+            isOk = runDisplayBenchFor(mode, (megahertz > 0) ? megahertz : SPEEDS[i], milliseconds, 1) && isOk;
+        }
+    }
+    if (isOk) {
+        printf("the panel showed the last frame every time the bus was free\n");
+    }
+    return isOk ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 2 && strcmp(argv[1], "headless") == 0) {
+        long ticks = (argc > 2) ? atol(argv[2]) : 10000000;
+        uint32_t seed = (argc > 3) ? strtoul(argv[3], NULL, 10) : 1;
+        if (argc > 4 && strcmp(argv[4], "large") == 0) {
+            return runHeadless<LargePanelConfig>(ticks, seed);
+        }
+        return runHeadless<DefaultGameConfig>(ticks, seed);
+    }
+    if (argc >= 2 && strcmp(argv[1], "game") == 0) {
+        unsigned long milliseconds = (argc > 2) ? strtoul(argv[2], NULL, 10) : 60000;
+        uint32_t seed = (argc > 3) ? strtoul(argv[3], NULL, 10) : 1;
+        unsigned long periodMs = (argc > 4) ? strtoul(argv[4], NULL, 10) : 400;
+        unsigned long holdMs = (argc > 5) ? strtoul(argv[5], NULL, 10) : 120;
+        MotionMode mode = (argc > 6 && strcmp(argv[6], "physics") == 0) ? TIMED_PHYSICS : PIXEL_STEPS;
+        return runGame(milliseconds, seed, periodMs, holdMs, mode);
+    }
+    if (argc >= 2 && strcmp(argv[1], "physics") == 0) {
+        unsigned long milliseconds = (argc > 2) ? strtoul(argv[2], NULL, 10) : 3600000;
+        unsigned long frameMs = (argc > 3) ? strtoul(argv[3], NULL, 10) : 20;
+        uint32_t seed = (argc > 4) ? strtoul(argv[4], NULL, 10) : 1;
+        return runPhysics(milliseconds, frameMs, seed);
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "batch") == 0) {
+        int games = (argc > 2) ? atoi(argv[2]) : 4096;
+        long ticks = (argc > 3) ? atol(argv[3]) : 10000;
+        uint32_t seed = (argc > 4) ? strtoul(argv[4], NULL, 10) : 1;
+        return runBatch(games, ticks, seed);
+    }
+    if (argc >= 2 && strcmp(argv[1], "batch-verify") == 0) {
+        int games = (argc > 2) ? atoi(argv[2]) : 256;
+        long ticks = (argc > 3) ? atol(argv[3]) : 100000;
+        uint32_t seed = (argc > 4) ? strtoul(argv[4], NULL, 10) : 1;
+        return runBatchVerify(games, ticks, seed);
+    }
+    if (argc >= 2 && strcmp(argv[1], "alloc-verify") == 0) {
+        long ticks = (argc > 2) ? atol(argv[2]) : 10000;
+        uint32_t seed = (argc > 3) ? strtoul(argv[3], NULL, 10) : 1;
+        return runAllocVerify(ticks, seed);
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "record") == 0) {
+        unsigned long milliseconds = (argc > 2) ? strtoul(argv[2], NULL, 10) : 60000;
+        uint32_t seed = (argc > 3) ? strtoul(argv[3], NULL, 10) : 1;
+        unsigned long periodMs = (argc > 4) ? strtoul(argv[4], NULL, 10) : 400;
+        unsigned long holdMs = (argc > 5) ? strtoul(argv[5], NULL, 10) : 120;
+        MotionMode mode = (argc > 6 && strcmp(argv[6], "physics") == 0) ? TIMED_PHYSICS : PIXEL_STEPS;
+        return runRecord(milliseconds, seed, periodMs, holdMs, mode, "flappy_replay.bin");
+    }
+    if (argc >= 2 && strcmp(argv[1], "replay") == 0) {
+        const char *path = (argc > 2) ? argv[2] : "flappy_replay.bin";
+        int times = (argc > 3) ? atoi(argv[3]) : 100;
+        return runReplay(path, times);
+    }
+    if (argc >= 2 && strcmp(argv[1], "profile") == 0) {
+        unsigned long milliseconds = (argc > 2) ? strtoul(argv[2], NULL, 10) : 60000;
+        uint32_t seed = (argc > 3) ? strtoul(argv[3], NULL, 10) : 1;
+        MotionMode mode = (argc > 4 && strcmp(argv[4], "physics") == 0) ? TIMED_PHYSICS : PIXEL_STEPS;
+        bool isAutopilot = argc > 4 && strcmp(argv[4], "autopilot") == 0;
+        return runProfile(milliseconds, seed, mode, isAutopilot);
+    }
+    if (argc >= 2 && strcmp(argv[1], "collision-bench") == 0) {
+        long checks = (argc > 2) ? atol(argv[2]) : 10000000;
+        return runCollisionBench(checks);
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "store-bench") == 0) {
+        int games = (argc > 2) ? atoi(argv[2]) : 20000;
+        int players = (argc > 3) ? atoi(argv[3]) : 8;
+        return runStoreBench(games, players);
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "input-bench") == 0) {
+        int presses = (argc > 2) ? atoi(argv[2]) : 2000;
+        uint32_t seed = (argc > 3) ? strtoul(argv[3], NULL, 10) : 1;
+        return runInputBench(presses, seed);
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "autopilot") == 0) {
+        unsigned long milliseconds = (argc > 2) ? strtoul(argv[2], NULL, 10) : 600000;
+        uint32_t seed = (argc > 3) ? strtoul(argv[3], NULL, 10) : 1;
+        return runAutopilot(milliseconds, seed);
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "delay-bench") == 0) {
+        long steps = (argc > 2) ? atol(argv[2]) : 10000000;
+        return runDelayBench(steps);
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "raster-verify") == 0) {
+        bool update = argc > 2 && strcmp(argv[2], "update") == 0;
+        return runRasterVerify(update);
+    }
+    if (argc >= 2 && strcmp(argv[1], "course-bench") == 0) {
+        long steps = (argc > 2) ? atol(argv[2]) : 20000;
+        return runCourseBench(steps);
+    }
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0) {
+        const char *outPath = (argc > 2) ? argv[2] : "bench_results.json";
+        double thresholdPercent = (argc > 3) ? atof(argv[3]) : 25;
+        return runBenchSuite(outPath, true, thresholdPercent, (argc > 4) ? argc - 4 : 0, argv + 4);
+    }
+    if (argc >= 2 && strcmp(argv[1], "bench-counts") == 0) {
+        const char *outPath = (argc > 2) ? argv[2] : "bench_counts.json";
+        return runBenchSuite(outPath, false, 25, 0, NULL);
+    }
+    if (argc >= 3 && strcmp(argv[1], "sweep") == 0) {
+        bool isGrid = strcmp(argv[2], "grid") == 0;
+        int first = isGrid ? 5 : 6; // Where the ranges start
+        long gamesPerPoint = (argc > 3) ? atol(argv[3]) : 2000;
+        int threads = (argc > 4) ? atoi(argv[4]) : 0;
+        int tunings = (!isGrid && argc > 5) ? atoi(argv[5]) : 32;
+        if (gamesPerPoint < 1 || tunings < 1) {
+            fprintf(stderr, "sweep: there has to be at least one game and one tuning\n");
+            return 1;
+        }
+        return runSweep(argv[2], gamesPerPoint, threads, tunings, (argc > first) ? argc - first : 0, argv + first);
+    }
+    if (argc >= 2 && strcmp(argv[1], "sweep-scaling") == 0) {
+        long gamesPerPoint = (argc > 2) ? atol(argv[2]) : 1000;
+        int maxThreads = (argc > 3) ? atoi(argv[3]) : 0;
+        if (gamesPerPoint < 1) {
+            fprintf(stderr, "sweep-scaling: there has to be at least one game\n");
+            return 1;
+        }
+        return runSweepScaling(gamesPerPoint, maxThreads);
+    }
+    if (argc >= 2 && strcmp(argv[1], "sweep-verify") == 0) {
+        long games = (argc > 2) ? atol(argv[2]) : 2000;
+        uint32_t seed = (argc > 3) ? (uint32_t)strtoul(argv[3], NULL, 10) : 1;
+        return runSweepVerify(games, seed);
+    }
+    if (argc >= 2 && strcmp(argv[1], "collision-verify") == 0) {
+        long steps = (argc > 2) ? atol(argv[2]) : 100000;
+        uint32_t seed = (argc > 3) ? (uint32_t)strtoul(argv[3], NULL, 10) : 1;
+        return runCollisionVerify(steps, seed);
+    }
+    if (argc >= 2 && strcmp(argv[1], "display-bench") == 0) {
+        unsigned long milliseconds = (argc > 2) ? strtoul(argv[2], NULL, 10) : 60000;
+        double megahertz = (argc > 3) ? atof(argv[3]) : 0;
+        return runDisplayBench(milliseconds, megahertz);
+    }
+    if (argc >= 2 && strcmp(argv[1], "raster-bench") == 0) {
+        long shapes = (argc > 2) ? atol(argv[2]) : 2000000;
+        return runRasterBench(shapes);
+    }
+
+    fprintf(stderr, "usage: %s headless [ticks] [seed] [large]\n", argv[0]);
+    fprintf(stderr, "       %s game [milliseconds] [seed] [periodMs] [holdMs] [physics]\n", argv[0]);
+    fprintf(stderr, "       %s physics [milliseconds] [frameMs] [seed]\n", argv[0]);
+    fprintf(stderr, "       %s batch [games] [ticks] [seed]\n", argv[0]);
+    fprintf(stderr, "       %s batch-verify [games] [ticks] [seed]\n", argv[0]);
+    fprintf(stderr, "       %s alloc-verify [ticks] [seed]\n", argv[0]);
+    fprintf(stderr, "       %s record [milliseconds] [seed] [periodMs] [holdMs] [physics]\n", argv[0]);
+    fprintf(stderr, "       %s replay [file] [times]\n", argv[0]);
+    fprintf(stderr, "       %s profile [milliseconds] [seed] [physics]\n", argv[0]);
+    fprintf(stderr, "       %s collision-bench [checks]\n", argv[0]);
+    fprintf(stderr, "       %s delay-bench [steps]\n", argv[0]);
+    fprintf(stderr, "       %s store-bench [games] [players]\n", argv[0]);
+    fprintf(stderr, "       %s input-bench [presses] [seed]\n", argv[0]);
+    fprintf(stderr, "       %s autopilot [milliseconds] [seed]\n", argv[0]);
+    fprintf(stderr, "       %s raster-verify [update]\n", argv[0]);
+    fprintf(stderr, "       %s raster-bench [shapes]\n", argv[0]);
+    fprintf(stderr, "       %s course-bench [steps]\n", argv[0]);
+    fprintf(stderr, "       %s display-bench [milliseconds] [MHz]\n", argv[0]);
+    fprintf(stderr, "       %s bench [out.json] [thresholdPercent] [baseline.json ...]\n", argv[0]);
+    fprintf(stderr, "       %s bench-counts [out.json]\n", argv[0]);
+    fprintf(stderr, "       %s sweep grid [gamesPerPoint] [threads] [NAME=low:high:count ...]\n", argv[0]);
+    fprintf(stderr, "       %s sweep random [gamesPerPoint] [threads] [tunings] [NAME=low:high ...]\n", argv[0]);
+    fprintf(stderr, "       %s sweep-scaling [gamesPerPoint] [maxThreads]\n", argv[0]);
+    fprintf(stderr, "       %s sweep-verify [games] [seed]\n", argv[0]);
+    fprintf(stderr, "       %s collision-verify [steps] [seed]\n", argv[0]);
+    return 1;
+}
@@ -9,28 +9,60 @@ Original Completion Date: July 13
 #ifndef PILLAR_H
 #define PILLAR_H
 
-class Pillar {
+#include "RingBuffer.h"
+#include "GameConfig.h" // The screen size, the pillar width and the gap all come from here
+
+// A rect on screen: x, y, width, and height, the same order oled.rect takes them
+struct PillarRect {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+// The top and the bottom pillar of a pair. This is a plain value, so returning it
+// copies eight ints on the stack and never touches the heap
+struct PillarRects {
+    PillarRect up;
+    PillarRect down;
+};
+
+template <class Config>
+class BasicPillar {
 
     public:
 
-        Pillar(int screenWidth, int screenHeight, int upPillarHeight);
-        int** returnPillarInformation(); // This function returns a two dimensional array. They are information of the top and bottom pillar, and each of these pillars consist of four items, or a rect: x, y, width, and height
+        // All the pillars on screen, from left to right
+        typedef RingBuffer<BasicPillar, Config::MAX_PILLARS> Ring;
+
+        BasicPillar(); // An empty slot in the ring buffer. It gets overwritten before it is used
+        explicit BasicPillar(int upPillarHeight); // A new pair, just off the right edge of the screen
+        // A pair that is already somewhere on the screen, for restoring a game. The gap is the
+        // tuning's birdSpace (see GameConfig.h)
+        BasicPillar(int upPillarHeight, int x, int gap = Config::BIRD_SPACE);
+        PillarRects getPillarRects() const; // Returns the rects of the top and bottom pillar by value
+
+        // These are defined right here so the collision checks, which call them a lot, don't have to make a function call for each
+        int getX() const { return _x; } // The left edge of the pair
+        int getXEnd() const { return _x + Config::PILLAR_WIDTH; } // The right edge of the pair, x + width
+        int getGapTop() const { return _upPillarHeight; } // The first row under the top pillar
+        int getGapBottom() const { return _gapBottom; } // The first row of the bottom pillar
+
         void changePillars(int change); // Shift the x to the left by the "change" parameter
         bool isGone(); // Returns if the pillar is off the screen or not
 
-        static const int BIRD_SPACE  = 25; // The space needed between pillars
-
     private:
 
-        const int _PILLAR_WIDTH  = 10; // Constant pillar width
-
-        int _screenHeight;
-        int _screenWidth;
+        // Everything else about a pillar (the width, where the bottom one ends) is the same
+        // for every pillar, so it comes from the config instead of being stored. The gap is
+        // stored, because a sweep tries other ones on the same classes
+        unsigned int _x; // The left edge of both pillars
         int _upPillarHeight;
-        int _downPillarHeight;
-        unsigned int _upPillarPosition[2];
-        unsigned int _downPillarPosition[2];
+        int _gapBottom; // The gap's worth under _upPillarHeight
 };
 
+// The 64x48 ones the game uses
+typedef BasicPillar<DefaultGameConfig> Pillar;
+typedef Pillar::Ring PillarRing;
 
 #endif